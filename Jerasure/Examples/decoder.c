@@ -56,6 +56,10 @@ reads in the k+m files or marks the file as erased. It then
 recreates the original file and creates a new file with the
 suffix "decoded" with the decoded contents of the file.
 
+With an optional threads > 0 after the inputfile, the k+m files 
+are mmap'd and blocks are read, decoded by that many threads, and 
+written in a pipeline, as in encoder.c.
+
 This program does not error check command line arguments because 
 it is assumed that encoder.c has been called previously with the
 same arguments, and encoder.c does error check.
@@ -66,12 +70,16 @@ same arguments, and encoder.c does error check.
 #include <string.h>
 #include <sys/time.h>
 #include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
 #include <signal.h>
 #include "jerasure.h"
 #include "reed_sol.h"
 #include "galois.h"
 #include "cauchy.h"
 #include "liberation.h"
+#include "pipeline.h"
 
 #define N 10
 
@@ -86,6 +94,26 @@ int readins, n;
 /* Function prototype */
 void ctrl_bs_handler(int dummy);
 
+/* State shared by the stages of the pipelined (mmap) decoder.
+   Each slot has its own pointers and buffers for the erased devices. */
+typedef struct {
+	enum Coding_Technique tech;
+	int k, m, w, packetsize;
+	int *matrix;
+	jerasure_schedule_store *store;
+	int *erasures;
+	char **maps;			// k+m mmap'd files, NULL if erased
+	int origsize, blocksize;
+	int fd;					// decoded file
+	char ***data;
+	char ***coding;
+	int failed;
+} Decode_Pipeline;
+
+void decode_read(void *arg, int n, int slot);
+void decode_code(void *arg, int n, int slot);
+void decode_write(void *arg, int n, int slot);
+
 int main (int argc, char **argv) {
 	FILE *fp;				// File pointer
 
@@ -96,6 +124,7 @@ int main (int argc, char **argv) {
 	int *erased;
 	int *matrix;
 	int *bitmatrix;
+	jerasure_schedule_store *store;
 	
 	/* Parameters */
 	int k, m, w, packetsize, buffersize;
@@ -122,26 +151,39 @@ int main (int argc, char **argv) {
 	double tsec;
 	double totalsec;
 
+	/* Pipelined mode */
+	int threads;
+	int fd;
+	Decode_Pipeline dp;
+	Pipeline_Times pt;
+
 	
 	signal(SIGQUIT, ctrl_bs_handler);
 
 	matrix = NULL;
 	bitmatrix = NULL;
+	store = NULL;
 	totalsec = 0.0;
 	
 	/* Start timing */
 	gettimeofday(&t1, &tz);
 
 	/* Error checking parameters */
-	if (argc != 2) {
-		fprintf(stderr, "usage: inputfile\n");
+	if (argc != 2 && argc != 3) {
+		fprintf(stderr, "usage: inputfile [threads]\n");
+		fprintf(stderr, "\nWith threads > 0, the files are mmap'd and read, decoded and written in a pipeline\nwith that many decoding threads.\n");
+		exit(0);
+	}
+	threads = 0;
+	if (argc == 3 && (sscanf(argv[2], "%d", &threads) == 0 || threads < 0)) {
+		fprintf(stderr, "Invalid value for threads\n");
 		exit(0);
 	}
 	curdir = (char *)malloc(sizeof(char)*100);
 	getcwd(curdir, 100);
 	
 	/* Begin recreation of file names */
-	cs1 = (char*)malloc(sizeof(char)*strlen(argv[1]));
+	cs1 = (char*)malloc(sizeof(char)*(strlen(argv[1])+1));
 	cs2 = strrchr(argv[1], '/');
 	if (cs2 != NULL) {
 		cs2++;
@@ -157,7 +199,7 @@ int main (int argc, char **argv) {
 	} else {
            extension = strdup("");
         }	
-	fname = (char *)malloc(sizeof(char*)*(100+strlen(argv[1])+10));
+	fname = (char *)malloc(sizeof(char)*(strlen(curdir)+strlen(argv[1])+40));
 
 	/* Read in parameters from metadata file */
 	sprintf(fname, "%s/Coding/%s_meta.txt", curdir, cs1);
@@ -237,6 +279,10 @@ int main (int argc, char **argv) {
 			fprintf(stderr,  "unsupported coding technique used\n");
 			break;
 	}
+	/* Schedules persist across runs if JERASURE_SCHEDULE_DIR is set */
+	if (bitmatrix != NULL) {
+		store = jerasure_open_schedule_store(k, m, w, bitmatrix, 1, NULL);
+	}
 	gettimeofday(&t4, &tz);
 	tsec = 0.0;
 	tsec += t4.tv_usec;
@@ -246,10 +292,97 @@ int main (int argc, char **argv) {
 	tsec -= t3.tv_sec;
 	totalsec += tsec;
 	
+	/* Pipelined mode: mmap the surviving files, and read, decode and
+	   write blocks in parallel.  The output is the same as below. */
+	if (threads > 0) {
+		dp.tech = tech;
+		dp.k = k;
+		dp.m = m;
+		dp.w = w;
+		dp.packetsize = packetsize;
+		dp.matrix = matrix;
+		dp.store = store;
+		dp.erasures = erasures;
+		dp.origsize = origsize;
+		dp.failed = 0;
+		dp.maps = (char **)malloc(sizeof(char *)*(k+m));
+		numerased = 0;
+		for (i = 0; i < k+m; i++) {
+			if (i < k) {
+				sprintf(fname, "%s/Coding/%s_k%0*d%s", curdir, cs1, md, i+1, extension);
+			} else {
+				sprintf(fname, "%s/Coding/%s_m%0*d%s", curdir, cs1, md, i+1-k, extension);
+			}
+			dp.maps[i] = NULL;
+			fd = open(fname, O_RDONLY);
+			if (fd < 0) {
+				erased[i] = 1;
+				erasures[numerased] = i;
+				numerased++;
+				continue;
+			}
+			fstat(fd, &status);
+			if (buffersize == origsize) blocksize = status.st_size;
+			if (status.st_size > 0) {
+				/* Private and writable, so that a decoder writing to a
+				   surviving device could never change the file */
+				dp.maps[i] = (char *)mmap(NULL, status.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+				if (dp.maps[i] == MAP_FAILED) { perror("mmap"); exit(1); }
+				madvise(dp.maps[i], status.st_size, MADV_SEQUENTIAL);
+			}
+			close(fd);
+		}
+		erasures[numerased] = -1;
+		dp.blocksize = blocksize;
+
+		sprintf(fname, "%s/Coding/%s_decoded%s", curdir, cs1, extension);
+		dp.fd = open(fname, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+		if (dp.fd < 0 || ftruncate(dp.fd, origsize) < 0) {
+			perror(fname);
+			exit(1);
+		}
+
+		dp.data = (char ***)malloc(sizeof(char **)*(threads+2));
+		dp.coding = (char ***)malloc(sizeof(char **)*(threads+2));
+		for (n = 0; n < threads+2; n++) {
+			dp.data[n] = (char **)malloc(sizeof(char *)*k);
+			dp.coding[n] = (char **)malloc(sizeof(char *)*m);
+			for (i = 0; i < numerased; i++) {
+				if (erasures[i] < k) {
+					if (posix_memalign((void **)&dp.data[n][erasures[i]], 64, blocksize) != 0) { perror("malloc"); exit(1); }
+				} else {
+					if (posix_memalign((void **)&dp.coding[n][erasures[i]-k], 64, blocksize) != 0) { perror("malloc"); exit(1); }
+				}
+			}
+		}
+
+		pipeline_run(readins, threads+2, threads, &dp, decode_read, decode_code, decode_write, &pt);
+		totalsec += pt.code/threads;
+
+		if (dp.failed) {
+			fprintf(stderr, "Unsuccessful!\n");
+			exit(0);
+		}
+		for (n = 0; n < threads+2; n++) {
+			for (i = 0; i < numerased; i++) {
+				free((erasures[i] < k) ? dp.data[n][erasures[i]] : dp.coding[n][erasures[i]-k]);
+			}
+			free(dp.data[n]);
+			free(dp.coding[n]);
+		}
+		free(dp.data);
+		free(dp.coding);
+		for (i = 0; i < k+m; i++) {
+			if (dp.maps[i] != NULL) munmap(dp.maps[i], (long)blocksize*readins);
+		}
+		free(dp.maps);
+		close(dp.fd);
+	}
+
 	/* Begin decoding process */
 	total = 0;
 	n = 1;	
-	while (n <= readins) {
+	while (threads == 0 && n <= readins) {
 		numerased = 0;
 		/* Open files, check for erasures, read in data/coding */	
 		for (i = 1; i <= k; i++) {
@@ -318,7 +451,7 @@ int main (int argc, char **argv) {
 			i = jerasure_matrix_decode(k, m, w, matrix, 1, erasures, data, coding, blocksize);
 		}
 		else if (tech == Cauchy_Orig || tech == Cauchy_Good || tech == Liberation || tech == Blaum_Roth || tech == Liber8tion) {
-			i = jerasure_schedule_decode_lazy(k, m, w, bitmatrix, erasures, data, coding, blocksize, packetsize, 1);
+			i = jerasure_schedule_decode_stored(store, erasures, data, coding, blocksize, packetsize);
 		}
 		else {
 			fprintf(stderr, "Not a valid coding technique.\n");
@@ -377,6 +510,7 @@ int main (int argc, char **argv) {
 	free(coding);
 	free(erasures);
 	free(erased);
+	if (store != NULL) jerasure_close_schedule_store(store);
 	
 	/* Stop timing and print time */
 	gettimeofday(&t2, &tz);
@@ -387,9 +521,69 @@ int main (int argc, char **argv) {
 	tsec += t2.tv_sec;
 	tsec -= t1.tv_sec;
 	printf("Decoding (MB/sec): %0.10f\n", (origsize/1024/1024)/totalsec);
-	printf("De_Total (MB/sec): %0.10f\n\n", (origsize/1024/1024)/tsec);
+	if (threads > 0) {
+		printf("De_Total (MB/sec): %0.10f\n", (origsize/1024/1024)/tsec);
+		printf("Reading  (MB/sec): %0.10f\n", (origsize/1024/1024)/pt.read);
+		printf("Writing  (MB/sec): %0.10f\n\n", (origsize/1024/1024)/pt.write);
+	}
+	else {
+		printf("De_Total (MB/sec): %0.10f\n\n", (origsize/1024/1024)/tsec);
+	}
 }	
 
+/* Pipeline stages.  Blocks are numbered from 0 here. */
+
+void decode_read(void *arg, int n, int slot)
+{
+	Decode_Pipeline *dp = (Decode_Pipeline *)arg;
+	long off;
+	int i;
+
+	off = (long)n*dp->blocksize;
+	for (i = 0; i < dp->k+dp->m; i++) {
+		if (dp->maps[i] == NULL) continue;
+		if (i < dp->k) {
+			dp->data[slot][i] = dp->maps[i]+off;
+		} else {
+			dp->coding[slot][i-dp->k] = dp->maps[i]+off;
+		}
+		pipeline_prefault(dp->maps[i]+off, dp->blocksize);
+	}
+}
+
+void decode_code(void *arg, int n, int slot)
+{
+	Decode_Pipeline *dp = (Decode_Pipeline *)arg;
+	int i;
+
+	if (dp->tech == Reed_Sol_Van || dp->tech == Reed_Sol_R6_Op) {
+		i = jerasure_matrix_decode(dp->k, dp->m, dp->w, dp->matrix, 1, dp->erasures, dp->data[slot], dp->coding[slot], dp->blocksize);
+	}
+	else if (dp->tech == Cauchy_Orig || dp->tech == Cauchy_Good || dp->tech == Liberation || dp->tech == Blaum_Roth || dp->tech == Liber8tion) {
+		i = jerasure_schedule_decode_stored(dp->store, dp->erasures, dp->data[slot], dp->coding[slot], dp->blocksize, dp->packetsize);
+	}
+	else {
+		fprintf(stderr, "Not a valid coding technique.\n");
+		exit(0);
+	}
+	if (i == -1) dp->failed = 1;
+}
+
+void decode_write(void *arg, int n, int slot)
+{
+	Decode_Pipeline *dp = (Decode_Pipeline *)arg;
+	long off, len;
+	int i;
+
+	for (i = 0; i < dp->k; i++) {
+		off = ((long)n*dp->k+i)*dp->blocksize;
+		len = dp->origsize-off;
+		if (len <= 0) break;
+		if (len > dp->blocksize) len = dp->blocksize;
+		pipeline_pwrite(dp->fd, dp->data[slot][i], len, off);
+	}
+}
+
 void ctrl_bs_handler(int dummy) {
 	time_t mytime;
 	mytime = time(0);
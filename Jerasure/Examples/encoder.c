@@ -57,9 +57,17 @@ the given coding technique. The format of the created files
 is the file name with "_k#" or "_m#" and then the extension.  
 (For example, inputfile test.txt would yield file "test_k1.txt".)
 
+With an optional last argument threads > 0, the input file is 
+mmap'd and blocks are read, encoded by that many threads, and 
+written in a pipeline; the read and write throughput is printed 
+along with the encoding throughput.
+
  */
 #include <sys/time.h>
 #include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
 #include <string.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -70,6 +78,7 @@ is the file name with "_k#" or "_m#" and then the extension.
 #include "galois.h"
 #include "cauchy.h"
 #include "liberation.h"
+#include "pipeline.h"
 
 #define N 10
 
@@ -85,6 +94,25 @@ enum Coding_Technique method;
 int is_prime(int w);
 void ctrl_bs_handler(int dummy);
 
+/* State shared by the stages of the pipelined (mmap) encoder.
+   Each slot has its own pointers, coding buffers and padding block. */
+typedef struct {
+	enum Coding_Technique tech;
+	int k, m, w, packetsize;
+	int *matrix;
+	int **schedule;
+	char *map;				// mmap'd input file, or NULL
+	int size, buffersize, blocksize;
+	int *fds;				// k+m output files, or NULL
+	char ***data;
+	char ***coding;
+	char **block;
+} Encode_Pipeline;
+
+void encode_read(void *arg, int n, int slot);
+void encode_code(void *arg, int n, int slot);
+void encode_write(void *arg, int n, int slot);
+
 int jfread(void *ptr, int size, int nmembers, FILE *stream)
 {
   int nd;
@@ -119,6 +147,7 @@ int main (int argc, char **argv) {
 	int *matrix;
 	int *bitmatrix;
 	int **schedule;
+	jerasure_schedule_store *store;
 	
 	/* Creation of file name variables */
 	char temp[5];
@@ -137,6 +166,11 @@ int main (int argc, char **argv) {
 	/* Find buffersize */
 	int up, down;
 
+	/* Pipelined mode */
+	int threads;
+	Encode_Pipeline ep;
+	Pipeline_Times pt;
+
 
 	signal(SIGQUIT, ctrl_bs_handler);
 
@@ -146,11 +180,13 @@ int main (int argc, char **argv) {
 	matrix = NULL;
 	bitmatrix = NULL;
 	schedule = NULL;
+	store = NULL;
 	
 	/* Error check Arguments*/
-	if (argc != 8) {
-		fprintf(stderr,  "usage: inputfile k m coding_technique w (packetsize) (buffersize)\n");
+	if (argc != 8 && argc != 9) {
+		fprintf(stderr,  "usage: inputfile k m coding_technique w (packetsize) (buffersize) [threads]\n");
 		fprintf(stderr,  "\nChoose one of the following coding techniques: \nreed_sol_van, \nreed_sol_r6_op, \ncauchy_orig, \ncauchy_good, \nliberation, \nblaum_roth, \nliber8tion");
+		fprintf(stderr,  "\n\nWith threads > 0, the input is mmap'd and read, encoded and written in a pipeline\nwith that many encoding threads.\n");
 		exit(0);
 	}
 	/* Conversion of parameters and error checking */	
@@ -175,7 +211,12 @@ int main (int argc, char **argv) {
 			exit(0);
 		}
 	}
-	if (argc != 8) {
+	threads = 0;
+	if (argc == 9 && (sscanf(argv[8], "%d", &threads) == 0 || threads < 0)) {
+		fprintf(stderr, "Invalid value for threads\n");
+		exit(0);
+	}
+	if (argc < 8) {
 		buffersize = 0;
 	}
 	else {
@@ -418,9 +459,9 @@ int main (int argc, char **argv) {
         }
 	
 	/* Allocate for full file name */
-	fname = (char*)malloc(sizeof(char)*(strlen(argv[1])+strlen(curdir)+10));
 	sprintf(temp, "%d", k);
 	md = strlen(temp);
+	fname = (char*)malloc(sizeof(char)*(strlen(curdir)+strlen(s1)+strlen(extension)+md+20));
 	
 	/* Allocate data and coding */
 	data = (char **)malloc(sizeof(char*)*k);
@@ -443,29 +484,29 @@ int main (int argc, char **argv) {
 		case Cauchy_Orig:
 			matrix = cauchy_original_coding_matrix(k, m, w);
 			bitmatrix = jerasure_matrix_to_bitmatrix(k, m, w, matrix);
-			schedule = jerasure_smart_bitmatrix_to_schedule(k, m, w, bitmatrix);
 			break;
 		case Cauchy_Good:
 			matrix = cauchy_good_general_coding_matrix(k, m, w);
 			bitmatrix = jerasure_matrix_to_bitmatrix(k, m, w, matrix);
-			schedule = jerasure_smart_bitmatrix_to_schedule(k, m, w, bitmatrix);
 			break;	
 		case Liberation:
 			bitmatrix = liberation_coding_bitmatrix(k, w);
-			schedule = jerasure_smart_bitmatrix_to_schedule(k, m, w, bitmatrix);
 			break;
 		case Blaum_Roth:
 			bitmatrix = blaum_roth_coding_bitmatrix(k, w);
-			schedule = jerasure_smart_bitmatrix_to_schedule(k, m, w, bitmatrix);
 			break;
 		case Liber8tion:
 			bitmatrix = liber8tion_coding_bitmatrix(k);
-			schedule = jerasure_smart_bitmatrix_to_schedule(k, m, w, bitmatrix);
 			break;
 		default:
 			fprintf(stderr,  "unsupported coding technique used\n");
 			break;
 	}
+	/* Schedules persist across runs if JERASURE_SCHEDULE_DIR is set */
+	if (bitmatrix != NULL) {
+		store = jerasure_open_schedule_store(k, m, w, bitmatrix, 1, NULL);
+		schedule = jerasure_schedule_store_encode(store);
+	}
 	gettimeofday(&start, &tz);	
 	gettimeofday(&t4, &tz);
 	tsec = 0.0;
@@ -477,11 +518,77 @@ int main (int argc, char **argv) {
 	totalsec += tsec;
 	
 
+	/* Pipelined mode: mmap the input file, and read, encode and write
+	   blocks in parallel.  The output is the same as below. */
+	if (threads > 0) {
+		ep.tech = tech;
+		ep.k = k;
+		ep.m = m;
+		ep.w = w;
+		ep.packetsize = packetsize;
+		ep.matrix = matrix;
+		ep.schedule = schedule;
+		ep.size = size;
+		ep.buffersize = blocksize*k;
+		ep.blocksize = blocksize;
+		ep.map = NULL;
+		ep.fds = NULL;
+		if (fp != NULL) {
+			if (size > 0) {
+				ep.map = (char *)mmap(NULL, size, PROT_READ, MAP_PRIVATE, fileno(fp), 0);
+				if (ep.map == MAP_FAILED) { perror("mmap"); exit(1); }
+				madvise(ep.map, size, MADV_SEQUENTIAL);
+			}
+			ep.fds = (int *)malloc(sizeof(int)*(k+m));
+			for (i = 0; i < k+m; i++) {
+				if (i < k) {
+					sprintf(fname, "%s/Coding/%s_k%0*d%s", curdir, s1, md, i+1, extension);
+				} else {
+					sprintf(fname, "%s/Coding/%s_m%0*d%s", curdir, s1, md, i+1-k, extension);
+				}
+				ep.fds[i] = open(fname, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+				if (ep.fds[i] < 0 || ftruncate(ep.fds[i], (off_t)blocksize*readins) < 0) {
+					perror(fname);
+					exit(1);
+				}
+			}
+		}
+		ep.data = (char ***)malloc(sizeof(char **)*(threads+2));
+		ep.coding = (char ***)malloc(sizeof(char **)*(threads+2));
+		ep.block = (char **)malloc(sizeof(char *)*(threads+2));
+		for (n = 0; n < threads+2; n++) {
+			ep.data[n] = (char **)malloc(sizeof(char *)*k);
+			ep.coding[n] = (char **)malloc(sizeof(char *)*m);
+			for (i = 0; i < m; i++) {
+				if (posix_memalign((void **)&ep.coding[n][i], 64, blocksize) != 0) { perror("malloc"); exit(1); }
+			}
+			if (posix_memalign((void **)&ep.block[n], 64, ep.buffersize) != 0) { perror("malloc"); exit(1); }
+		}
+
+		pipeline_run(readins, threads+2, threads, &ep, encode_read, encode_code, encode_write, &pt);
+		totalsec += pt.code/threads;
+
+		for (n = 0; n < threads+2; n++) {
+			for (i = 0; i < m; i++) free(ep.coding[n][i]);
+			free(ep.data[n]);
+			free(ep.coding[n]);
+			free(ep.block[n]);
+		}
+		free(ep.data);
+		free(ep.coding);
+		free(ep.block);
+		if (ep.fds != NULL) {
+			for (i = 0; i < k+m; i++) close(ep.fds[i]);
+			free(ep.fds);
+		}
+		if (ep.map != NULL) munmap(ep.map, size);
+	}
+
 	/* Read in data until finished */
 	n = 1;
 	total = 0;
 
-	while (n <= readins) {
+	while (threads == 0 && n <= readins) {
 		/* Check if padding is needed, if so, add appropriate 
 		   number of zeros */
 		if (total < size && total+buffersize <= size) {
@@ -599,6 +706,7 @@ int main (int argc, char **argv) {
 	free(fname);
 	free(block);
 	free(curdir);
+	if (store != NULL) jerasure_close_schedule_store(store);
 	
 	/* Calculate rate in MB/sec and print */
 	gettimeofday(&t2, &tz);
@@ -610,6 +718,86 @@ int main (int argc, char **argv) {
 	tsec -= t1.tv_sec;
 	printf("Encoding (MB/sec): %0.10f\n", (size/1024/1024)/totalsec);
 	printf("En_Total (MB/sec): %0.10f\n", (size/1024/1024)/tsec);
+	if (threads > 0) {
+		printf("Reading  (MB/sec): %0.10f\n", (size/1024/1024)/pt.read);
+		printf("Writing  (MB/sec): %0.10f\n", (size/1024/1024)/pt.write);
+	}
+}
+
+/* Pipeline stages.  Blocks are numbered from 0 here. */
+
+void encode_read(void *arg, int n, int slot)
+{
+	Encode_Pipeline *ep = (Encode_Pipeline *)arg;
+	char *block;
+	long off, len;
+	int i;
+
+	off = (long)n*ep->buffersize;
+	if (ep->map != NULL && off+ep->buffersize <= ep->size) {
+		/* Whole block in the file: encode straight from the mapping */
+		block = ep->map+off;
+		pipeline_prefault(block, ep->buffersize);
+	}
+	else {
+		/* Tail of the file (or random input): copy and pad with '0' */
+		block = ep->block[slot];
+		if (ep->map == NULL) {
+			jfread(block, ep->buffersize, 1, NULL);
+		}
+		else {
+			len = (off < ep->size) ? ep->size-off : 0;
+			memcpy(block, ep->map+off, len);
+			memset(block+len, '0', ep->buffersize-len);
+		}
+	}
+	for (i = 0; i < ep->k; i++) {
+		ep->data[slot][i] = block+(i*ep->blocksize);
+	}
+}
+
+void encode_code(void *arg, int n, int slot)
+{
+	Encode_Pipeline *ep = (Encode_Pipeline *)arg;
+	char **data = ep->data[slot];
+	char **coding = ep->coding[slot];
+
+	switch(ep->tech) {
+		case No_Coding:
+			break;
+		case Reed_Sol_Van:
+			jerasure_matrix_encode(ep->k, ep->m, ep->w, ep->matrix, data, coding, ep->blocksize);
+			break;
+		case Reed_Sol_R6_Op:
+			reed_sol_r6_encode(ep->k, ep->w, data, coding, ep->blocksize);
+			break;
+		case Cauchy_Orig:
+		case Cauchy_Good:
+		case Liberation:
+		case Blaum_Roth:
+		case Liber8tion:
+			jerasure_schedule_encode(ep->k, ep->m, ep->w, ep->schedule, data, coding, ep->blocksize, ep->packetsize);
+			break;
+		default:
+			fprintf(stderr,  "unsupported coding technique used\n");
+			break;
+	}
+}
+
+void encode_write(void *arg, int n, int slot)
+{
+	Encode_Pipeline *ep = (Encode_Pipeline *)arg;
+	long off;
+	int i;
+
+	if (ep->fds == NULL) return;
+	off = (long)n*ep->blocksize;
+	for (i = 0; i < ep->k; i++) {
+		pipeline_pwrite(ep->fds[i], ep->data[slot][i], ep->blocksize, off);
+	}
+	for (i = 0; i < ep->m; i++) {
+		pipeline_pwrite(ep->fds[ep->k+i], ep->coding[slot][i], ep->blocksize, off);
+	}
 }
 
 /* is_prime returns 1 if number if prime, 0 if not prime */
@@ -0,0 +1,271 @@
+/* Examples/pipeline.c
+
+
+Jerasure - A C/C++ Library for a Variety of Reed-Solomon and RAID-6 Erasure Coding Techniques
+
+Copyright (c) 2026, the NCCloud contributors
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+ - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+ - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in
+   the documentation and/or other materials provided with the
+   distribution.
+
+ - Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived
+   from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY
+WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+
+
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/mman.h>
+#include <sys/time.h>
+#include "pipeline.h"
+
+/* A queue of slot numbers; -1 marks the end of the stream */
+
+typedef struct {
+	int *q;
+	int head, count, size;
+	pthread_cond_t cond;
+} Queue;
+
+typedef struct {
+	int nblocks, ncoders;
+	void *arg;
+	pipeline_fn read_fn, code_fn, write_fn;
+	int *block_of;			/* block held by each slot */
+	Queue free_q, read_q, coded_q;
+	pthread_mutex_t lock;
+	Pipeline_Times *times;
+} Pipeline;
+
+static double now()
+{
+	struct timeval t;
+
+	gettimeofday(&t, NULL);
+	return t.tv_sec + t.tv_usec/1000000.0;
+}
+
+static void queue_init(Queue *q, int size)
+{
+	q->q = (int *)malloc(sizeof(int)*size);
+	q->head = 0;
+	q->count = 0;
+	q->size = size;
+	pthread_cond_init(&q->cond, NULL);
+}
+
+static void queue_free(Queue *q)
+{
+	free(q->q);
+	pthread_cond_destroy(&q->cond);
+}
+
+/* Both of these are called with p->lock held */
+
+static void queue_push(Queue *q, int v)
+{
+	q->q[(q->head+q->count)%q->size] = v;
+	q->count++;
+	pthread_cond_signal(&q->cond);
+}
+
+static int queue_pop(Pipeline *p, Queue *q)
+{
+	int v;
+
+	while (q->count == 0) pthread_cond_wait(&q->cond, &p->lock);
+	v = q->q[q->head];
+	q->head = (q->head+1)%q->size;
+	q->count--;
+	return v;
+}
+
+static void *reader(void *a)
+{
+	Pipeline *p = (Pipeline *)a;
+	int b, slot;
+	double t;
+
+	for (b = 0; b < p->nblocks; b++) {
+		pthread_mutex_lock(&p->lock);
+		slot = queue_pop(p, &p->free_q);
+		pthread_mutex_unlock(&p->lock);
+
+		t = now();
+		p->read_fn(p->arg, b, slot);
+		p->times->read += now()-t;
+
+		pthread_mutex_lock(&p->lock);
+		p->block_of[slot] = b;
+		queue_push(&p->read_q, slot);
+		pthread_mutex_unlock(&p->lock);
+	}
+	pthread_mutex_lock(&p->lock);
+	for (b = 0; b < p->ncoders; b++) queue_push(&p->read_q, -1);
+	pthread_mutex_unlock(&p->lock);
+	return NULL;
+}
+
+static void *coder(void *a)
+{
+	Pipeline *p = (Pipeline *)a;
+	int slot, b;
+	double t;
+
+	while (1) {
+		pthread_mutex_lock(&p->lock);
+		slot = queue_pop(p, &p->read_q);
+		if (slot == -1) {
+			queue_push(&p->coded_q, -1);
+			pthread_mutex_unlock(&p->lock);
+			return NULL;
+		}
+		b = p->block_of[slot];
+		pthread_mutex_unlock(&p->lock);
+
+		t = now();
+		p->code_fn(p->arg, b, slot);
+		t = now()-t;
+
+		pthread_mutex_lock(&p->lock);
+		p->times->code += t;
+		queue_push(&p->coded_q, slot);
+		pthread_mutex_unlock(&p->lock);
+	}
+}
+
+static void *writer(void *a)
+{
+	Pipeline *p = (Pipeline *)a;
+	int slot, b, done;
+	double t;
+
+	done = 0;
+	while (done < p->ncoders) {
+		pthread_mutex_lock(&p->lock);
+		slot = queue_pop(p, &p->coded_q);
+		b = (slot == -1) ? -1 : p->block_of[slot];
+		pthread_mutex_unlock(&p->lock);
+
+		if (slot == -1) {
+			done++;
+			continue;
+		}
+		t = now();
+		p->write_fn(p->arg, b, slot);
+		p->times->write += now()-t;
+
+		pthread_mutex_lock(&p->lock);
+		queue_push(&p->free_q, slot);
+		pthread_mutex_unlock(&p->lock);
+	}
+	return NULL;
+}
+
+void pipeline_run(int nblocks, int nslots, int ncoders, void *arg,
+                  pipeline_fn read_fn, pipeline_fn code_fn, pipeline_fn write_fn,
+                  Pipeline_Times *times)
+{
+	Pipeline p;
+	pthread_t rt, wt, *ct;
+	int i;
+
+	p.nblocks = nblocks;
+	p.ncoders = ncoders;
+	p.arg = arg;
+	p.read_fn = read_fn;
+	p.code_fn = code_fn;
+	p.write_fn = write_fn;
+	p.times = times;
+	times->read = 0.0;
+	times->code = 0.0;
+	times->write = 0.0;
+	p.block_of = (int *)malloc(sizeof(int)*nslots);
+	pthread_mutex_init(&p.lock, NULL);
+
+	/* The end markers need room too */
+	queue_init(&p.free_q, nslots);
+	queue_init(&p.read_q, nslots+ncoders);
+	queue_init(&p.coded_q, nslots+ncoders);
+	for (i = 0; i < nslots; i++) queue_push(&p.free_q, i);
+
+	ct = (pthread_t *)malloc(sizeof(pthread_t)*ncoders);
+	if (pthread_create(&rt, NULL, reader, &p) != 0 || pthread_create(&wt, NULL, writer, &p) != 0) {
+		perror("pthread_create");
+		exit(1);
+	}
+	for (i = 0; i < ncoders; i++) {
+		if (pthread_create(ct+i, NULL, coder, &p) != 0) {
+			perror("pthread_create");
+			exit(1);
+		}
+	}
+	pthread_join(rt, NULL);
+	for (i = 0; i < ncoders; i++) pthread_join(ct[i], NULL);
+	pthread_join(wt, NULL);
+
+	free(ct);
+	free(p.block_of);
+	queue_free(&p.free_q);
+	queue_free(&p.read_q);
+	queue_free(&p.coded_q);
+	pthread_mutex_destroy(&p.lock);
+}
+
+void pipeline_prefault(char *ptr, long size)
+{
+	volatile char sum;
+	long i, pg;
+
+	if (size <= 0) return;
+	pg = sysconf(_SC_PAGESIZE);
+	madvise((void *)((unsigned long)ptr & ~(pg-1)), size + ((unsigned long)ptr & (pg-1)), MADV_WILLNEED);
+	sum = 0;
+	for (i = 0; i < size; i += pg) sum ^= ptr[i];
+	sum ^= ptr[size-1];
+}
+
+void pipeline_pwrite(int fd, char *buf, long size, long offset)
+{
+	ssize_t w;
+
+	while (size > 0) {
+		w = pwrite(fd, buf, size, offset);
+		if (w < 0 && errno == EINTR) continue;
+		if (w <= 0) {
+			perror("pwrite");
+			exit(1);
+		}
+		buf += w;
+		size -= w;
+		offset += w;
+	}
+}
@@ -0,0 +1,78 @@
+/* Examples/pipeline.h
+
+
+Jerasure - A C/C++ Library for a Variety of Reed-Solomon and RAID-6 Erasure Coding Techniques
+
+Copyright (c) 2026, the NCCloud contributors
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+ - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+ - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in
+   the documentation and/or other materials provided with the
+   distribution.
+
+ - Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived
+   from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY
+WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+
+
+ */
+
+/* 
+
+A three-stage pipeline for encoder.c and decoder.c.  Blocks 0 to 
+nblocks-1 go through read, code and write.  One thread reads, 
+ncoders threads code, and one thread writes, so that the three 
+overlap.  Each block in flight owns one of nslots slots, which 
+the callbacks use to find their buffers.  Blocks are read in order, 
+but may be coded and written out of order.
+
+ */
+
+#ifndef _PIPELINE_H
+#define _PIPELINE_H
+
+typedef void (*pipeline_fn)(void *arg, int block, int slot);
+
+/* Busy time of each stage, in seconds.  code is summed over the coding threads. */
+
+typedef struct {
+	double read;
+	double code;
+	double write;
+} Pipeline_Times;
+
+void pipeline_run(int nblocks, int nslots, int ncoders, void *arg,
+                  pipeline_fn read_fn, pipeline_fn code_fn, pipeline_fn write_fn,
+                  Pipeline_Times *times);
+
+/* Touches every page of a mapped region, so that the reading thread
+   takes the page faults instead of the coding threads. */
+
+void pipeline_prefault(char *ptr, long size);
+
+/* pwrite()s all of buf or exits */
+
+void pipeline_pwrite(int fd, char *buf, long size, long offset);
+
+#endif
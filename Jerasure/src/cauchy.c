@@ -78,6 +78,13 @@ static int *cbest_12, *cbest_13, *cbest_14, *cbest_15, *cbest_16, *cbest_17, *cb
            *cbest_21, *cbest_22, *cbest_23, *cbest_24, *cbest_25, *cbest_26, *cbest_27, *cbest_28, *cbest_29, *cbest_30,
            *cbest_31, *cbest_32;
 
+/* Tables for m > 2, generated offline by cauchy_search into cauchy_best_general.c */
+
+extern int cauchy_best_general_w;
+extern int cauchy_best_general_max_m;
+extern int cauchy_best_general_max_k;
+extern int **cauchy_best_general[];
+
 static int cbest_max_k[33] = { -1, -1, 3, 7, 15, 31, 63, 127, 255, 511, 1023, 1023, -1,
      -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
      -1, -1, -1, -1 };
@@ -232,6 +239,12 @@ int *cauchy_good_general_coding_matrix(int k, int m, int w)
       matrix[i+k] = cbest_all[w][i];
     }
     return matrix;
+  } else if (m > 2 && m <= cauchy_best_general_max_m && w == cauchy_best_general_w &&
+             k >= 2 && k <= cauchy_best_general_max_k) {
+    matrix = talloc(int, k*m);
+    if (matrix == NULL) return NULL;
+    memcpy(matrix, cauchy_best_general[m][k], sizeof(int)*k*m);
+    return matrix;
   } else {
     matrix = cauchy_original_coding_matrix(k, m, w);
     if (matrix == NULL) return NULL;
@@ -0,0 +1,948 @@
+/* cauchy_best_general.c
+ * Generated by: cauchy_search 8 3 6 32 20000 1 ones
+ * Do not edit -- rerun "make cauchy_tables" instead. */
+
+#include <stdio.h>
+
+static int cbest_general_m3_k2[6] = {
+    1, 1, 2, 1, 1, 2 };
+
+static int cbest_general_m3_k3[9] = {
+    1, 1, 1, 173, 2, 1, 142, 1, 70 };
+
+static int cbest_general_m3_k4[12] = {
+    1, 1, 1, 1, 2, 142, 132, 1, 65, 2, 1, 216 };
+
+static int cbest_general_m3_k5[15] = {
+    1, 1, 1, 1, 1, 2, 142, 71, 1, 4, 70, 140, 142, 143, 1 };
+
+static int cbest_general_m3_k6[18] = {
+    1, 1, 1, 1, 1, 1, 142, 134, 172, 2, 155, 1, 34, 173, 2, 77,
+    1, 70 };
+
+static int cbest_general_m3_k7[21] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 70, 142, 4, 172, 69, 158, 33, 2,
+    226, 8, 71, 172, 1 };
+
+static int cbest_general_m3_k8[24] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 5, 142, 2, 134, 1, 71, 143, 35,
+    2, 113, 4, 3, 195, 71, 1, 142 };
+
+static int cbest_general_m3_k9[27] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 200, 158, 142, 172, 66, 2, 1,
+    70, 71, 142, 1, 84, 3, 71, 96, 4, 70, 216 };
+
+static int cbest_general_m3_k10[30] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 35, 2, 67, 5, 132, 216,
+    3, 43, 1, 200, 1, 33, 6, 70, 71, 173, 8, 142, 135, 2 };
+
+static int cbest_general_m3_k11[33] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 3, 4, 84, 70,
+    216, 96, 71, 8, 35, 142, 33, 69, 2, 1, 140, 142, 4, 132, 216, 173,
+    141 };
+
+static int cbest_general_m3_k12[36] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 201, 34, 142, 6,
+    104, 159, 70, 17, 172, 1, 12, 4, 17, 130, 142, 2, 1, 71, 34, 3,
+    200, 118, 172, 27 };
+
+static int cbest_general_m3_k13[39] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 201, 200, 34,
+    1, 16, 135, 173, 175, 2, 84, 70, 10, 142, 16, 142, 6, 155, 70, 1,
+    143, 67, 219, 2, 200, 3, 35 };
+
+static int cbest_general_m3_k14[42] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 43, 142,
+    35, 70, 6, 134, 71, 130, 49, 1, 34, 3, 32, 2, 216, 34, 143, 77,
+    175, 25, 136, 3, 2, 1, 33, 48, 35, 131 };
+
+static int cbest_general_m3_k15[45] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 6,
+    2, 172, 142, 132, 71, 1, 77, 67, 69, 173, 70, 8, 12, 86, 70, 55,
+    34, 227, 16, 2, 58, 142, 8, 86, 17, 32, 117, 134, 1 };
+
+static int cbest_general_m3_k16[48] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    2, 65, 181, 143, 8, 70, 234, 71, 43, 1, 86, 17, 4, 134, 33, 48,
+    14, 16, 2, 42, 69, 116, 71, 221, 173, 68, 216, 3, 235, 10, 217, 1 };
+
+static int cbest_general_m3_k17[51] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 234, 3, 142, 132, 1, 67, 192, 79, 138, 109, 158, 143, 2, 173, 16,
+    66, 38, 142, 16, 196, 33, 70, 35, 1, 4, 143, 2, 175, 220, 136, 67,
+    169, 234, 71 };
+
+static int cbest_general_m3_k18[54] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 71, 4, 18, 66, 2, 173, 48, 65, 132, 6, 142, 67, 201, 108,
+    128, 1, 78, 17, 87, 205, 1, 4, 69, 218, 70, 140, 201, 17, 134, 132,
+    172, 71, 2, 112, 143, 82 };
+
+static int cbest_general_m3_k19[57] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 101, 2, 118, 142, 16, 65, 175, 234, 66, 84, 200, 4, 35,
+    87, 1, 151, 71, 67, 17, 142, 203, 1, 131, 70, 12, 200, 16, 71, 67,
+    5, 98, 50, 172, 77, 4, 116, 2, 175 };
+
+static int cbest_general_m3_k20[60] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 65, 20, 4, 71, 16, 35, 170, 173, 2, 97, 78, 234,
+    193, 100, 130, 1, 133, 217, 84, 6, 79, 33, 235, 171, 174, 69, 1, 130,
+    156, 2, 3, 175, 140, 142, 86, 172, 71, 6, 35, 4 };
+
+static int cbest_general_m3_k21[63] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 70, 142, 143, 158, 140, 200, 165, 172, 34, 12, 217,
+    2, 157, 16, 4, 77, 5, 201, 193, 71, 1, 87, 156, 69, 3, 216, 134,
+    173, 8, 5, 172, 67, 200, 2, 1, 158, 142, 70, 10, 143, 71, 66 };
+
+static int cbest_general_m3_k22[66] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 39, 113, 159, 142, 48, 32, 140, 151, 28, 2,
+    3, 172, 12, 201, 43, 128, 1, 193, 8, 143, 34, 174, 2, 3, 108, 159,
+    140, 169, 205, 71, 1, 133, 142, 66, 134, 154, 17, 8, 131, 16, 193, 172,
+    70, 234 };
+
+static int cbest_general_m3_k23[69] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 238, 71, 21, 35, 140, 47, 34, 205, 3,
+    69, 142, 50, 4, 2, 1, 70, 234, 134, 26, 200, 169, 173, 172, 35, 49,
+    201, 130, 200, 2, 67, 143, 142, 33, 160, 34, 45, 7, 16, 173, 108, 154,
+    4, 3, 70, 174, 218 };
+
+static int cbest_general_m3_k24[72] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 8, 201, 86, 137, 193, 164, 1, 70,
+    6, 152, 35, 68, 216, 4, 42, 140, 235, 158, 207, 138, 43, 132, 3, 142,
+    84, 140, 67, 2, 5, 35, 130, 48, 16, 142, 41, 200, 86, 65, 193, 71,
+    17, 132, 4, 1, 201, 100, 33, 42 };
+
+static int cbest_general_m3_k25[75] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 70, 67, 132, 71, 92, 64, 20,
+    6, 138, 83, 2, 193, 172, 33, 134, 143, 34, 174, 1, 35, 49, 140, 8,
+    29, 173, 218, 128, 70, 238, 71, 69, 172, 5, 158, 2, 6, 200, 205, 134,
+    141, 20, 165, 17, 12, 86, 1, 113, 150, 142, 135 };
+
+static int cbest_general_m3_k26[78] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 158, 43, 71, 200, 35, 66,
+    192, 67, 172, 2, 69, 173, 87, 70, 1, 108, 136, 143, 10, 156, 8, 142,
+    134, 5, 3, 216, 4, 175, 71, 2, 220, 1, 17, 217, 12, 157, 143, 165,
+    70, 5, 16, 32, 173, 193, 201, 142, 172, 77, 200, 34, 158, 140 };
+
+static int cbest_general_m3_k27[81] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 134, 75, 5, 234, 136,
+    81, 142, 16, 173, 33, 8, 86, 71, 82, 77, 158, 1, 143, 193, 4, 200,
+    32, 69, 70, 2, 19, 172, 17, 4, 108, 34, 35, 2, 74, 174, 157, 65,
+    142, 24, 195, 3, 158, 10, 96, 138, 1, 77, 172, 20, 43, 86, 8, 71,
+    201 };
+
+static int cbest_general_m3_k28[84] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 16, 128, 50, 10,
+    71, 182, 56, 27, 217, 35, 132, 48, 140, 241, 138, 17, 2, 100, 3, 173,
+    1, 172, 189, 4, 64, 133, 142, 216, 75, 3, 48, 41, 167, 8, 16, 12,
+    173, 175, 4, 34, 141, 2, 67, 77, 131, 200, 84, 117, 90, 205, 142, 218,
+    71, 1, 6, 85 };
+
+static int cbest_general_m3_k29[87] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 18, 251, 4,
+    139, 57, 68, 70, 21, 135, 192, 202, 117, 172, 154, 2, 83, 58, 26, 6,
+    109, 71, 108, 1, 130, 34, 193, 41, 200, 235, 16, 142, 165, 6, 71, 3,
+    234, 69, 33, 17, 4, 130, 113, 86, 174, 173, 70, 8, 132, 134, 32, 238,
+    166, 50, 200, 21, 1, 175, 172 };
+
+static int cbest_general_m3_k30[90] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 158, 87,
+    86, 1, 29, 200, 216, 108, 173, 172, 156, 134, 43, 192, 10, 71, 67, 3,
+    143, 218, 8, 66, 69, 217, 2, 35, 70, 5, 142, 136, 4, 70, 135, 16,
+    35, 2, 140, 32, 165, 12, 142, 200, 175, 17, 201, 71, 217, 158, 193, 69,
+    172, 1, 143, 68, 157, 220, 5, 34, 77, 173 };
+
+static int cbest_general_m3_k31[93] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 173,
+    86, 132, 1, 35, 70, 226, 142, 10, 134, 200, 172, 9, 141, 3, 78, 19,
+    201, 11, 54, 174, 64, 2, 143, 17, 184, 138, 59, 21, 71, 216, 78, 71,
+    84, 56, 18, 188, 25, 97, 43, 110, 35, 201, 1, 140, 3, 134, 67, 234,
+    173, 33, 8, 16, 10, 142, 32, 17, 143, 2, 169, 193, 205 };
+
+static int cbest_general_m3_k32[96] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    234, 141, 20, 71, 216, 2, 43, 140, 169, 10, 17, 134, 4, 174, 132, 175,
+    37, 142, 69, 6, 13, 70, 3, 172, 173, 58, 33, 86, 1, 138, 16, 157,
+    174, 2, 201, 165, 32, 16, 100, 5, 69, 34, 200, 217, 157, 70, 1, 68,
+    142, 71, 12, 158, 173, 220, 193, 135, 140, 35, 4, 175, 77, 143, 172, 17 };
+
+static int cbest_general_m4_k2[8] = {
+    1, 1, 1, 2, 1, 142, 71, 1 };
+
+static int cbest_general_m4_k3[12] = {
+    1, 1, 1, 2, 1, 134, 1, 172, 4, 2, 79, 1 };
+
+static int cbest_general_m4_k4[16] = {
+    1, 1, 1, 1, 1, 142, 140, 143, 4, 142, 70, 3, 8, 142, 1, 2 };
+
+static int cbest_general_m4_k5[20] = {
+    1, 1, 1, 1, 1, 142, 172, 70, 200, 1, 158, 2, 1, 142, 8, 71,
+    3, 5, 1, 2 };
+
+static int cbest_general_m4_k6[24] = {
+    1, 1, 1, 1, 1, 1, 200, 142, 1, 140, 143, 70, 195, 71, 4, 142,
+    1, 2, 1, 71, 2, 35, 143, 5 };
+
+static int cbest_general_m4_k7[28] = {
+    1, 1, 1, 1, 1, 1, 1, 34, 2, 39, 226, 142, 70, 140, 34, 172,
+    1, 142, 32, 138, 77, 173, 100, 2, 86, 69, 17, 1 };
+
+static int cbest_general_m4_k8[32] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 239, 3, 201, 1, 132, 67, 2, 204,
+    142, 38, 1, 21, 143, 40, 70, 140, 71, 134, 4, 35, 1, 34, 2, 142 };
+
+static int cbest_general_m4_k9[36] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 41, 238, 70, 138, 67, 201,
+    3, 142, 3, 86, 4, 140, 200, 108, 142, 1, 201, 192, 4, 3, 108, 142,
+    17, 8, 174, 1 };
+
+static int cbest_general_m4_k10[40] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 2, 134, 201, 26, 175, 1,
+    65, 40, 71, 96, 41, 152, 130, 142, 143, 1, 5, 3, 10, 201, 71, 1,
+    2, 16, 165, 43, 175, 4, 234, 67 };
+
+static int cbest_general_m4_k11[44] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 5, 1, 158, 69, 33,
+    71, 35, 2, 143, 140, 141, 2, 195, 65, 66, 17, 71, 142, 4, 1, 7,
+    21, 77, 33, 70, 4, 217, 140, 165, 16, 71, 2, 1 };
+
+static int cbest_general_m4_k12[48] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 132, 2, 168,
+    143, 216, 33, 8, 50, 71, 16, 226, 158, 5, 70, 20, 65, 33, 1, 4,
+    232, 172, 226, 142, 56, 201, 173, 1, 200, 2, 169, 111, 142, 9, 34, 138 };
+
+static int cbest_general_m4_k13[52] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 171, 216, 66,
+    70, 35, 143, 67, 74, 34, 64, 39, 8, 48, 2, 1, 71, 100, 143, 56,
+    174, 17, 50, 35, 64, 140, 142, 35, 141, 212, 34, 108, 4, 142, 2, 100,
+    172, 1, 94, 222 };
+
+static int cbest_general_m4_k14[56] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 66, 16,
+    138, 142, 113, 3, 188, 69, 71, 79, 1, 195, 18, 4, 138, 159, 67, 70,
+    1, 17, 86, 134, 142, 84, 3, 2, 173, 4, 1, 48, 39, 69, 164, 227,
+    142, 139, 197, 3, 195, 17, 175, 35 };
+
+static int cbest_general_m4_k15[60] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 134,
+    66, 71, 195, 143, 65, 142, 2, 4, 3, 1, 200, 69, 113, 158, 35, 201,
+    173, 8, 34, 2, 110, 17, 192, 100, 238, 140, 226, 168, 1, 87, 69, 71,
+    1, 217, 158, 35, 5, 2, 134, 143, 70, 67, 142, 200 };
+
+static int cbest_general_m4_k16[64] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    64, 192, 1, 193, 6, 74, 24, 35, 16, 90, 87, 142, 219, 2, 58, 159,
+    66, 143, 5, 172, 8, 200, 136, 142, 140, 1, 87, 249, 71, 216, 69, 29,
+    1, 193, 34, 12, 172, 2, 173, 77, 197, 16, 70, 33, 71, 140, 143, 35 };
+
+static int cbest_general_m4_k17[68] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 3, 1, 134, 216, 142, 108, 71, 96, 64, 141, 156, 20, 4, 148, 43,
+    6, 70, 168, 101, 21, 169, 67, 64, 201, 221, 134, 70, 130, 142, 1, 84,
+    43, 4, 158, 43, 169, 70, 216, 50, 34, 158, 142, 205, 42, 4, 9, 71,
+    1, 2, 5, 159 };
+
+static int cbest_general_m4_k18[72] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 226, 202, 134, 45, 65, 42, 1, 109, 35, 84, 142, 2, 173, 140,
+    70, 68, 4, 165, 73, 67, 234, 71, 205, 70, 86, 142, 1, 2, 33, 95,
+    77, 6, 140, 100, 217, 9, 142, 2, 79, 175, 216, 158, 180, 33, 18, 19,
+    149, 69, 140, 35, 67, 234, 68, 16 };
+
+static int cbest_general_m4_k19[76] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 173, 43, 71, 193, 1, 12, 8, 142, 69, 100, 219, 168, 201,
+    84, 242, 166, 41, 16, 25, 195, 6, 7, 68, 220, 216, 142, 217, 3, 2,
+    169, 134, 69, 49, 1, 143, 51, 110, 226, 17, 84, 71, 35, 156, 42, 254,
+    225, 19, 134, 70, 6, 87, 2, 68, 201, 8, 142, 34 };
+
+static int cbest_general_m4_k20[80] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 70, 1, 92, 172, 142, 8, 68, 4, 78, 50, 2, 40,
+    67, 175, 161, 180, 17, 143, 236, 35, 236, 100, 143, 132, 95, 134, 20, 117,
+    28, 140, 184, 2, 1, 38, 142, 70, 67, 16, 173, 3, 50, 40, 2, 224,
+    67, 143, 132, 165, 71, 1, 156, 233, 8, 17, 142, 4, 238, 35, 158, 180 };
+
+static int cbest_general_m4_k21[84] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 3, 70, 67, 165, 66, 172, 134, 232, 17, 142, 159,
+    175, 4, 43, 21, 143, 1, 16, 33, 141, 235, 1, 142, 138, 77, 17, 102,
+    69, 42, 3, 71, 16, 143, 4, 83, 70, 100, 113, 109, 65, 158, 108, 16,
+    235, 3, 1, 58, 6, 109, 4, 20, 32, 100, 101, 143, 70, 138, 172, 28,
+    5, 238, 142, 173 };
+
+static int cbest_general_m4_k22[88] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 196, 108, 67, 3, 130, 1, 50, 2, 138, 6,
+    21, 172, 24, 201, 34, 155, 4, 173, 41, 170, 117, 71, 4, 32, 35, 66,
+    113, 184, 1, 135, 173, 108, 70, 143, 6, 192, 165, 3, 71, 141, 17, 43,
+    9, 226, 2, 216, 34, 141, 173, 54, 71, 96, 51, 174, 79, 28, 5, 130,
+    8, 35, 76, 142, 132, 4, 70, 167 };
+
+static int cbest_general_m4_k23[92] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 142, 8, 85, 24, 65, 234, 35, 43, 220,
+    86, 182, 75, 194, 140, 54, 1, 17, 12, 69, 2, 33, 96, 25, 29, 84,
+    65, 34, 32, 117, 134, 8, 143, 1, 71, 2, 21, 142, 3, 76, 175, 10,
+    132, 200, 216, 17, 108, 205, 220, 142, 71, 1, 2, 157, 131, 173, 44, 84,
+    236, 4, 135, 6, 76, 12, 193, 17, 8, 138, 3, 238 };
+
+static int cbest_general_m4_k24[96] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 70, 17, 2, 71, 67, 16, 41, 174,
+    9, 24, 20, 38, 98, 201, 86, 142, 239, 49, 13, 65, 35, 8, 238, 101,
+    168, 143, 218, 116, 184, 1, 200, 70, 18, 71, 142, 35, 4, 140, 17, 234,
+    9, 172, 232, 203, 79, 216, 68, 2, 27, 131, 47, 172, 67, 94, 1, 118,
+    69, 156, 242, 17, 16, 2, 45, 71, 4, 34, 8, 138, 49, 232, 201, 218 };
+
+static int cbest_general_m4_k25[100] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 70, 34, 1, 67, 58, 6, 2,
+    38, 32, 26, 69, 195, 232, 143, 4, 220, 140, 217, 173, 169, 48, 134, 142,
+    135, 155, 45, 172, 156, 169, 199, 8, 101, 2, 50, 134, 232, 117, 17, 184,
+    227, 154, 193, 5, 70, 201, 4, 1, 132, 136, 87, 68, 232, 6, 21, 1,
+    49, 156, 39, 48, 5, 201, 71, 216, 65, 158, 142, 16, 100, 43, 96, 73,
+    2, 90, 140, 79 };
+
+static int cbest_general_m4_k26[104] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 192, 45, 21, 142, 17, 71,
+    174, 85, 102, 1, 168, 164, 8, 50, 129, 226, 2, 140, 141, 143, 173, 201,
+    9, 234, 134, 128, 142, 139, 203, 57, 165, 51, 4, 192, 173, 96, 5, 69,
+    87, 66, 2, 201, 138, 27, 3, 113, 64, 67, 1, 10, 234, 216, 154, 2,
+    173, 200, 165, 141, 97, 71, 67, 1, 4, 16, 180, 132, 5, 108, 226, 70,
+    158, 172, 142, 143, 203, 138, 136, 174 };
+
+static int cbest_general_m4_k27[108] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 5, 42, 200, 142, 138,
+    8, 158, 161, 117, 21, 1, 148, 4, 131, 43, 235, 18, 168, 165, 71, 10,
+    132, 226, 6, 143, 70, 17, 54, 238, 71, 140, 174, 66, 2, 8, 34, 134,
+    77, 201, 40, 87, 4, 159, 1, 142, 200, 169, 20, 48, 16, 108, 207, 5,
+    30, 2, 1, 17, 217, 175, 49, 26, 43, 4, 87, 173, 172, 32, 140, 235,
+    65, 39, 208, 16, 204, 66, 130, 195, 97, 134, 5, 142 };
+
+static int cbest_general_m4_k28[112] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 43, 1, 4, 14,
+    17, 16, 70, 3, 226, 216, 34, 142, 50, 174, 8, 38, 32, 65, 48, 35,
+    69, 108, 45, 55, 26, 155, 158, 193, 193, 201, 86, 10, 108, 162, 164, 4,
+    156, 34, 2, 200, 6, 1, 142, 158, 65, 216, 155, 136, 25, 140, 71, 66,
+    168, 79, 173, 203, 34, 175, 17, 134, 22, 71, 235, 154, 140, 48, 165, 70,
+    201, 171, 10, 1, 226, 232, 138, 28, 167, 78, 142, 143, 172, 5, 130, 16 };
+
+static int cbest_general_m4_k29[116] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 143, 108, 200,
+    142, 33, 64, 9, 8, 201, 51, 5, 100, 58, 18, 10, 194, 134, 117, 69,
+    159, 79, 216, 71, 85, 42, 1, 174, 66, 70, 172, 9, 18, 79, 232, 69,
+    169, 201, 85, 112, 140, 159, 3, 142, 64, 67, 148, 208, 8, 1, 2, 35,
+    71, 143, 5, 37, 218, 109, 216, 203, 42, 143, 2, 1, 193, 116, 65, 134,
+    142, 81, 5, 24, 200, 175, 9, 172, 4, 217, 131, 3, 59, 35, 67, 180,
+    50, 138, 70, 132 };
+
+static int cbest_general_m4_k30[120] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 190, 149,
+    66, 71, 193, 113, 33, 42, 172, 175, 169, 4, 140, 195, 5, 40, 200, 233,
+    120, 8, 1, 143, 34, 16, 142, 48, 2, 87, 12, 3, 142, 65, 173, 157,
+    14, 234, 195, 3, 71, 1, 69, 21, 132, 2, 159, 70, 17, 4, 200, 29,
+    92, 136, 135, 140, 76, 84, 193, 6, 35, 64, 83, 35, 161, 41, 143, 69,
+    3, 33, 205, 6, 43, 206, 195, 1, 32, 34, 47, 238, 2, 156, 135, 116,
+    84, 190, 24, 173, 28, 101, 221, 142 };
+
+static int cbest_general_m4_k31[124] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 34,
+    151, 37, 96, 48, 5, 163, 67, 140, 86, 68, 66, 35, 7, 65, 73, 6,
+    238, 17, 169, 142, 192, 110, 134, 69, 71, 193, 129, 3, 2, 1, 170, 20,
+    34, 86, 147, 50, 130, 217, 120, 134, 71, 200, 146, 4, 174, 35, 193, 1,
+    42, 68, 172, 216, 12, 169, 234, 108, 142, 70, 175, 33, 165, 138, 71, 142,
+    38, 173, 70, 17, 73, 1, 16, 242, 79, 3, 8, 167, 48, 33, 55, 75,
+    200, 184, 21, 25, 32, 221, 158, 186, 201, 92, 43, 101 };
+
+static int cbest_general_m4_k32[128] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    8, 201, 35, 77, 140, 32, 48, 87, 66, 117, 34, 182, 174, 67, 19, 154,
+    4, 5, 142, 143, 10, 159, 24, 3, 165, 39, 16, 71, 69, 1, 2, 33,
+    110, 54, 218, 140, 1, 56, 9, 98, 8, 50, 200, 158, 17, 224, 142, 135,
+    40, 220, 236, 94, 67, 165, 157, 161, 5, 108, 2, 3, 71, 183, 168, 141,
+    158, 226, 203, 78, 87, 1, 20, 173, 249, 132, 192, 34, 13, 43, 86, 142,
+    200, 216, 71, 10, 70, 143, 172, 69, 35, 2, 213, 136, 8, 156, 66, 3 };
+
+static int cbest_general_m5_k2[10] = {
+    1, 1, 2, 1, 142, 4, 2, 142, 1, 2 };
+
+static int cbest_general_m5_k3[15] = {
+    1, 1, 1, 1, 70, 142, 2, 3, 142, 2, 1, 173, 217, 2, 1 };
+
+static int cbest_general_m5_k4[20] = {
+    1, 1, 1, 1, 4, 154, 1, 134, 200, 1, 158, 4, 43, 10, 2, 142,
+    142, 4, 1, 148 };
+
+static int cbest_general_m5_k5[25] = {
+    1, 1, 1, 1, 1, 174, 3, 34, 86, 1, 2, 173, 84, 1, 172, 203,
+    159, 1, 2, 142, 1, 4, 2, 171, 201 };
+
+static int cbest_general_m5_k6[30] = {
+    1, 1, 1, 1, 1, 1, 2, 35, 3, 5, 71, 1, 1, 140, 172, 70,
+    142, 200, 8, 168, 2, 1, 158, 142, 8, 1, 28, 4, 142, 155 };
+
+static int cbest_general_m5_k7[35] = {
+    1, 1, 1, 1, 1, 1, 1, 3, 1, 70, 4, 175, 10, 142, 200, 33,
+    141, 226, 143, 1, 142, 143, 141, 140, 1, 108, 70, 142, 1, 113, 142, 4,
+    143, 2, 71 };
+
+static int cbest_general_m5_k8[40] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 175, 70, 3, 1, 10, 4, 142, 20,
+    108, 142, 70, 35, 3, 10, 97, 2, 3, 1, 2, 226, 4, 8, 142, 43,
+    108, 140, 143, 141, 70, 1, 142, 169 };
+
+static int cbest_general_m5_k9[45] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 9, 8, 12, 218, 1, 142, 100,
+    35, 71, 158, 70, 172, 65, 159, 132, 4, 1, 10, 173, 9, 35, 130, 70,
+    72, 169, 71, 1, 1, 2, 71, 143, 87, 67, 8, 33, 28 };
+
+static int cbest_general_m5_k10[50] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 2, 1, 140, 218, 3, 142,
+    16, 28, 109, 70, 70, 71, 132, 34, 67, 14, 142, 42, 138, 8, 50, 1,
+    130, 70, 108, 10, 157, 86, 2, 27, 207, 16, 2, 226, 117, 1, 70, 142,
+    205, 8 };
+
+static int cbest_general_m5_k11[55] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 70, 142, 71, 18, 200,
+    69, 16, 1, 100, 2, 113, 173, 84, 200, 142, 70, 136, 140, 44, 172, 117,
+    1, 42, 140, 1, 71, 5, 17, 35, 6, 3, 20, 2, 70, 4, 142, 158,
+    1, 143, 168, 180, 2, 154, 8 };
+
+static int cbest_general_m5_k12[60] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 168, 172, 32, 67,
+    192, 34, 143, 204, 110, 1, 141, 71, 35, 143, 173, 77, 3, 159, 138, 158,
+    2, 200, 142, 16, 1, 85, 35, 175, 172, 12, 8, 2, 37, 159, 71, 201,
+    79, 35, 76, 33, 5, 34, 70, 41, 2, 142, 71, 216 };
+
+static int cbest_general_m5_k13[65] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 4, 115, 180,
+    79, 142, 69, 1, 5, 39, 17, 100, 71, 66, 50, 142, 156, 86, 3, 34,
+    84, 87, 17, 234, 71, 75, 16, 4, 2, 217, 86, 110, 232, 216, 70, 67,
+    113, 12, 35, 1, 132, 64, 4, 235, 221, 100, 172, 3, 142, 69, 1, 169,
+    159 };
+
+static int cbest_general_m5_k14[70] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 142, 54,
+    235, 175, 1, 136, 170, 4, 20, 70, 35, 10, 171, 174, 7, 8, 1, 138,
+    172, 65, 71, 173, 32, 66, 17, 4, 175, 67, 1, 192, 173, 6, 217, 35,
+    70, 16, 86, 2, 226, 8, 117, 34, 112, 140, 69, 138, 95, 35, 66, 70,
+    8, 43, 21, 33, 1, 86 };
+
+static int cbest_general_m5_k15[75] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 195,
+    1, 108, 65, 96, 86, 43, 138, 208, 172, 17, 24, 8, 142, 10, 181, 65,
+    50, 172, 12, 5, 1, 2, 35, 3, 203, 142, 223, 109, 138, 71, 16, 2,
+    17, 195, 200, 66, 1, 142, 158, 3, 102, 4, 109, 65, 71, 193, 5, 33,
+    1, 70, 69, 143, 35, 200, 134, 86, 2, 8, 158 };
+
+static int cbest_general_m5_k16[80] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    200, 140, 132, 79, 10, 143, 3, 1, 18, 35, 21, 232, 16, 70, 142, 173,
+    155, 1, 224, 49, 154, 2, 180, 8, 54, 90, 70, 5, 35, 4, 142, 158,
+    2, 96, 3, 6, 135, 180, 25, 66, 79, 69, 65, 67, 35, 142, 5, 219,
+    70, 71, 169, 84, 10, 73, 138, 33, 158, 4, 227, 234, 3, 168, 1, 140 };
+
+static int cbest_general_m5_k17[85] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 70, 86, 133, 6, 163, 116, 4, 142, 14, 1, 175, 118, 69, 171, 68,
+    9, 2, 39, 9, 35, 194, 3, 5, 165, 43, 17, 143, 1, 138, 16, 68,
+    201, 2, 96, 1, 91, 143, 33, 8, 154, 2, 239, 134, 204, 9, 71, 34,
+    226, 67, 130, 132, 158, 67, 65, 1, 4, 16, 70, 130, 251, 194, 117, 172,
+    7, 142, 132, 82, 5 };
+
+static int cbest_general_m5_k18[90] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 140, 6, 235, 48, 68, 201, 65, 142, 109, 43, 70, 158, 87, 16,
+    2, 173, 134, 232, 51, 138, 117, 1, 19, 221, 70, 75, 86, 12, 207, 216,
+    173, 4, 139, 200, 67, 172, 69, 21, 1, 173, 65, 79, 9, 140, 67, 26,
+    2, 66, 219, 71, 55, 77, 149, 20, 205, 142, 173, 16, 35, 172, 201, 110,
+    34, 216, 168, 2, 5, 70, 67, 20, 21, 17 };
+
+static int cbest_general_m5_k19[95] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 67, 40, 143, 174, 142, 235, 66, 35, 69, 150, 4, 15, 70,
+    201, 86, 159, 25, 1, 171, 155, 69, 158, 3, 32, 193, 165, 86, 201, 141,
+    192, 6, 2, 175, 92, 47, 1, 96, 67, 201, 111, 79, 8, 33, 143, 70,
+    66, 174, 16, 157, 41, 228, 200, 134, 71, 1, 142, 87, 104, 142, 164, 143,
+    121, 2, 216, 192, 116, 140, 173, 71, 35, 16, 69, 155, 65, 33, 172 };
+
+static int cbest_general_m5_k20[100] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 34, 83, 27, 10, 67, 65, 3, 201, 56, 141, 134, 76,
+    8, 1, 42, 71, 169, 87, 2, 129, 21, 169, 5, 66, 216, 134, 39, 8,
+    65, 20, 4, 142, 130, 172, 201, 143, 71, 173, 1, 74, 64, 4, 175, 77,
+    158, 9, 141, 26, 35, 142, 164, 54, 116, 209, 3, 195, 75, 159, 50, 1,
+    142, 156, 140, 2, 96, 19, 134, 192, 35, 17, 8, 220, 32, 217, 87, 233,
+    70, 16, 173, 71 };
+
+static int cbest_general_m5_k21[105] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 43, 218, 102, 6, 117, 200, 138, 142, 71, 69, 2,
+    10, 143, 251, 216, 3, 132, 153, 70, 1, 8, 172, 158, 108, 17, 174, 1,
+    168, 101, 216, 71, 148, 25, 4, 8, 200, 87, 70, 66, 142, 190, 78, 20,
+    16, 218, 17, 100, 143, 134, 142, 97, 228, 3, 117, 108, 132, 235, 175, 138,
+    32, 110, 70, 4, 3, 1, 8, 72, 16, 4, 141, 158, 35, 216, 138, 12,
+    148, 43, 142, 159, 70, 71, 84, 83, 42 };
+
+static int cbest_general_m5_k22[110] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 142, 175, 117, 226, 33, 49, 24, 1, 200, 190,
+    39, 87, 80, 66, 216, 16, 132, 86, 6, 3, 2, 220, 112, 207, 12, 79,
+    142, 178, 67, 2, 235, 1, 48, 201, 141, 148, 161, 4, 193, 158, 173, 34,
+    10, 27, 68, 238, 136, 1, 34, 2, 239, 106, 51, 37, 234, 3, 142, 164,
+    69, 12, 149, 43, 166, 10, 65, 71, 193, 134, 65, 56, 26, 67, 143, 142,
+    70, 101, 2, 8, 4, 71, 132, 87, 159, 48, 224, 251, 130, 141 };
+
+static int cbest_general_m5_k23[115] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 5, 19, 232, 35, 24, 23, 174, 118, 71,
+    172, 3, 9, 21, 2, 42, 216, 4, 138, 219, 6, 159, 90, 1, 4, 67,
+    157, 33, 96, 2, 3, 142, 82, 71, 200, 201, 16, 233, 108, 173, 218, 179,
+    25, 86, 65, 6, 40, 108, 1, 6, 50, 17, 12, 101, 217, 40, 148, 184,
+    135, 20, 4, 165, 37, 42, 71, 173, 55, 5, 200, 201, 201, 65, 3, 10,
+    168, 134, 48, 2, 69, 76, 173, 71, 154, 150, 67, 169, 83, 142, 86, 1,
+    8, 130, 224 };
+
+static int cbest_general_m5_k24[120] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 24, 216, 5, 20, 35, 2, 203, 71,
+    6, 140, 193, 134, 34, 4, 32, 1, 65, 80, 42, 67, 17, 108, 79, 3,
+    217, 201, 200, 2, 16, 113, 108, 18, 1, 142, 92, 138, 3, 195, 109, 71,
+    134, 220, 70, 143, 69, 48, 101, 100, 100, 190, 8, 15, 158, 174, 10, 65,
+    114, 142, 3, 1, 154, 234, 86, 96, 70, 35, 81, 4, 57, 71, 24, 77,
+    157, 3, 1, 154, 168, 8, 79, 158, 180, 4, 41, 238, 19, 233, 35, 142,
+    37, 68, 70, 171, 143, 135, 43, 2 };
+
+static int cbest_general_m5_k25[125] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 110, 8, 42, 201, 3, 2, 221,
+    77, 43, 1, 216, 9, 170, 4, 18, 69, 51, 242, 100, 149, 17, 143, 71,
+    134, 48, 164, 85, 174, 91, 48, 64, 69, 181, 54, 8, 34, 24, 1, 143,
+    70, 96, 139, 65, 234, 2, 142, 35, 41, 184, 17, 13, 71, 70, 172, 26,
+    184, 134, 197, 3, 110, 32, 173, 38, 135, 19, 143, 33, 142, 1, 4, 232,
+    192, 141, 35, 6, 2, 77, 14, 142, 6, 218, 50, 1, 154, 43, 16, 235,
+    175, 82, 157, 131, 70, 27, 205, 143, 46, 104, 165, 18, 33 };
+
+static int cbest_general_m5_k26[130] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 35, 51, 1, 205, 67, 55,
+    4, 24, 9, 69, 38, 188, 21, 54, 247, 42, 104, 34, 5, 155, 233, 2,
+    142, 227, 70, 180, 35, 1, 96, 201, 34, 134, 142, 172, 108, 156, 173, 71,
+    136, 79, 4, 140, 200, 16, 67, 2, 193, 180, 5, 137, 65, 25, 243, 65,
+    41, 2, 173, 39, 16, 180, 34, 217, 33, 90, 70, 43, 6, 216, 1, 164,
+    50, 68, 86, 74, 169, 158, 64, 138, 158, 96, 79, 69, 154, 1, 170, 131,
+    71, 175, 117, 65, 68, 24, 234, 142, 212, 150, 4, 174, 3, 83, 8, 2,
+    70, 14 };
+
+static int cbest_general_m5_k27[135] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 142, 82, 201, 33, 141,
+    4, 79, 86, 217, 65, 173, 140, 102, 109, 6, 108, 38, 70, 10, 157, 134,
+    75, 11, 2, 200, 67, 1, 2, 69, 71, 10, 84, 201, 239, 1, 19, 8,
+    169, 27, 64, 192, 130, 67, 66, 221, 141, 3, 96, 58, 216, 134, 173, 65,
+    165, 10, 32, 94, 9, 234, 216, 50, 139, 193, 220, 17, 140, 1, 142, 43,
+    3, 21, 100, 68, 33, 2, 192, 65, 225, 134, 75, 87, 47, 158, 200, 168,
+    86, 1, 69, 180, 34, 101, 3, 112, 194, 38, 11, 70, 43, 155, 193, 76,
+    50, 71, 64, 163, 2, 85, 26 };
+
+static int cbest_general_m5_k28[140] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 34, 1, 168, 73,
+    172, 173, 140, 66, 222, 2, 116, 40, 3, 4, 203, 17, 67, 92, 98, 134,
+    167, 9, 131, 188, 151, 6, 43, 234, 197, 167, 171, 2, 87, 193, 19, 116,
+    146, 115, 3, 1, 4, 175, 71, 158, 16, 117, 8, 34, 155, 142, 67, 12,
+    140, 66, 6, 217, 6, 142, 158, 35, 101, 88, 1, 130, 134, 226, 37, 43,
+    200, 155, 216, 138, 3, 197, 131, 9, 16, 132, 21, 67, 5, 2, 65, 10,
+    34, 153, 86, 141, 10, 9, 96, 174, 71, 65, 138, 142, 200, 24, 196, 216,
+    226, 2, 1, 248, 66, 249, 108, 172, 140, 19, 143, 33 };
+
+static int cbest_general_m5_k29[145] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 98, 134, 165,
+    205, 71, 138, 2, 175, 70, 196, 116, 67, 54, 203, 108, 1, 194, 159, 140,
+    3, 156, 68, 234, 34, 86, 45, 20, 40, 66, 206, 236, 40, 142, 194, 58,
+    43, 91, 67, 121, 165, 172, 4, 71, 2, 200, 66, 100, 158, 18, 169, 140,
+    84, 20, 212, 12, 1, 8, 233, 1, 82, 50, 135, 164, 18, 87, 238, 13,
+    142, 143, 67, 129, 217, 70, 158, 117, 9, 115, 235, 35, 134, 200, 41, 26,
+    68, 65, 139, 33, 155, 192, 71, 19, 141, 86, 112, 33, 165, 143, 16, 4,
+    67, 151, 99, 46, 3, 39, 25, 110, 218, 125, 35, 134, 1, 17, 203, 68,
+    201 };
+
+static int cbest_general_m5_k30[150] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 104, 2,
+    33, 35, 130, 17, 87, 142, 10, 8, 34, 135, 220, 32, 67, 16, 110, 43,
+    174, 157, 1, 236, 195, 41, 6, 4, 143, 28, 232, 83, 68, 168, 70, 27,
+    136, 147, 154, 67, 148, 1, 39, 5, 71, 117, 180, 8, 69, 142, 234, 175,
+    158, 143, 165, 10, 225, 146, 64, 4, 32, 200, 140, 26, 35, 18, 64, 67,
+    167, 1, 155, 54, 66, 71, 151, 142, 169, 171, 27, 182, 24, 12, 68, 217,
+    2, 79, 6, 197, 154, 4, 19, 175, 5, 90, 29, 193, 217, 21, 142, 43,
+    16, 156, 2, 216, 136, 132, 100, 158, 8, 71, 24, 67, 235, 10, 35, 70,
+    65, 6, 108, 200, 1, 155 };
+
+static int cbest_general_m5_k31[155] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 6,
+    10, 234, 117, 70, 36, 204, 71, 34, 54, 37, 16, 35, 2, 118, 141, 88,
+    216, 200, 138, 78, 132, 1, 43, 3, 226, 218, 8, 130, 142, 155, 18, 3,
+    164, 4, 21, 27, 25, 193, 69, 35, 67, 5, 140, 172, 17, 102, 34, 173,
+    1, 100, 142, 159, 221, 201, 238, 84, 71, 132, 197, 169, 153, 17, 117, 251,
+    100, 110, 173, 172, 97, 66, 42, 58, 221, 170, 3, 34, 140, 216, 235, 143,
+    134, 178, 138, 70, 20, 175, 1, 16, 4, 33, 142, 2, 51, 67, 70, 169,
+    33, 3, 234, 226, 230, 7, 12, 86, 8, 21, 78, 193, 35, 1, 16, 66,
+    43, 2, 76, 4, 64, 209, 217, 108, 205, 166, 134 };
+
+static int cbest_general_m5_k32[160] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    8, 10, 7, 193, 71, 1, 6, 84, 112, 100, 165, 18, 96, 33, 173, 195,
+    34, 14, 219, 4, 2, 55, 77, 135, 58, 142, 161, 79, 35, 156, 73, 218,
+    25, 8, 50, 142, 204, 167, 192, 140, 173, 134, 234, 1, 75, 143, 79, 52,
+    238, 117, 20, 86, 168, 40, 174, 17, 172, 2, 16, 202, 33, 5, 184, 71,
+    234, 5, 8, 54, 33, 57, 12, 165, 153, 250, 201, 6, 67, 29, 134, 1,
+    173, 4, 135, 16, 2, 142, 20, 51, 64, 77, 176, 140, 69, 169, 71, 164,
+    47, 180, 168, 39, 1, 3, 175, 35, 21, 9, 25, 149, 50, 238, 56, 141,
+    80, 69, 67, 2, 140, 131, 20, 34, 174, 5, 142, 71, 42, 65, 143, 226 };
+
+static int cbest_general_m6_k2[12] = {
+    1, 1, 142, 1, 1, 142, 1, 4, 1, 71, 8, 1 };
+
+static int cbest_general_m6_k3[18] = {
+    1, 1, 1, 1, 158, 4, 71, 1, 140, 2, 1, 33, 5, 1, 71, 70,
+    1, 4 };
+
+static int cbest_general_m6_k4[24] = {
+    1, 1, 1, 1, 217, 9, 1, 2, 35, 1, 18, 2, 4, 201, 71, 2,
+    1, 134, 142, 70, 86, 17, 134, 1 };
+
+static int cbest_general_m6_k5[30] = {
+    1, 1, 1, 1, 1, 142, 134, 174, 4, 1, 217, 142, 140, 1, 39, 69,
+    142, 38, 17, 1, 70, 4, 5, 234, 71, 70, 79, 1, 175, 67 };
+
+static int cbest_general_m6_k6[36] = {
+    1, 1, 1, 1, 1, 1, 1, 4, 158, 65, 142, 8, 140, 70, 173, 224,
+    142, 1, 172, 20, 141, 142, 158, 1, 141, 4, 70, 108, 1, 43, 3, 69,
+    142, 71, 7, 2 };
+
+static int cbest_general_m6_k7[42] = {
+    1, 1, 1, 1, 1, 1, 1, 148, 1, 34, 2, 173, 67, 70, 175, 65,
+    21, 201, 130, 2, 1, 201, 140, 2, 65, 128, 154, 142, 2, 174, 67, 1,
+    39, 143, 54, 10, 43, 1, 69, 17, 216, 2 };
+
+static int cbest_general_m6_k8[48] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 194, 143, 142, 8, 201, 35, 70, 132,
+    8, 90, 4, 159, 1, 2, 142, 35, 182, 4, 17, 1, 226, 143, 18, 173,
+    1, 35, 70, 157, 140, 143, 142, 16, 33, 128, 165, 1, 108, 172, 78, 142 };
+
+static int cbest_general_m6_k9[54] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 2, 141, 226, 69, 20, 35,
+    143, 182, 33, 16, 1, 164, 4, 20, 165, 71, 216, 140, 1, 70, 3, 217,
+    130, 66, 67, 71, 82, 172, 1, 143, 102, 142, 48, 193, 96, 234, 1, 138,
+    67, 8, 207, 2, 195, 205 };
+
+static int cbest_general_m6_k10[60] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 68, 67, 28, 70, 1, 173,
+    232, 20, 142, 140, 218, 193, 142, 8, 16, 33, 10, 21, 1, 2, 173, 71,
+    1, 130, 203, 201, 4, 9, 221, 84, 142, 158, 14, 201, 66, 69, 143, 1,
+    8, 67, 77, 4, 65, 219, 1, 143, 193, 16, 172, 217 };
+
+static int cbest_general_m6_k11[66] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 158, 172, 168, 1, 6,
+    142, 70, 216, 2, 8, 173, 195, 79, 2, 7, 138, 21, 71, 26, 66, 4,
+    1, 1, 3, 141, 4, 85, 84, 70, 35, 96, 43, 110, 142, 21, 140, 70,
+    217, 200, 173, 40, 172, 1, 201, 71, 35, 142, 2, 6, 195, 79, 34, 14,
+    4, 73 };
+
+static int cbest_general_m6_k12[72] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 158, 8, 200, 108,
+    2, 70, 173, 142, 172, 1, 136, 5, 20, 1, 69, 168, 16, 172, 39, 148,
+    143, 192, 70, 216, 10, 4, 55, 1, 67, 70, 17, 5, 118, 117, 158, 68,
+    226, 166, 142, 225, 11, 1, 70, 158, 2, 8, 143, 138, 1, 43, 142, 8,
+    96, 70, 110, 84, 3, 4, 108, 134 };
+
+static int cbest_general_m6_k13[78] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 200, 17, 1,
+    2, 4, 249, 71, 16, 138, 143, 142, 113, 102, 3, 65, 140, 6, 20, 56,
+    194, 167, 17, 216, 1, 70, 169, 2, 70, 217, 220, 109, 1, 195, 142, 3,
+    69, 7, 4, 66, 10, 69, 4, 100, 163, 142, 119, 130, 175, 17, 70, 171,
+    1, 140, 66, 3, 10, 4, 201, 142, 159, 67, 175, 70, 1, 172 };
+
+static int cbest_general_m6_k14[84] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 2, 37,
+    159, 152, 108, 70, 86, 142, 128, 6, 129, 17, 12, 43, 4, 3, 130, 1,
+    108, 6, 71, 26, 43, 192, 102, 100, 134, 58, 22, 238, 40, 20, 54, 1,
+    239, 193, 34, 2, 71, 32, 35, 66, 84, 2, 25, 138, 68, 34, 204, 71,
+    172, 113, 217, 142, 33, 1, 40, 165, 32, 2, 86, 201, 35, 43, 16, 25,
+    1, 143, 38, 96 };
+
+static int cbest_general_m6_k15[90] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    12, 143, 142, 8, 163, 17, 156, 50, 175, 35, 41, 67, 92, 161, 4, 158,
+    130, 75, 192, 1, 70, 86, 182, 2, 35, 134, 150, 108, 172, 40, 151, 35,
+    67, 143, 218, 238, 15, 1, 17, 180, 65, 8, 2, 142, 50, 39, 8, 161,
+    67, 64, 175, 2, 70, 19, 143, 112, 142, 201, 71, 42, 70, 33, 142, 253,
+    12, 195, 3, 232, 1, 26, 175, 24, 132, 180 };
+
+static int cbest_general_m6_k16[96] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    6, 70, 10, 20, 87, 205, 67, 138, 69, 39, 148, 216, 68, 25, 71, 1,
+    141, 204, 33, 2, 8, 71, 3, 70, 154, 6, 226, 9, 35, 142, 139, 1,
+    35, 3, 142, 219, 77, 65, 192, 180, 34, 156, 2, 204, 172, 71, 8, 5,
+    159, 112, 2, 79, 7, 35, 85, 1, 175, 172, 195, 8, 12, 94, 200, 71,
+    140, 172, 141, 3, 4, 97, 175, 110, 165, 17, 1, 67, 170, 142, 128, 70 };
+
+static int cbest_general_m6_k17[102] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 188, 5, 130, 10, 216, 175, 70, 17, 169, 142, 132, 143, 48, 85, 4,
+    1, 91, 174, 6, 151, 35, 140, 87, 27, 20, 143, 130, 78, 134, 5, 34,
+    66, 238, 1, 138, 155, 172, 158, 12, 65, 91, 69, 193, 167, 8, 5, 76,
+    86, 142, 1, 17, 47, 1, 140, 16, 142, 77, 33, 2, 249, 130, 106, 138,
+    200, 3, 65, 73, 71, 142, 9, 227, 6, 116, 140, 143, 5, 175, 201, 8,
+    172, 65, 55, 12, 147, 1 };
+
+static int cbest_general_m6_k18[108] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 254, 43, 141, 142, 19, 143, 226, 172, 70, 37, 180, 224, 33,
+    71, 200, 4, 140, 10, 155, 138, 70, 142, 141, 175, 4, 17, 117, 140, 159,
+    2, 1, 130, 3, 165, 110, 180, 1, 67, 55, 71, 70, 6, 5, 87, 50,
+    132, 68, 143, 35, 158, 217, 20, 56, 4, 201, 175, 158, 113, 108, 141, 83,
+    148, 14, 70, 172, 79, 8, 20, 133, 5, 1, 2, 174, 66, 142, 71, 158,
+    143, 4, 3, 5, 200, 16, 195, 113, 170, 1, 77, 35 };
+
+static int cbest_general_m6_k19[114] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 41, 87, 158, 217, 3, 78, 5, 173, 8, 32, 86, 216, 1,
+    67, 12, 117, 2, 141, 116, 2, 5, 108, 158, 69, 77, 29, 164, 142, 64,
+    101, 67, 71, 54, 86, 1, 200, 66, 87, 117, 87, 156, 35, 148, 1, 217,
+    70, 154, 5, 25, 19, 174, 172, 108, 111, 67, 18, 142, 220, 193, 216, 149,
+    69, 2, 134, 35, 171, 67, 6, 32, 8, 143, 4, 232, 182, 100, 42, 192,
+    17, 16, 2, 201, 92, 159, 218, 168, 164, 33, 226, 173, 96, 205, 8, 1,
+    142, 35 };
+
+static int cbest_general_m6_k20[120] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 116, 2, 236, 138, 142, 1, 35, 113, 98, 201, 9, 71,
+    155, 33, 70, 100, 143, 85, 176, 69, 132, 68, 143, 154, 220, 36, 131, 67,
+    175, 173, 17, 218, 5, 12, 57, 1, 70, 142, 4, 21, 197, 154, 78, 238,
+    4, 180, 10, 8, 173, 3, 42, 142, 132, 195, 70, 2, 171, 69, 25, 143,
+    8, 16, 5, 4, 94, 218, 118, 38, 65, 131, 69, 242, 155, 35, 2, 1,
+    91, 167, 142, 26, 65, 10, 67, 166, 84, 116, 70, 4, 48, 250, 71, 35,
+    1, 164, 233, 216, 140, 226, 16, 165 };
+
+static int cbest_general_m6_k21[126] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 3, 40, 130, 48, 217, 1, 77, 134, 201, 4, 174,
+    10, 113, 138, 71, 41, 66, 254, 2, 155, 142, 47, 1, 200, 33, 34, 138,
+    71, 66, 37, 195, 172, 201, 102, 23, 50, 3, 2, 207, 169, 12, 42, 17,
+    50, 65, 54, 12, 3, 165, 174, 108, 4, 155, 129, 1, 67, 142, 101, 138,
+    8, 10, 20, 70, 20, 227, 234, 69, 19, 142, 180, 86, 48, 132, 71, 173,
+    68, 16, 241, 1, 6, 35, 37, 146, 13, 217, 135, 169, 203, 68, 77, 102,
+    2, 35, 227, 32, 6, 181, 101, 1, 109, 117, 71, 218, 4, 78 };
+
+static int cbest_general_m6_k22[132] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 96, 85, 168, 90, 220, 8, 156, 202, 2, 1,
+    142, 173, 102, 227, 70, 140, 164, 218, 71, 205, 226, 16, 173, 195, 4, 84,
+    1, 8, 79, 175, 132, 14, 42, 2, 75, 6, 142, 10, 58, 73, 148, 138,
+    34, 71, 55, 21, 4, 142, 14, 175, 71, 173, 172, 66, 72, 7, 39, 138,
+    2, 5, 130, 1, 154, 80, 26, 195, 158, 42, 235, 82, 173, 251, 180, 227,
+    20, 137, 2, 74, 4, 32, 69, 35, 200, 5, 33, 172, 85, 165, 175, 71,
+    4, 110, 73, 180, 35, 8, 226, 1, 200, 142, 67, 3, 84, 70, 16, 216,
+    141, 6, 108, 79 };
+
+static int cbest_general_m6_k23[138] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 128, 14, 57, 16, 82, 24, 113, 165, 1,
+    4, 41, 173, 8, 218, 2, 175, 158, 154, 75, 38, 142, 5, 155, 34, 10,
+    100, 76, 3, 226, 173, 134, 90, 110, 16, 67, 1, 87, 217, 234, 140, 27,
+    2, 8, 70, 17, 84, 67, 168, 140, 71, 16, 175, 66, 1, 41, 90, 134,
+    38, 95, 8, 165, 146, 236, 172, 100, 117, 3, 220, 158, 173, 142, 10, 55,
+    175, 96, 76, 2, 16, 200, 75, 24, 113, 4, 249, 1, 70, 35, 108, 8,
+    18, 84, 71, 67, 220, 34, 54, 222, 17, 1, 39, 42, 140, 173, 55, 7,
+    201, 172, 40, 5, 31, 66, 4, 71, 20, 37 };
+
+static int cbest_general_m6_k24[144] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 206, 1, 33, 165, 174, 140, 69, 68,
+    71, 175, 101, 32, 87, 227, 234, 220, 42, 48, 137, 131, 4, 100, 207, 5,
+    143, 79, 83, 195, 1, 113, 65, 3, 4, 66, 8, 71, 226, 142, 69, 2,
+    35, 158, 138, 200, 70, 37, 14, 155, 34, 129, 50, 8, 238, 168, 2, 100,
+    192, 201, 57, 173, 22, 110, 226, 17, 10, 1, 19, 140, 90, 6, 79, 234,
+    108, 22, 158, 104, 70, 35, 155, 175, 10, 131, 4, 97, 1, 142, 228, 3,
+    170, 84, 134, 143, 110, 58, 5, 2, 217, 42, 155, 1, 143, 142, 158, 134,
+    2, 69, 224, 71, 104, 35, 67, 5, 55, 200, 175, 70, 132, 172, 3, 10 };
+
+static int cbest_general_m6_k25[150] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 39, 66, 16, 143, 146, 110, 142,
+    8, 20, 21, 4, 158, 155, 49, 3, 12, 70, 216, 117, 140, 10, 1, 175,
+    67, 6, 106, 17, 109, 100, 68, 35, 71, 254, 155, 70, 4, 167, 174, 207,
+    1, 217, 142, 44, 5, 200, 2, 113, 143, 138, 14, 19, 128, 117, 80, 173,
+    71, 158, 8, 140, 217, 1, 70, 142, 35, 225, 6, 172, 100, 192, 236, 20,
+    168, 180, 16, 238, 67, 38, 217, 147, 142, 37, 239, 2, 140, 86, 141, 173,
+    132, 174, 9, 69, 169, 17, 4, 5, 168, 1, 48, 216, 3, 2, 173, 67,
+    69, 51, 64, 8, 119, 11, 16, 171, 50, 207, 172, 54, 98, 128, 35, 85,
+    134, 240, 182, 143, 79, 4 };
+
+static int cbest_general_m6_k26[156] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 34, 38, 90, 172, 8, 155,
+    86, 77, 4, 174, 65, 43, 224, 69, 134, 136, 45, 158, 247, 142, 25, 51,
+    1, 24, 170, 96, 221, 138, 67, 235, 10, 131, 64, 6, 134, 4, 142, 110,
+    65, 143, 33, 232, 3, 70, 197, 5, 66, 43, 17, 158, 1, 2, 8, 66,
+    138, 108, 2, 33, 150, 14, 69, 4, 71, 35, 130, 100, 65, 42, 1, 142,
+    140, 7, 17, 83, 3, 167, 113, 195, 8, 216, 172, 136, 33, 1, 35, 34,
+    71, 23, 153, 87, 143, 78, 215, 6, 226, 227, 2, 140, 237, 142, 48, 86,
+    96, 19, 2, 174, 156, 24, 182, 221, 40, 132, 51, 239, 9, 8, 65, 20,
+    67, 35, 173, 187, 71, 79, 172, 76, 50, 4, 197, 96 };
+
+static int cbest_general_m6_k27[162] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 100, 217, 180, 142, 200,
+    48, 201, 190, 4, 143, 18, 71, 42, 70, 232, 5, 66, 2, 1, 40, 3,
+    69, 16, 65, 64, 155, 113, 1, 192, 20, 2, 142, 205, 143, 65, 137, 219,
+    79, 71, 140, 35, 164, 220, 100, 77, 90, 97, 135, 201, 84, 81, 8, 66,
+    4, 143, 12, 100, 70, 140, 54, 108, 19, 4, 175, 173, 142, 232, 21, 135,
+    117, 138, 10, 3, 50, 17, 134, 159, 33, 153, 20, 1, 8, 4, 142, 72,
+    39, 82, 70, 67, 241, 1, 132, 101, 136, 217, 2, 190, 208, 121, 43, 12,
+    153, 172, 45, 216, 24, 138, 227, 238, 66, 46, 223, 3, 79, 143, 71, 70,
+    193, 35, 219, 1, 2, 32, 16, 18, 76, 179, 142, 150, 6, 200, 86, 58,
+    34, 93 };
+
+static int cbest_general_m6_k28[168] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 244, 113, 101, 36,
+    1, 155, 9, 154, 138, 205, 66, 142, 10, 17, 54, 65, 160, 102, 212, 8,
+    4, 67, 117, 143, 158, 2, 201, 71, 101, 70, 172, 71, 140, 4, 134, 87,
+    17, 19, 27, 1, 234, 65, 84, 43, 150, 169, 78, 8, 20, 188, 200, 216,
+    168, 6, 176, 194, 1, 21, 86, 138, 113, 3, 117, 6, 12, 99, 135, 141,
+    134, 34, 70, 221, 8, 17, 16, 235, 198, 29, 173, 142, 9, 105, 200, 71,
+    24, 220, 172, 143, 1, 175, 150, 243, 43, 2, 101, 37, 16, 11, 216, 232,
+    6, 140, 142, 76, 219, 70, 79, 213, 90, 52, 200, 66, 69, 47, 114, 234,
+    21, 216, 143, 70, 255, 35, 16, 218, 140, 96, 28, 17, 172, 157, 20, 1,
+    173, 2, 24, 10, 193, 85, 8, 226 };
+
+static int cbest_general_m6_k29[174] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 173, 216, 4,
+    89, 204, 100, 155, 78, 142, 136, 235, 17, 1, 140, 180, 123, 11, 201, 86,
+    132, 175, 68, 5, 12, 67, 36, 33, 82, 94, 1, 174, 138, 249, 42, 8,
+    134, 2, 64, 65, 70, 113, 78, 136, 130, 71, 195, 35, 48, 59, 67, 142,
+    3, 201, 7, 193, 4, 158, 18, 3, 155, 67, 201, 232, 221, 174, 10, 153,
+    33, 21, 1, 41, 204, 65, 142, 2, 110, 54, 34, 111, 70, 17, 108, 5,
+    136, 4, 141, 173, 192, 48, 25, 1, 175, 51, 224, 14, 5, 40, 133, 174,
+    180, 59, 32, 8, 34, 139, 112, 216, 27, 83, 109, 17, 218, 35, 3, 77,
+    158, 67, 6, 17, 2, 12, 5, 16, 38, 178, 143, 35, 159, 162, 71, 171,
+    212, 1, 110, 13, 86, 108, 207, 243, 167, 66, 64, 25, 140, 21 };
+
+static int cbest_general_m6_k30[180] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 101, 4,
+    1, 34, 130, 109, 172, 108, 139, 146, 168, 154, 215, 69, 35, 225, 173, 141,
+    142, 117, 195, 3, 24, 116, 131, 39, 8, 66, 77, 67, 193, 96, 98, 4,
+    18, 67, 200, 216, 1, 35, 6, 173, 143, 17, 58, 8, 172, 248, 182, 226,
+    2, 203, 128, 43, 142, 34, 157, 79, 44, 27, 165, 38, 12, 6, 26, 16,
+    37, 79, 121, 216, 43, 66, 175, 11, 157, 142, 49, 69, 1, 116, 39, 86,
+    70, 172, 24, 217, 194, 67, 15, 45, 12, 24, 197, 180, 1, 129, 181, 109,
+    35, 227, 36, 70, 4, 8, 239, 74, 204, 34, 16, 2, 218, 217, 50, 3,
+    42, 173, 172, 178, 134, 138, 155, 232, 43, 168, 132, 102, 142, 218, 1, 156,
+    205, 21, 201, 78, 35, 202, 143, 67, 160, 2, 45, 9, 4, 33, 173, 59,
+    34, 16, 3, 130 };
+
+static int cbest_general_m6_k31[186] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 8,
+    66, 116, 48, 35, 154, 78, 16, 143, 3, 40, 68, 70, 140, 172, 175, 222,
+    54, 134, 34, 136, 165, 239, 99, 142, 118, 220, 1, 24, 22, 45, 84, 180,
+    142, 140, 250, 86, 196, 174, 10, 24, 227, 153, 71, 17, 12, 33, 216, 1,
+    164, 78, 75, 200, 172, 108, 137, 96, 193, 226, 166, 6, 77, 159, 1, 67,
+    184, 42, 174, 71, 34, 18, 173, 106, 98, 116, 68, 69, 12, 87, 90, 224,
+    193, 170, 70, 40, 172, 64, 235, 84, 217, 4, 165, 216, 97, 175, 86, 10,
+    192, 33, 173, 25, 202, 43, 140, 1, 17, 248, 156, 20, 9, 27, 227, 3,
+    143, 141, 134, 42, 142, 2, 96, 6, 35, 205, 168, 233, 129, 170, 117, 154,
+    43, 142, 112, 8, 98, 70, 1, 165, 217, 35, 148, 203, 134, 3, 44, 172,
+    158, 136, 32, 200, 226, 175, 187, 58, 6, 4 };
+
+static int cbest_general_m6_k32[192] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    48, 107, 22, 250, 14, 218, 201, 3, 71, 4, 1, 200, 142, 180, 12, 17,
+    134, 5, 67, 132, 69, 65, 241, 143, 8, 216, 56, 16, 70, 138, 251, 35,
+    19, 75, 134, 58, 1, 172, 8, 153, 2, 227, 131, 175, 32, 174, 176, 108,
+    76, 82, 6, 5, 7, 65, 77, 234, 140, 66, 201, 83, 4, 218, 33, 16,
+    173, 140, 233, 3, 228, 11, 149, 9, 42, 8, 132, 144, 14, 67, 200, 134,
+    40, 165, 78, 55, 43, 197, 35, 161, 71, 2, 131, 25, 10, 212, 100, 142,
+    216, 1, 67, 234, 24, 117, 173, 68, 2, 16, 12, 10, 5, 141, 207, 21,
+    130, 201, 161, 27, 34, 132, 169, 134, 83, 219, 235, 70, 84, 17, 87, 165,
+    41, 226, 48, 2, 164, 158, 152, 87, 216, 150, 190, 1, 101, 134, 143, 65,
+    169, 96, 234, 70, 71, 219, 35, 4, 78, 200, 5, 36, 142, 168, 8, 84 };
+
+static int *cbest_general_m3[33] = {
+    NULL, NULL, cbest_general_m3_k2, cbest_general_m3_k3, cbest_general_m3_k4,
+    cbest_general_m3_k5, cbest_general_m3_k6, cbest_general_m3_k7, cbest_general_m3_k8,
+    cbest_general_m3_k9, cbest_general_m3_k10, cbest_general_m3_k11, cbest_general_m3_k12,
+    cbest_general_m3_k13, cbest_general_m3_k14, cbest_general_m3_k15, cbest_general_m3_k16,
+    cbest_general_m3_k17, cbest_general_m3_k18, cbest_general_m3_k19, cbest_general_m3_k20,
+    cbest_general_m3_k21, cbest_general_m3_k22, cbest_general_m3_k23, cbest_general_m3_k24,
+    cbest_general_m3_k25, cbest_general_m3_k26, cbest_general_m3_k27, cbest_general_m3_k28,
+    cbest_general_m3_k29, cbest_general_m3_k30, cbest_general_m3_k31, cbest_general_m3_k32 };
+
+static int *cbest_general_m4[33] = {
+    NULL, NULL, cbest_general_m4_k2, cbest_general_m4_k3, cbest_general_m4_k4,
+    cbest_general_m4_k5, cbest_general_m4_k6, cbest_general_m4_k7, cbest_general_m4_k8,
+    cbest_general_m4_k9, cbest_general_m4_k10, cbest_general_m4_k11, cbest_general_m4_k12,
+    cbest_general_m4_k13, cbest_general_m4_k14, cbest_general_m4_k15, cbest_general_m4_k16,
+    cbest_general_m4_k17, cbest_general_m4_k18, cbest_general_m4_k19, cbest_general_m4_k20,
+    cbest_general_m4_k21, cbest_general_m4_k22, cbest_general_m4_k23, cbest_general_m4_k24,
+    cbest_general_m4_k25, cbest_general_m4_k26, cbest_general_m4_k27, cbest_general_m4_k28,
+    cbest_general_m4_k29, cbest_general_m4_k30, cbest_general_m4_k31, cbest_general_m4_k32 };
+
+static int *cbest_general_m5[33] = {
+    NULL, NULL, cbest_general_m5_k2, cbest_general_m5_k3, cbest_general_m5_k4,
+    cbest_general_m5_k5, cbest_general_m5_k6, cbest_general_m5_k7, cbest_general_m5_k8,
+    cbest_general_m5_k9, cbest_general_m5_k10, cbest_general_m5_k11, cbest_general_m5_k12,
+    cbest_general_m5_k13, cbest_general_m5_k14, cbest_general_m5_k15, cbest_general_m5_k16,
+    cbest_general_m5_k17, cbest_general_m5_k18, cbest_general_m5_k19, cbest_general_m5_k20,
+    cbest_general_m5_k21, cbest_general_m5_k22, cbest_general_m5_k23, cbest_general_m5_k24,
+    cbest_general_m5_k25, cbest_general_m5_k26, cbest_general_m5_k27, cbest_general_m5_k28,
+    cbest_general_m5_k29, cbest_general_m5_k30, cbest_general_m5_k31, cbest_general_m5_k32 };
+
+static int *cbest_general_m6[33] = {
+    NULL, NULL, cbest_general_m6_k2, cbest_general_m6_k3, cbest_general_m6_k4,
+    cbest_general_m6_k5, cbest_general_m6_k6, cbest_general_m6_k7, cbest_general_m6_k8,
+    cbest_general_m6_k9, cbest_general_m6_k10, cbest_general_m6_k11, cbest_general_m6_k12,
+    cbest_general_m6_k13, cbest_general_m6_k14, cbest_general_m6_k15, cbest_general_m6_k16,
+    cbest_general_m6_k17, cbest_general_m6_k18, cbest_general_m6_k19, cbest_general_m6_k20,
+    cbest_general_m6_k21, cbest_general_m6_k22, cbest_general_m6_k23, cbest_general_m6_k24,
+    cbest_general_m6_k25, cbest_general_m6_k26, cbest_general_m6_k27, cbest_general_m6_k28,
+    cbest_general_m6_k29, cbest_general_m6_k30, cbest_general_m6_k31, cbest_general_m6_k32 };
+
+int cauchy_best_general_w = 8;
+int cauchy_best_general_max_m = 6;
+int cauchy_best_general_max_k = 32;
+int **cauchy_best_general[7] = { NULL, NULL, NULL,
+    cbest_general_m3,
+    cbest_general_m4,
+    cbest_general_m5,
+    cbest_general_m6 };
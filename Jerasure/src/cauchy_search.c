@@ -0,0 +1,289 @@
+/* cauchy_search.c
+
+Jerasure - A C/C++ Library for a Variety of Reed-Solomon and RAID-6 Erasure Coding Techniques
+
+Copyright (c) 2026, the NCCloud contributors
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+ - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+ - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in
+   the documentation and/or other materials provided with the
+   distribution.
+
+ - Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived
+   from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY
+WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+
+
+ */
+
+/* Offline search for Cauchy coding matrices with few ones (or few
+   XORs in their smart schedule) for m > 2.  The output is a C file
+   in the style of cauchy_best_r6.c, which is compiled into the library
+   as cauchy_best_general.c and used by cauchy_good_general_coding_matrix().
+
+   The search is a randomized local search over the X and Y sets of
+   the Cauchy matrix 1/(X[i]^Y[j]).  Each candidate is normalized so
+   that row 0 is all ones, and every other row is multiplied by the
+   element of GF(2^w) that minimizes its number of ones.  Neither
+   step changes the fact that every square submatrix is invertible,
+   so every candidate is MDS.  The starting point of every (k,m) is
+   the matrix that cauchy_good_general_coding_matrix() would have
+   produced, so the result is never worse than the old heuristic. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "galois.h"
+#include "jerasure.h"
+#include "cauchy.h"
+
+#define talloc(type, num) (type *) malloc(sizeof(type)*(num))
+
+#define CS_MAXW 8
+#define CS_MAXF (1 << CS_MAXW)
+
+static int W, F;
+static int Ones[CS_MAXF];
+static int Mult[CS_MAXF][CS_MAXF];
+static int Inv[CS_MAXF];
+static int Use_xors;
+
+void usage(char *s)
+{
+  fprintf(stderr, "usage: cauchy_search w min_m max_m max_k iterations seed ones|xors\n");
+  fprintf(stderr, "       \n");
+  fprintf(stderr, "       Searches for Cauchy coding matrices in GF(2^w) with few ones (ones)\n");
+  fprintf(stderr, "       or few XORs in their smart schedule (xors) for every\n");
+  fprintf(stderr, "       min_m <= m <= max_m and 2 <= k <= max_k.  The tables are\n");
+  fprintf(stderr, "       printed on standard output as C code for cauchy_best_general.c;\n");
+  fprintf(stderr, "       progress goes to standard error.\n");
+  fprintf(stderr, "       \n");
+  fprintf(stderr, "       w must be between 2 and %d.  m must be greater than 2.\n", CS_MAXW);
+  if (s != NULL) fprintf(stderr, "%s\n", s);
+  exit(1);
+}
+
+/* Builds the normalized matrix for the given X and Y and returns its cost.
+   Row 0 is all ones; each other row gets the multiplier with the fewest ones. */
+
+static int cs_build(int k, int m, int *X, int *Y, int *matrix)
+{
+  int i, j, s, best, bests, no;
+  int *row, *bitmatrix, **schedule;
+
+  for (j = 0; j < k; j++) {
+    matrix[j] = 1;
+    s = X[0]^Y[j];     /* 1/matrix[0][j] */
+    for (i = 1; i < m; i++) {
+      matrix[i*k+j] = Mult[Inv[X[i]^Y[j]]][s];
+    }
+  }
+
+  no = k * W;
+  for (i = 1; i < m; i++) {
+    row = matrix + i*k;
+    best = -1;
+    bests = 1;
+    for (s = 1; s < F; s++) {
+      int tno = 0;
+      for (j = 0; j < k && (best < 0 || tno < best); j++) tno += Ones[Mult[row[j]][s]];
+      if (best < 0 || tno < best) {
+        best = tno;
+        bests = s;
+      }
+    }
+    for (j = 0; j < k; j++) row[j] = Mult[row[j]][bests];
+    no += best;
+  }
+
+  if (!Use_xors) return no;
+
+  bitmatrix = jerasure_matrix_to_bitmatrix(k, m, W, matrix);
+  schedule = jerasure_smart_bitmatrix_to_schedule(k, m, W, bitmatrix);
+  for (no = 0; schedule[no][0] != -1; no++) ;
+  jerasure_free_schedule(schedule);
+  free(bitmatrix);
+  return no;
+}
+
+/* Cost of the matrix produced by cauchy_good_general_coding_matrix(). */
+
+static int cs_cost(int k, int m, int *matrix)
+{
+  int i, no;
+  int *bitmatrix, **schedule;
+
+  if (!Use_xors) {
+    no = 0;
+    for (i = 0; i < k*m; i++) no += Ones[matrix[i]];
+    return no;
+  }
+  bitmatrix = jerasure_matrix_to_bitmatrix(k, m, W, matrix);
+  schedule = jerasure_smart_bitmatrix_to_schedule(k, m, W, bitmatrix);
+  for (no = 0; schedule[no][0] != -1; no++) ;
+  jerasure_free_schedule(schedule);
+  free(bitmatrix);
+  return no;
+}
+
+static void cs_print(int k, int m, int *matrix)
+{
+  int i;
+
+  printf("static int cbest_general_m%d_k%d[%d] = {", m, k, k*m);
+  for (i = 0; i < k*m; i++) {
+    if (i % 16 == 0) printf("\n   ");
+    printf(" %d%s", matrix[i], (i == k*m-1) ? "" : ",");
+  }
+  printf(" };\n\n");
+}
+
+int main(int argc, char **argv)
+{
+  int min_m, max_m, max_k, iterations, seed;
+  int k, m, i, j, it, pos, e, old;
+  int cost, bcost, ocost, tcost;
+  int *X, *Y, *used;
+  int *matrix, *best, *orig;
+
+  if (argc != 8) usage(NULL);
+  if (sscanf(argv[1], "%d", &W) == 0 || W < 2 || W > CS_MAXW) usage("Bad w");
+  if (sscanf(argv[2], "%d", &min_m) == 0 || min_m < 3) usage("Bad min_m");
+  if (sscanf(argv[3], "%d", &max_m) == 0 || max_m < min_m) usage("Bad max_m");
+  if (sscanf(argv[4], "%d", &max_k) == 0 || max_k < 2) usage("Bad max_k");
+  if (sscanf(argv[5], "%d", &iterations) == 0 || iterations < 0) usage("Bad iterations");
+  if (sscanf(argv[6], "%d", &seed) == 0) usage("Bad seed");
+  if (strcmp(argv[7], "ones") == 0) {
+    Use_xors = 0;
+  } else if (strcmp(argv[7], "xors") == 0) {
+    Use_xors = 1;
+  } else {
+    usage("Bad metric");
+  }
+  F = (1 << W);
+  if (max_m + max_k > F) usage("max_m + max_k must be at most 2^w");
+  srand48(seed);
+
+  for (i = 0; i < F; i++) {
+    Ones[i] = (i == 0) ? 0 : cauchy_n_ones(i, W);
+    Inv[i] = (i == 0) ? 0 : galois_single_divide(1, i, W);
+    for (j = 0; j < F; j++) Mult[i][j] = galois_single_multiply(i, j, W);
+  }
+
+  X = talloc(int, max_m);
+  Y = talloc(int, max_k);
+  used = talloc(int, F);
+  matrix = talloc(int, max_m*max_k);
+  best = talloc(int, max_m*max_k);
+
+  printf("/* cauchy_best_general.c\n");
+  printf(" * Generated by: cauchy_search %s %s %s %s %s %s %s\n",
+         argv[1], argv[2], argv[3], argv[4], argv[5], argv[6], argv[7]);
+  printf(" * Do not edit -- rerun \"make cauchy_tables\" instead. */\n\n");
+  printf("#include <stdio.h>\n\n");
+
+  for (m = min_m; m <= max_m; m++) {
+    for (k = 2; k <= max_k; k++) {
+
+      /* Start from what cauchy_good_general_coding_matrix() would do. */
+
+      for (i = 0; i < m; i++) X[i] = i;
+      for (j = 0; j < k; j++) Y[j] = m+j;
+      orig = cauchy_original_coding_matrix(k, m, W);
+      cauchy_improve_coding_matrix(k, m, W, orig);
+      ocost = cs_cost(k, m, orig);
+
+      /* cost is that of the current X and Y, bcost that of the matrix in best,
+         which is the heuristic's matrix if it beats the one X and Y give. */
+
+      cost = cs_build(k, m, X, Y, best);
+      bcost = cost;
+      if (bcost > ocost) {
+        memcpy(best, orig, sizeof(int)*k*m);
+        bcost = ocost;
+      }
+
+      /* Local search: swap one element of X or Y for an unused one,
+         keeping the change unless it makes things worse. */
+
+      memset(used, 0, sizeof(int)*F);
+      for (i = 0; i < m; i++) used[X[i]] = 1;
+      for (j = 0; j < k; j++) used[Y[j]] = 1;
+
+      for (it = 0; it < iterations; it++) {
+        pos = lrand48() % (k+m);
+        do e = lrand48() % F; while (used[e]);
+        if (pos < m) {
+          old = X[pos];
+          X[pos] = e;
+        } else {
+          old = Y[pos-m];
+          Y[pos-m] = e;
+        }
+        tcost = cs_build(k, m, X, Y, matrix);
+        if (tcost <= cost) {
+          used[old] = 0;
+          used[e] = 1;
+          cost = tcost;
+          if (cost < bcost) {
+            bcost = cost;
+            memcpy(best, matrix, sizeof(int)*k*m);
+          }
+        } else if (pos < m) {
+          X[pos] = old;
+        } else {
+          Y[pos-m] = old;
+        }
+      }
+
+      fprintf(stderr, "m=%d k=%2d %s: heuristic %d best %d\n", m, k, argv[7], ocost, bcost);
+      cs_print(k, m, best);
+      free(orig);
+    }
+  }
+
+  for (m = min_m; m <= max_m; m++) {
+    printf("static int *cbest_general_m%d[%d] = {\n    NULL, NULL", m, max_k+1);
+    for (k = 2; k <= max_k; k++) {
+      printf(",%s cbest_general_m%d_k%d", (k % 4 == 1) ? "\n   " : "", m, k);
+    }
+    printf(" };\n\n");
+  }
+
+  printf("int cauchy_best_general_w = %d;\n", W);
+  printf("int cauchy_best_general_max_m = %d;\n", max_m);
+  printf("int cauchy_best_general_max_k = %d;\n", max_k);
+  printf("int **cauchy_best_general[%d] = {", max_m+1);
+  for (m = 0; m <= max_m; m++) {
+    if (m < min_m) {
+      printf(" NULL,");
+    } else {
+      printf("\n    cbest_general_m%d%s", m, (m == max_m) ? "" : ",");
+    }
+  }
+  printf(" };\n");
+
+  return 0;
+}
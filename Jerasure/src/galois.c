@@ -46,6 +46,7 @@ POSSIBILITY OF SUCH DAMAGE.
 
  */
 
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -162,47 +163,70 @@ NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL };
 
 static int *galois_split_w8[7] = { NULL, NULL, NULL, NULL, NULL, NULL, NULL };
 
-int galois_create_log_tables(int w)
+/* The tables above are built at most once per process.  Builders hold
+   galois_tables_lock, fill the tables through local pointers and only then
+   publish them, so a thread that sees a non-NULL table pointer always sees
+   a complete table.  The w=8 and w=16 tables, which are the ones used by
+   the region multiply routines, are built when the library is loaded. */
+
+static pthread_mutex_t galois_tables_lock = PTHREAD_MUTEX_INITIALIZER;
+
+#define galois_table_ready(table) (__atomic_load_n(&(table), __ATOMIC_ACQUIRE) != NULL)
+#define galois_table_publish(table, value) __atomic_store_n(&(table), (value), __ATOMIC_RELEASE)
+
+static int galois_create_log_tables_locked(int w)
 {
   int j, b;
+  int *log_table, *ilog_table;
 
-  if (w > 30) return -1;
   if (galois_log_tables[w] != NULL) return 0;
-  galois_log_tables[w] = (int *) malloc(sizeof(int)*nw[w]);
-  if (galois_log_tables[w] == NULL) return -1; 
+  log_table = (int *) malloc(sizeof(int)*nw[w]);
+  if (log_table == NULL) return -1; 
   
-  galois_ilog_tables[w] = (int *) malloc(sizeof(int)*nw[w]*3);
-  if (galois_ilog_tables[w] == NULL) { 
-    free(galois_log_tables[w]);
-    galois_log_tables[w] = NULL;
+  ilog_table = (int *) malloc(sizeof(int)*nw[w]*3);
+  if (ilog_table == NULL) { 
+    free(log_table);
     return -1;
   }
   
   for (j = 0; j < nw[w]; j++) {
-    galois_log_tables[w][j] = nwm1[w];
-    galois_ilog_tables[w][j] = 0;
+    log_table[j] = nwm1[w];
+    ilog_table[j] = 0;
   } 
   
   b = 1;
   for (j = 0; j < nwm1[w]; j++) {
-    if (galois_log_tables[w][b] != nwm1[w]) {
+    if (log_table[b] != nwm1[w]) {
       fprintf(stderr, "Galois_create_log_tables Error: j=%d, b=%d, B->J[b]=%d, J->B[j]=%d (0%o)\n",
-              j, b, galois_log_tables[w][b], galois_ilog_tables[w][j], (b << 1) ^ prim_poly[w]);
+              j, b, log_table[b], ilog_table[j], (b << 1) ^ prim_poly[w]);
       exit(1);
     }
-    galois_log_tables[w][b] = j;
-    galois_ilog_tables[w][j] = b;
+    log_table[b] = j;
+    ilog_table[j] = b;
     b = b << 1;
     if (b & nw[w]) b = (b ^ prim_poly[w]) & nwm1[w];
   }
   for (j = 0; j < nwm1[w]; j++) {
-    galois_ilog_tables[w][j+nwm1[w]] = galois_ilog_tables[w][j];
-    galois_ilog_tables[w][j+nwm1[w]*2] = galois_ilog_tables[w][j];
+    ilog_table[j+nwm1[w]] = ilog_table[j];
+    ilog_table[j+nwm1[w]*2] = ilog_table[j];
   } 
-  galois_ilog_tables[w] += nwm1[w];
+  galois_table_publish(galois_ilog_tables[w], ilog_table + nwm1[w]);
+  galois_table_publish(galois_log_tables[w], log_table);
   return 0;
 }
 
+int galois_create_log_tables(int w)
+{
+  int rv;
+
+  if (w > 30) return -1;
+  if (galois_table_ready(galois_log_tables[w])) return 0;
+  pthread_mutex_lock(&galois_tables_lock);
+  rv = galois_create_log_tables_locked(w);
+  pthread_mutex_unlock(&galois_tables_lock);
+  return rv;
+}
+
 int galois_logtable_multiply(int x, int y, int w)
 {
   int sum_j;
@@ -228,60 +252,68 @@ int galois_logtable_divide(int x, int y, int w)
   return z;
 }
 
-int galois_create_mult_tables(int w)
+static int galois_create_mult_tables_locked(int w)
 {
   int j, x, y, logx;
-
-  if (w >= 14) return -1;
+  int *mult_table, *div_table;
 
   if (galois_mult_tables[w] != NULL) return 0;
-  galois_mult_tables[w] = (int *) malloc(sizeof(int) * nw[w] * nw[w]);
-  if (galois_mult_tables[w] == NULL) return -1;
+  mult_table = (int *) malloc(sizeof(int) * nw[w] * nw[w]);
+  if (mult_table == NULL) return -1;
   
-  galois_div_tables[w] = (int *) malloc(sizeof(int) * nw[w] * nw[w]);
-  if (galois_div_tables[w] == NULL) {
-    free(galois_mult_tables[w]);
-    galois_mult_tables[w] = NULL;
+  div_table = (int *) malloc(sizeof(int) * nw[w] * nw[w]);
+  if (div_table == NULL) {
+    free(mult_table);
     return -1;
   }
-  if (galois_log_tables[w] == NULL) {
-    if (galois_create_log_tables(w) < 0) {
-      free(galois_mult_tables[w]);
-      free(galois_div_tables[w]);
-      galois_mult_tables[w] = NULL;
-      galois_div_tables[w] = NULL;
-      return -1;
-    }
+  if (galois_create_log_tables_locked(w) < 0) {
+    free(mult_table);
+    free(div_table);
+    return -1;
   }
 
  /* Set mult/div tables for x = 0 */
   j = 0;
-  galois_mult_tables[w][j] = 0;   /* y = 0 */
-  galois_div_tables[w][j] = -1;
+  mult_table[j] = 0;   /* y = 0 */
+  div_table[j] = -1;
   j++;
   for (y = 1; y < nw[w]; y++) {   /* y > 0 */
-    galois_mult_tables[w][j] = 0;
-    galois_div_tables[w][j] = 0;
+    mult_table[j] = 0;
+    div_table[j] = 0;
     j++;
   }
   
   for (x = 1; x < nw[w]; x++) {  /* x > 0 */
-    galois_mult_tables[w][j] = 0; /* y = 0 */
-    galois_div_tables[w][j] = -1;
+    mult_table[j] = 0; /* y = 0 */
+    div_table[j] = -1;
     j++;
     logx = galois_log_tables[w][x];
     for (y = 1; y < nw[w]; y++) {  /* y > 0 */
-      galois_mult_tables[w][j] = galois_ilog_tables[w][logx+galois_log_tables[w][y]]; 
-      galois_div_tables[w][j] = galois_ilog_tables[w][logx-galois_log_tables[w][y]]; 
+      mult_table[j] = galois_ilog_tables[w][logx+galois_log_tables[w][y]]; 
+      div_table[j] = galois_ilog_tables[w][logx-galois_log_tables[w][y]]; 
       j++;
     }
   }
+  galois_table_publish(galois_div_tables[w], div_table);
+  galois_table_publish(galois_mult_tables[w], mult_table);
   return 0;
 }
 
+int galois_create_mult_tables(int w)
+{
+  int rv;
+
+  if (w >= 14) return -1;
+  if (galois_table_ready(galois_mult_tables[w])) return 0;
+  pthread_mutex_lock(&galois_tables_lock);
+  rv = galois_create_mult_tables_locked(w);
+  pthread_mutex_unlock(&galois_tables_lock);
+  return rv;
+}
+
 int galois_ilog(int value, int w)
 {
-  if (galois_ilog_tables[w] == NULL) {
+  if (!galois_table_ready(galois_ilog_tables[w])) {
     if (galois_create_log_tables(w) < 0) {
       fprintf(stderr, "Error: galois_ilog - w is too big.  Sorry\n");
       exit(1);
@@ -292,7 +324,7 @@ int galois_ilog(int value, int w)
 
 int galois_log(int value, int w)
 {
-  if (galois_log_tables[w] == NULL) {
+  if (!galois_table_ready(galois_log_tables[w])) {
     if (galois_create_log_tables(w) < 0) {
       fprintf(stderr, "Error: galois_log - w is too big.  Sorry\n");
       exit(1);
@@ -340,7 +372,7 @@ int galois_single_multiply(int x, int y, int w)
   if (x == 0 || y == 0) return 0;
   
   if (mult_type[w] == TABLE) {
-    if (galois_mult_tables[w] == NULL) {
+    if (!galois_table_ready(galois_mult_tables[w])) {
       if (galois_create_mult_tables(w) < 0) {
         fprintf(stderr, "ERROR -- cannot make multiplication tables for w=%d\n", w);
         exit(1);
@@ -348,7 +380,7 @@ int galois_single_multiply(int x, int y, int w)
     }
     return galois_mult_tables[w][(x<<w)|y];
   } else if (mult_type[w] == LOGS) {
-    if (galois_log_tables[w] == NULL) {
+    if (!galois_table_ready(galois_log_tables[w])) {
       if (galois_create_log_tables(w) < 0) {
         fprintf(stderr, "ERROR -- cannot make log tables for w=%d\n", w);
         exit(1);
@@ -358,7 +390,7 @@ int galois_single_multiply(int x, int y, int w)
     z = galois_ilog_tables[w][sum_j];
     return z;
   } else if (mult_type[w] == SPLITW8) {
-    if (galois_split_w8[0] == NULL) {
+    if (!galois_table_ready(galois_split_w8[0])) {
       if (galois_create_split_w8_tables() < 0) {
         fprintf(stderr, "ERROR -- cannot make log split_w8_tables for w=%d\n", w);
         exit(1);
@@ -382,7 +414,7 @@ int galois_single_divide(int a, int b, int w)
   int sum_j;
 
   if (mult_type[w] == TABLE) {
-    if (galois_div_tables[w] == NULL) {
+    if (!galois_table_ready(galois_div_tables[w])) {
       if (galois_create_mult_tables(w) < 0) {
         fprintf(stderr, "ERROR -- cannot make multiplication tables for w=%d\n", w);
         exit(1);
@@ -392,7 +424,7 @@ int galois_single_divide(int a, int b, int w)
   } else if (mult_type[w] == LOGS) {
     if (b == 0) return -1;
     if (a == 0) return 0;
-    if (galois_log_tables[w] == NULL) {
+    if (!galois_table_ready(galois_log_tables[w])) {
       if (galois_create_log_tables(w) < 0) {
         fprintf(stderr, "ERROR -- cannot make log tables for w=%d\n", w);
         exit(1);
@@ -451,7 +483,7 @@ void galois_w08_region_multiply(char *region,      /* Region to multiply */
   }
  */
 
-  if (galois_mult_tables[8] == NULL) {
+  if (!galois_table_ready(galois_mult_tables[8])) {
     if (galois_create_mult_tables(8) < 0) {
       fprintf(stderr, "galois_08_region_multiply -- couldn't make multiplication tables\n");
       exit(1);
@@ -520,7 +552,7 @@ void galois_w16_region_multiply(char *region,      /* Region to multiply */
     return;
   }
     
-  if (galois_log_tables[16] == NULL) {
+  if (!galois_table_ready(galois_log_tables[16])) {
     if (galois_create_log_tables(16) < 0) {
       fprintf(stderr, "galois_16_region_multiply -- couldn't make log tables\n");
       exit(1);
@@ -640,7 +672,7 @@ int galois_shift_inverse(int y, int w)
 
 int *galois_get_mult_table(int w)
 {
-  if (galois_mult_tables[w] == NULL) {
+  if (!galois_table_ready(galois_mult_tables[w])) {
     if (galois_create_mult_tables(w)) {
       return NULL;
     }
@@ -650,7 +682,7 @@ int *galois_get_mult_table(int w)
 
 int *galois_get_div_table(int w) 
 {
-  if (galois_mult_tables[w] == NULL) {
+  if (!galois_table_ready(galois_mult_tables[w])) {
     if (galois_create_mult_tables(w)) {
       return NULL;
     }
@@ -660,7 +692,7 @@ int *galois_get_div_table(int w)
 
 int *galois_get_log_table(int w)
 {
-  if (galois_log_tables[w] == NULL) {
+  if (!galois_table_ready(galois_log_tables[w])) {
     if (galois_create_log_tables(w)) {
       return NULL;
     }
@@ -670,7 +702,7 @@ int *galois_get_log_table(int w)
 
 int *galois_get_ilog_table(int w)
 {
-  if (galois_ilog_tables[w] == NULL) {
+  if (!galois_table_ready(galois_ilog_tables[w])) {
     if (galois_create_log_tables(w)) {
       return NULL;
     }
@@ -693,7 +725,7 @@ void galois_w32_region_multiply(char *region,      /* Region to multiply */
   nbytes /= sizeof(int);
   ur2top = ur2 + nbytes;
 
-  if (galois_split_w8[0]== NULL) {
+  if (!galois_table_ready(galois_split_w8[0])) {
     if (galois_create_split_w8_tables(8) < 0) {
       fprintf(stderr, "galois_32_region_multiply -- couldn't make split multiplication tables\n");
       exit(1);
@@ -766,18 +798,19 @@ void galois_region_xor(           char *r1,         /* Region 1 */
   }
 }
 
-int galois_create_split_w8_tables()
+static int galois_create_split_w8_tables_locked()
 {
   int p1, p2, i, j, p1elt, p2elt, index, ishift, jshift, *table;
+  int *tables[7];
 
   if (galois_split_w8[0] != NULL) return 0;
 
-  if (galois_create_mult_tables(8) < 0) return -1;
+  if (galois_create_mult_tables_locked(8) < 0) return -1;
 
   for (i = 0; i < 7; i++) {
-    galois_split_w8[i] = (int *) malloc(sizeof(int) * (1 << 16));
-    if (galois_split_w8[i] == NULL) {
-      for (i--; i >= 0; i--) free(galois_split_w8[i]);
+    tables[i] = (int *) malloc(sizeof(int) * (1 << 16));
+    if (tables[i] == NULL) {
+      for (i--; i >= 0; i--) free(tables[i]);
       return -1;
     }
   }
@@ -786,7 +819,7 @@ int galois_create_split_w8_tables()
     ishift = i * 8;
     for (j = ((i == 0) ? 0 : 1) ; j < 4; j++) {
       jshift = j * 8;
-      table = galois_split_w8[i+j];
+      table = tables[i+j];
       index = 0;
       for (p1 = 0; p1 < 256; p1++) {
         p1elt = (p1 << ishift);
@@ -798,9 +831,33 @@ int galois_create_split_w8_tables()
       }
     }
   }
+
+  /* galois_split_w8[0] is the one that gets tested, so it goes last */
+  for (i = 6; i >= 0; i--) galois_table_publish(galois_split_w8[i], tables[i]);
   return 0;
 }
 
+int galois_create_split_w8_tables()
+{
+  int rv;
+
+  if (galois_table_ready(galois_split_w8[0])) return 0;
+  pthread_mutex_lock(&galois_tables_lock);
+  rv = galois_create_split_w8_tables_locked();
+  pthread_mutex_unlock(&galois_tables_lock);
+  return rv;
+}
+
+static void galois_init_default_tables(void) __attribute__((constructor));
+
+static void galois_init_default_tables(void)
+{
+  if (galois_create_mult_tables(8) < 0 || galois_create_log_tables(16) < 0) {
+    fprintf(stderr, "ERROR -- cannot make tables for w=8 and w=16\n");
+    exit(1);
+  }
+}
+
 int galois_split_w8_multiply(int x, int y)
 {
   int i, j, a, b, accumulator, i8, j8;
@@ -46,18 +46,296 @@ POSSIBILITY OF SUCH DAMAGE.
 
  */
 
+#include <fcntl.h>
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 #include "galois.h"
 #include "jerasure.h"
 
 #define talloc(type, num) (type *) malloc(sizeof(type)*(num))
 
-static double jerasure_total_xor_bytes = 0;
-static double jerasure_total_gf_bytes = 0;
-static double jerasure_total_memcpy_bytes = 0;
+/* Statistics are kept per thread, so that coding threads running in
+   parallel neither race on the counters nor bounce a shared cache line
+   between them.  Only the owning thread writes its counters.  Every
+   thread's counters are on jerasure_stats_list; when a thread exits, its
+   counters are folded into jerasure_retired_stats.  jerasure_get_stats()
+   sums everything and reports the difference from the previous call. */
+
+typedef struct jerasure_stats {
+  double xor_bytes;
+  double gf_bytes;
+  double memcpy_bytes;
+  struct jerasure_stats *next;
+} __attribute__((aligned(64))) jerasure_stats;
+
+static pthread_mutex_t jerasure_stats_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t jerasure_stats_once = PTHREAD_ONCE_INIT;
+static pthread_key_t jerasure_stats_key;
+static jerasure_stats *jerasure_stats_list = NULL;
+static jerasure_stats jerasure_retired_stats;
+static jerasure_stats jerasure_reported_stats;
+static __thread jerasure_stats *jerasure_thread_stats = NULL;
+
+static void jerasure_stats_retire(void *arg)
+{
+  jerasure_stats *s = (jerasure_stats *) arg;
+  jerasure_stats **p;
+
+  pthread_mutex_lock(&jerasure_stats_lock);
+  jerasure_retired_stats.xor_bytes += s->xor_bytes;
+  jerasure_retired_stats.gf_bytes += s->gf_bytes;
+  jerasure_retired_stats.memcpy_bytes += s->memcpy_bytes;
+  for (p = &jerasure_stats_list; *p != s; p = &(*p)->next) ;
+  *p = s->next;
+  pthread_mutex_unlock(&jerasure_stats_lock);
+  free(s);
+}
+
+static void jerasure_stats_init(void)
+{
+  pthread_key_create(&jerasure_stats_key, jerasure_stats_retire);
+}
+
+static jerasure_stats *jerasure_get_thread_stats(void)
+{
+  jerasure_stats *s;
+
+  if (jerasure_thread_stats != NULL) return jerasure_thread_stats;
+
+  pthread_once(&jerasure_stats_once, jerasure_stats_init);
+  if (posix_memalign((void **) &s, sizeof(jerasure_stats), sizeof(jerasure_stats)) != 0) {
+    fprintf(stderr, "ERROR -- cannot allocate statistics counters\n");
+    exit(1);
+  }
+  memset(s, 0, sizeof(jerasure_stats));
+  pthread_mutex_lock(&jerasure_stats_lock);
+  s->next = jerasure_stats_list;
+  jerasure_stats_list = s;
+  pthread_mutex_unlock(&jerasure_stats_lock);
+  pthread_setspecific(jerasure_stats_key, s);
+  jerasure_thread_stats = s;
+  return s;
+}
+
+/* Relaxed atomics compile to plain loads and stores, but keep the
+   cross-thread reads in jerasure_get_stats() well defined. */
+
+#define jerasure_count(counter, nbytes) do { \
+    jerasure_stats *_s = jerasure_get_thread_stats(); \
+    double _v = _s->counter + (nbytes); \
+    __atomic_store(&_s->counter, &_v, __ATOMIC_RELAXED); \
+  } while (0)
+
+static double jerasure_stat_load(double *counter)
+{
+  double v;
+
+  __atomic_load(counter, &v, __ATOMIC_RELAXED);
+  return v;
+}
+
+/* Tiling.  Schedules and bitmatrix dot products work on groups of w
+   packets, and each group touches w packets on every device.  When
+   (k+m)*w*packetsize is larger than the cache, every operation misses;
+   when it is tiny, the schedule is walked once per small group.  So
+   the region is processed in tiles whose working set is about half of
+   L2: large packets are cut into slices of at most a quarter of L1,
+   which run the whole schedule slice by slice, and small packets are
+   batched so that one pass of the schedule covers several groups.
+   jerasure_set_tiling() overrides the budget and the batching.
+   Every byte offset within a packet is independent of the others,
+   and operations on a group are still done in schedule order, so
+   the result is the same as the untiled loop. */
+
+static pthread_once_t jerasure_cache_once = PTHREAD_ONCE_INIT;
+static long jerasure_l1_size;
+static long jerasure_l2_size;
+static int jerasure_tile_bytes = 0;     /* 0 = from the caches, < 0 = no tiling */
+static int jerasure_tile_groups = 0;    /* 0 = automatic */
+
+/* Batching groups only pays off while the per-operation overhead is
+   significant next to the XOR itself, i.e. for small packets. */
+
+#define JER_BATCH_BYTES 512
+
+static long jerasure_sysfs_cache_size(int level)
+{
+  char path[100], buf[32];
+  FILE *f;
+  int i, l;
+  long size;
+  char unit;
+
+  for (i = 0; i < 8; i++) {
+    sprintf(path, "/sys/devices/system/cpu/cpu0/cache/index%d/level", i);
+    f = fopen(path, "r");
+    if (f == NULL) return 0;
+    l = (fscanf(f, "%d", &l) == 1) ? l : -1;
+    fclose(f);
+    if (l != level) continue;
+    sprintf(path, "/sys/devices/system/cpu/cpu0/cache/index%d/type", i);
+    f = fopen(path, "r");
+    if (f == NULL) continue;
+    if (fscanf(f, "%31s", buf) != 1 || strcmp(buf, "Instruction") == 0) {
+      fclose(f);
+      continue;
+    }
+    fclose(f);
+    sprintf(path, "/sys/devices/system/cpu/cpu0/cache/index%d/size", i);
+    f = fopen(path, "r");
+    if (f == NULL) continue;
+    unit = ' ';
+    size = 0;
+    if (fscanf(f, "%ld%c", &size, &unit) < 1) size = 0;
+    fclose(f);
+    if (unit == 'K') size *= 1024;
+    if (unit == 'M') size *= 1024*1024;
+    return size;
+  }
+  return 0;
+}
+
+static void jerasure_detect_caches(void)
+{
+  jerasure_l1_size = 0;
+  jerasure_l2_size = 0;
+#ifdef _SC_LEVEL1_DCACHE_SIZE
+  jerasure_l1_size = sysconf(_SC_LEVEL1_DCACHE_SIZE);
+  jerasure_l2_size = sysconf(_SC_LEVEL2_CACHE_SIZE);
+#endif
+  if (jerasure_l1_size <= 0) jerasure_l1_size = jerasure_sysfs_cache_size(1);
+  if (jerasure_l2_size <= 0) jerasure_l2_size = jerasure_sysfs_cache_size(2);
+  if (jerasure_l1_size <= 0) jerasure_l1_size = 32*1024;
+  if (jerasure_l2_size <= 0) jerasure_l2_size = 256*1024;
+}
+
+void jerasure_set_tiling(int tile_bytes, int max_groups)
+{
+  __atomic_store_n(&jerasure_tile_bytes, tile_bytes, __ATOMIC_RELAXED);
+  __atomic_store_n(&jerasure_tile_groups, max_groups, __ATOMIC_RELAXED);
+}
+
+/* Working-set budget of a tile in bytes, and the largest slice of a packet,
+   both multiples of 64.  Returns 0 if tiling is turned off. */
+
+static long jerasure_tile_budget(long *max_slice)
+{
+  long budget;
+
+  pthread_once(&jerasure_cache_once, jerasure_detect_caches);
+  budget = __atomic_load_n(&jerasure_tile_bytes, __ATOMIC_RELAXED);
+  if (budget < 0) return 0;
+  if (budget == 0) budget = jerasure_l2_size / 2;
+  *max_slice = (jerasure_l1_size / 4) & ~63L;
+  if (*max_slice < 64) *max_slice = 64;
+  return budget;
+}
+
+int jerasure_recommended_packetsize(int k, int m, int w)
+{
+  long budget, max_slice, p;
+
+  budget = jerasure_tile_budget(&max_slice);
+  if (budget == 0) {
+    pthread_once(&jerasure_cache_once, jerasure_detect_caches);
+    budget = jerasure_l2_size / 2;
+    max_slice = (jerasure_l1_size / 4) & ~63L;
+  }
+  p = (budget / ((long) (k+m) * w)) & ~63L;
+  if (p > max_slice) p = max_slice;
+  if (p < 64) p = 64;
+  return (int) p;
+}
+
+/* Runs the schedule on groups w-packet groups starting at ptrs, but only on
+   bytes [offset, offset+len) of every packet. */
+
+static void jerasure_do_scheduled_range(char **ptrs, int **operations, int w, int packetsize,
+                                        int groups, int offset, int len)
+{
+  char *sptr;
+  char *dptr;
+  int op, g, stride;
+
+  stride = packetsize*w;
+  for (op = 0; operations[op][0] >= 0; op++) {
+    sptr = ptrs[operations[op][0]] + operations[op][1]*packetsize + offset;
+    dptr = ptrs[operations[op][2]] + operations[op][3]*packetsize + offset;
+    if (operations[op][4]) {
+      for (g = 0; g < groups; g++) {
+        galois_region_xor(sptr, dptr, dptr, len);
+        sptr += stride;
+        dptr += stride;
+      }
+      jerasure_count(xor_bytes, (double) len*groups);
+    } else {
+      for (g = 0; g < groups; g++) {
+        memcpy(dptr, sptr, len);
+        sptr += stride;
+        dptr += stride;
+      }
+      jerasure_count(memcpy_bytes, (double) len*groups);
+    }
+  }
+}
+
+/* Picks the tile shape for nptrs devices: either *groups whole groups per
+   pass, or one group in slices of *slice bytes. */
+
+static void jerasure_tile_shape(int nptrs, int w, int packetsize, int size, int *groups, int *slice)
+{
+  long budget, max_slice, group_bytes, g, s;
+  int max_groups;
+
+  *groups = 1;
+  *slice = packetsize;
+  budget = jerasure_tile_budget(&max_slice);
+  if (budget == 0) return;
+
+  group_bytes = (long) nptrs * w * packetsize;
+  if (group_bytes > budget || packetsize > max_slice) {
+    s = (budget / ((long) nptrs * w)) & ~63L;
+    if (s > max_slice) s = max_slice;
+    if (s < 64) s = 64;
+    if (s < packetsize) *slice = s;
+    return;
+  }
+  g = budget / group_bytes;
+  max_groups = __atomic_load_n(&jerasure_tile_groups, __ATOMIC_RELAXED);
+  if (max_groups == 0 && g > JER_BATCH_BYTES / packetsize) g = JER_BATCH_BYTES / packetsize;
+  if (max_groups > 0 && g > max_groups) g = max_groups;
+  if (g > size / (packetsize*w)) g = size / (packetsize*w);
+  if (g < 1) g = 1;
+  *groups = g;
+}
+
+/* Runs the schedule over size bytes of every device, tile by tile.
+   ptrs is modified. */
+
+static void jerasure_run_schedule(int nptrs, char **ptrs, int **schedule, int w,
+                                  int size, int packetsize)
+{
+  int i, tdone, groups, slice, off, len, n;
+
+  jerasure_tile_shape(nptrs, w, packetsize, size, &groups, &slice);
+
+  for (tdone = 0; tdone < size; tdone += n*packetsize*w) {
+    n = (size - tdone) / (packetsize*w);
+    if (n > groups) n = groups;
+    if (n < 1) n = 1;
+    for (off = 0; off < packetsize; off += slice) {
+      len = (packetsize - off < slice) ? packetsize - off : slice;
+      jerasure_do_scheduled_range(ptrs, schedule, w, packetsize, n, off, len);
+    }
+    for (i = 0; i < nptrs; i++) ptrs[i] += (n*packetsize*w);
+  }
+}
 
 void jerasure_print_matrix(int *m, int rows, int cols, int w)
 {
@@ -313,25 +591,23 @@ void jerasure_matrix_encode(int k, int m, int w, int *matrix,
   }
 }
 
-void jerasure_bitmatrix_dotprod(int k, int w, int *bitmatrix_row,
+/* Does the dot product on bytes [offset, offset+len) of every packet. */
+
+static void jerasure_bitmatrix_dotprod_range(int k, int w, int *bitmatrix_row,
                              int *src_ids, int dest_id,
-                             char **data_ptrs, char **coding_ptrs, int size, int packetsize)
+                             char **data_ptrs, char **coding_ptrs, int size, int packetsize,
+                             int offset, int len)
 {
   int j, sindex, pstarted, index, x, y;
   char *dptr, *pptr, *bdptr, *bpptr;
 
-  if (size%(w*packetsize) != 0) {
-    fprintf(stderr, "jerasure_bitmatrix_dotprod - size%c(w*packetsize)) must = 0\n", '%');
-    exit(1);
-  }
-
   bpptr = (dest_id < k) ? data_ptrs[dest_id] : coding_ptrs[dest_id-k];
 
   for (sindex = 0; sindex < size; sindex += (packetsize*w)) {
     index = 0;
     for (j = 0; j < w; j++) {
       pstarted = 0;
-      pptr = bpptr + sindex + j*packetsize;
+      pptr = bpptr + sindex + j*packetsize + offset;
       for (x = 0; x < k; x++) {
         if (src_ids == NULL) {
           bdptr = data_ptrs[x];
@@ -342,14 +618,14 @@ void jerasure_bitmatrix_dotprod(int k, int w, int *bitmatrix_row,
         }
         for (y = 0; y < w; y++) {
           if (bitmatrix_row[index]) {
-            dptr = bdptr + sindex + y*packetsize;
+            dptr = bdptr + sindex + y*packetsize + offset;
             if (!pstarted) {
-              memcpy(pptr, dptr, packetsize);
-              jerasure_total_memcpy_bytes += packetsize;
+              memcpy(pptr, dptr, len);
+              jerasure_count(memcpy_bytes, len);
               pstarted = 1;
             } else {
-              galois_region_xor(pptr, dptr, pptr, packetsize);
-              jerasure_total_xor_bytes += packetsize;
+              galois_region_xor(pptr, dptr, pptr, len);
+              jerasure_count(xor_bytes, len);
             }
           }
           index++;
@@ -359,16 +635,29 @@ void jerasure_bitmatrix_dotprod(int k, int w, int *bitmatrix_row,
   }
 }
 
+void jerasure_bitmatrix_dotprod(int k, int w, int *bitmatrix_row,
+                             int *src_ids, int dest_id,
+                             char **data_ptrs, char **coding_ptrs, int size, int packetsize)
+{
+  if (size%(w*packetsize) != 0) {
+    fprintf(stderr, "jerasure_bitmatrix_dotprod - size%c(w*packetsize)) must = 0\n", '%');
+    exit(1);
+  }
+
+  jerasure_bitmatrix_dotprod_range(k, w, bitmatrix_row, src_ids, dest_id, data_ptrs, coding_ptrs,
+                                   size, packetsize, 0, packetsize);
+}
+
 void jerasure_do_parity(int k, char **data_ptrs, char *parity_ptr, int size) 
 {
   int i;
 
   memcpy(parity_ptr, data_ptrs[0], size);
-  jerasure_total_memcpy_bytes += size;
+  jerasure_count(memcpy_bytes, size);
   
   for (i = 1; i < k; i++) {
     galois_region_xor(data_ptrs[i], parity_ptr, parity_ptr, size);
-    jerasure_total_xor_bytes += size;
+    jerasure_count(xor_bytes, size);
   }
 }
 
@@ -603,11 +892,11 @@ void jerasure_matrix_dotprod(int k, int w, int *matrix_row,
       }
       if (init == 0) {
         memcpy(dptr, sptr, size);
-        jerasure_total_memcpy_bytes += size;
+        jerasure_count(memcpy_bytes, size);
         init = 1;
       } else {
         galois_region_xor(sptr, dptr, dptr, size);
-        jerasure_total_xor_bytes += size;
+        jerasure_count(xor_bytes, size);
       }
     }
   }
@@ -628,7 +917,7 @@ void jerasure_matrix_dotprod(int k, int w, int *matrix_row,
         case 16: galois_w16_region_multiply(sptr, matrix_row[i], size, dptr, init); break;
         case 32: galois_w32_region_multiply(sptr, matrix_row[i], size, dptr, init); break;
       }
-      jerasure_total_gf_bytes += size;
+      jerasure_count(gf_bytes, size);
       init = 1;
     }
   }
@@ -950,7 +1239,6 @@ int jerasure_schedule_decode_lazy(int k, int m, int w, int *bitmatrix, int *eras
                             char **data_ptrs, char **coding_ptrs, int size, int packetsize, 
                             int smart)
 {
-  int i, tdone;
   char **ptrs;
   int **schedule;
  
@@ -963,10 +1251,7 @@ int jerasure_schedule_decode_lazy(int k, int m, int w, int *bitmatrix, int *eras
     return -1;
   }
 
-  for (tdone = 0; tdone < size; tdone += packetsize*w) {
-  jerasure_do_scheduled_operations(ptrs, schedule, packetsize);
-    for (i = 0; i < k+m; i++) ptrs[i] += (packetsize*w);
-  }
+  jerasure_run_schedule(k+m, ptrs, schedule, w, size, packetsize);
 
   jerasure_free_schedule(schedule);
   free(ptrs);
@@ -977,7 +1262,6 @@ int jerasure_schedule_decode_lazy(int k, int m, int w, int *bitmatrix, int *eras
 int jerasure_schedule_decode_cache(int k, int m, int w, int ***scache, int *erasures,
                             char **data_ptrs, char **coding_ptrs, int size, int packetsize)
 {
-  int i, tdone;
   char **ptrs;
   int **schedule;
   int index;
@@ -996,10 +1280,7 @@ int jerasure_schedule_decode_cache(int k, int m, int w, int ***scache, int *eras
   if (ptrs == NULL) return -1;
 
 
-  for (tdone = 0; tdone < size; tdone += packetsize*w) {
-  jerasure_do_scheduled_operations(ptrs, schedule, packetsize);
-    for (i = 0; i < k+m; i++) ptrs[i] += (packetsize*w);
-  }
+  jerasure_run_schedule(k+m, ptrs, schedule, w, size, packetsize);
 
   free(ptrs);
 
@@ -1153,12 +1434,20 @@ int *jerasure_matrix_multiply(int *m1, int *m2, int r1, int c1, int r2, int c2,
 
 void jerasure_get_stats(double *fill_in)
 {
-  fill_in[0] = jerasure_total_xor_bytes;
-  fill_in[1] = jerasure_total_gf_bytes;
-  fill_in[2] = jerasure_total_memcpy_bytes;
-  jerasure_total_xor_bytes = 0;
-  jerasure_total_gf_bytes = 0;
-  jerasure_total_memcpy_bytes = 0;
+  jerasure_stats total, *s;
+
+  pthread_mutex_lock(&jerasure_stats_lock);
+  total = jerasure_retired_stats;
+  for (s = jerasure_stats_list; s != NULL; s = s->next) {
+    total.xor_bytes += jerasure_stat_load(&s->xor_bytes);
+    total.gf_bytes += jerasure_stat_load(&s->gf_bytes);
+    total.memcpy_bytes += jerasure_stat_load(&s->memcpy_bytes);
+  }
+  fill_in[0] = total.xor_bytes - jerasure_reported_stats.xor_bytes;
+  fill_in[1] = total.gf_bytes - jerasure_reported_stats.gf_bytes;
+  fill_in[2] = total.memcpy_bytes - jerasure_reported_stats.memcpy_bytes;
+  jerasure_reported_stats = total;
+  pthread_mutex_unlock(&jerasure_stats_lock);
 }
 
 void jerasure_do_scheduled_operations(char **ptrs, int **operations, int packetsize)
@@ -1177,11 +1466,11 @@ void jerasure_do_scheduled_operations(char **ptrs, int **operations, int packets
       operations[op][3]); 
       printf("xor(0x%x, 0x%x -> 0x%x, %d)\n", sptr, dptr, dptr, packetsize); */
       galois_region_xor(sptr, dptr, dptr, packetsize);
-      jerasure_total_xor_bytes += packetsize;
+      jerasure_count(xor_bytes, packetsize);
     } else {
 /*      printf("memcpy(0x%x <- 0x%x)\n", dptr, sptr); */
       memcpy(dptr, sptr, packetsize);
-      jerasure_total_memcpy_bytes += packetsize;
+      jerasure_count(memcpy_bytes, packetsize);
     }
   }  
 }
@@ -1190,15 +1479,12 @@ void jerasure_schedule_encode(int k, int m, int w, int **schedule,
                                    char **data_ptrs, char **coding_ptrs, int size, int packetsize)
 {
   char **ptr_copy;
-  int i, tdone;
+  int i;
 
   ptr_copy = talloc(char *, (k+m));
   for (i = 0; i < k; i++) ptr_copy[i] = data_ptrs[i];
   for (i = 0; i < m; i++) ptr_copy[i+k] = coding_ptrs[i];
-  for (tdone = 0; tdone < size; tdone += packetsize*w) {
-    jerasure_do_scheduled_operations(ptr_copy, schedule, packetsize);
-    for (i = 0; i < k+m; i++) ptr_copy[i] += (packetsize*w);
-  }
+  jerasure_run_schedule(k+m, ptr_copy, schedule, w, size, packetsize);
   free(ptr_copy);
 }
     
@@ -1357,7 +1643,8 @@ int **jerasure_smart_bitmatrix_to_schedule(int k, int m, int w, int *bitmatrix)
 void jerasure_bitmatrix_encode(int k, int m, int w, int *bitmatrix,
                             char **data_ptrs, char **coding_ptrs, int size, int packetsize)
 {
-  int i;
+  int i, tdone, tsize, groups, slice, off, len;
+  char **dptrs, **cptrs;
 
   if (packetsize%sizeof(long) != 0) {
     fprintf(stderr, "jerasure_bitmatrix_encode - packetsize(%d) %c sizeof(long) != 0\n", packetsize, '%');
@@ -1369,8 +1656,453 @@ void jerasure_bitmatrix_encode(int k, int m, int w, int *bitmatrix,
     exit(1);
   }
 
-  for (i = 0; i < m; i++) {
-    jerasure_bitmatrix_dotprod(k, w, bitmatrix+i*k*w*w, NULL, k+i, data_ptrs, coding_ptrs, size, packetsize);
+  /* Tile as in jerasure_run_schedule(), so that all m dot products
+     of a tile run while its data is still in the cache. */
+
+  jerasure_tile_shape(k+m, w, packetsize, size, &groups, &slice);
+  dptrs = talloc(char *, k);
+  cptrs = talloc(char *, m);
+  for (i = 0; i < k; i++) dptrs[i] = data_ptrs[i];
+  for (i = 0; i < m; i++) cptrs[i] = coding_ptrs[i];
+
+  for (tdone = 0; tdone < size; tdone += tsize) {
+    tsize = groups*packetsize*w;
+    if (tsize > size - tdone) tsize = size - tdone;
+    for (off = 0; off < packetsize; off += slice) {
+      len = (packetsize - off < slice) ? packetsize - off : slice;
+      for (i = 0; i < m; i++) {
+        jerasure_bitmatrix_dotprod_range(k, w, bitmatrix+i*k*w*w, NULL, k+i, dptrs, cptrs,
+                                         tsize, packetsize, off, len);
+      }
+    }
+    for (i = 0; i < k; i++) dptrs[i] += tsize;
+    for (i = 0; i < m; i++) cptrs[i] += tsize;
+  }
+  free(dptrs);
+  free(cptrs);
+}
+
+
+/* Schedule stores.  A store keeps the encoding schedule and any decoding
+   schedules that have been asked for, keyed by the set of erased devices.
+   Decoding schedules are made lazily, so any m works.  If the store has a
+   directory, its schedules are read from a file named after (k, m, w, smart,
+   hash of the bitmatrix) with a single mmap() when it is opened, and written
+   back when it is synced or closed.  The file format is native-endian ints:
+
+     header:  magic, version, k, m, w, smart, hash (2 ints), nentries,
+              then the bitmatrix, one bit per element, in (k*m*w*w+31)/32 ints
+     entry:   ne, then ne erased ids (ne = -1 for the encoding schedule),
+              nops, then nops+1 operations of 5 ints (the last has op[0] = -1)
+
+   A file is only used if its bitmatrix is the store's, so a hash collision
+   in the file name cannot hand out another matrix's schedules, and every
+   operation is checked to stay within k+m devices and w bits.  Schedules in
+   the mmap()'d file are used in place; only their row pointer arrays are
+   allocated. */
+
+#define JER_STORE_MAGIC 0x4a534331
+#define JER_STORE_VERSION 2
+#define JER_STORE_BUCKETS 257
+
+typedef struct jerasure_stored_schedule {
+  int ne;                       /* -1 for the encoding schedule */
+  int *ids;                     /* ne sorted erased ids */
+  int nops;
+  int **schedule;
+  int mapped;                   /* rows point into the mmap()'d file */
+  struct jerasure_stored_schedule *next;
+} jerasure_stored_schedule;
+
+struct jerasure_schedule_store {
+  int k, m, w, smart;
+  int *bitmatrix;
+  int *packed;                  /* bitmatrix as stored in the file header */
+  int npacked;
+  unsigned long long hash;
+  char *path;
+  void *map;
+  size_t map_size;
+  int dirty;
+  pthread_mutex_t lock;
+  jerasure_stored_schedule *buckets[JER_STORE_BUCKETS];
+};
+
+static unsigned long long jerasure_bitmatrix_hash(int k, int m, int w, int *bitmatrix)
+{
+  unsigned long long h;
+  int i;
+
+  h = 14695981039346656037ULL;
+  for (i = 0; i < k*m*w*w; i++) {
+    h ^= (bitmatrix[i] != 0);
+    h *= 1099511628211ULL;
+  }
+  return h;
+}
+
+static int *jerasure_bitmatrix_pack(int k, int m, int w, int *bitmatrix, int *npacked)
+{
+  int *packed;
+  int i;
+
+  *npacked = (k*m*w*w+31)/32;
+  packed = talloc(int, *npacked);
+  if (packed == NULL) return NULL;
+  memset(packed, 0, sizeof(int)*(*npacked));
+  for (i = 0; i < k*m*w*w; i++) {
+    if (bitmatrix[i]) packed[i/32] |= (1U << (i%32));
   }
+  return packed;
 }
 
+/* Returns whether the ne erased ids are sorted, distinct and below k+m. */
+
+static int jerasure_store_valid_ids(jerasure_schedule_store *store, int ne, int *ids)
+{
+  int i;
+
+  for (i = 0; i < ne; i++) {
+    if (ids[i] < 0 || ids[i] >= store->k+store->m || (i > 0 && ids[i] <= ids[i-1])) return 0;
+  }
+  return 1;
+}
+
+/* Returns whether every one of the nops operations reads and writes a
+   packet within the k+m devices and w bits that schedules are run on. */
+
+static int jerasure_store_valid_ops(jerasure_schedule_store *store, int nops, int *ops)
+{
+  int i;
+
+  for (i = 0; i < nops; i++, ops += 5) {
+    if (ops[0] < 0 || ops[0] >= store->k+store->m || ops[1] < 0 || ops[1] >= store->w ||
+        ops[2] < 0 || ops[2] >= store->k+store->m || ops[3] < 0 || ops[3] >= store->w) return 0;
+  }
+  return 1;
+}
+
+static int jerasure_store_bucket(int ne, int *ids)
+{
+  unsigned int h;
+  int i;
+
+  h = (unsigned int) ne;
+  for (i = 0; i < ne; i++) h = h*31 + ids[i];
+  return h % JER_STORE_BUCKETS;
+}
+
+static jerasure_stored_schedule *jerasure_store_find(jerasure_schedule_store *store, int ne, int *ids)
+{
+  jerasure_stored_schedule *s;
+
+  for (s = store->buckets[jerasure_store_bucket(ne, ids)]; s != NULL; s = s->next) {
+    if (s->ne == ne && (ne <= 0 || memcmp(s->ids, ids, sizeof(int)*ne) == 0)) return s;
+  }
+  return NULL;
+}
+
+static jerasure_stored_schedule *jerasure_store_add(jerasure_schedule_store *store, int ne, int *ids,
+                                                    int **schedule, int mapped)
+{
+  jerasure_stored_schedule *s;
+  int b;
+
+  s = talloc(jerasure_stored_schedule, 1);
+  if (s == NULL) return NULL;
+  s->ne = ne;
+  s->ids = NULL;
+  if (ne > 0) {
+    s->ids = talloc(int, ne);
+    memcpy(s->ids, ids, sizeof(int)*ne);
+  }
+  for (s->nops = 0; schedule[s->nops][0] >= 0; s->nops++) ;
+  s->schedule = schedule;
+  s->mapped = mapped;
+  b = jerasure_store_bucket(ne, ids);
+  s->next = store->buckets[b];
+  store->buckets[b] = s;
+  return s;
+}
+
+/* Sorts the erasures into ids and returns how many there are. */
+
+static int jerasure_store_key(int k, int m, int *erasures, int *ids)
+{
+  int *erased;
+  int i, ne;
+
+  erased = jerasure_erasures_to_erased(k, m, erasures);
+  if (erased == NULL) return -1;
+  ne = 0;
+  for (i = 0; i < k+m; i++) if (erased[i]) ids[ne++] = i;
+  free(erased);
+  return ne;
+}
+
+static void jerasure_store_load(jerasure_schedule_store *store)
+{
+  int fd, i, j, ne, nops, nentries;
+  struct stat st;
+  int *p, *end, *ids;
+  int **schedule;
+  void *map;
+
+  fd = open(store->path, O_RDONLY);
+  if (fd < 0) return;
+  if (fstat(fd, &st) < 0 || st.st_size < (off_t) (9*sizeof(int))) {
+    close(fd);
+    return;
+  }
+  map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED) return;
+
+  p = (int *) map;
+  end = p + st.st_size/sizeof(int);
+  if (p[0] != JER_STORE_MAGIC || p[1] != JER_STORE_VERSION || p[2] != store->k || p[3] != store->m ||
+      p[4] != store->w || p[5] != store->smart ||
+      memcmp(p+6, &store->hash, sizeof(unsigned long long)) != 0 ||
+      end - (p+9) < store->npacked ||
+      memcmp(p+9, store->packed, sizeof(int)*store->npacked) != 0) {
+    munmap(map, st.st_size);
+    return;
+  }
+  nentries = p[8];
+  p += 9 + store->npacked;
+
+  store->map = map;
+  store->map_size = st.st_size;
+
+  /* Anything that does not parse is dropped, and will be regenerated */
+
+  for (i = 0; i < nentries; i++) {
+    if (p >= end) break;
+    ne = *p++;
+    if (ne < -1 || ne > store->m || p + (ne > 0 ? ne : 0) + 1 > end) break;
+    ids = p;
+    if (ne > 0) p += ne;
+    if (!jerasure_store_valid_ids(store, ne, ids)) break;
+    nops = *p++;
+    if (nops < 0 || (end - p) / 5 < nops+1 || p[nops*5] != -1 ||
+        !jerasure_store_valid_ops(store, nops, p)) break;
+    schedule = talloc(int *, nops+1);
+    if (schedule == NULL) break;
+    for (j = 0; j <= nops; j++) schedule[j] = p + j*5;
+    p += (nops+1)*5;
+    if (jerasure_store_find(store, ne, ids) != NULL ||
+        jerasure_store_add(store, ne, ids, schedule, 1) == NULL) {
+      free(schedule);
+    }
+  }
+}
+
+jerasure_schedule_store *jerasure_open_schedule_store(int k, int m, int w, int *bitmatrix, int smart,
+                                                      const char *dir)
+{
+  jerasure_schedule_store *store;
+  size_t len;
+
+  store = talloc(jerasure_schedule_store, 1);
+  if (store == NULL) return NULL;
+  memset(store, 0, sizeof(jerasure_schedule_store));
+  store->k = k;
+  store->m = m;
+  store->w = w;
+  store->smart = (smart != 0);
+  store->bitmatrix = talloc(int, k*m*w*w);
+  if (store->bitmatrix == NULL) {
+    free(store);
+    return NULL;
+  }
+  memcpy(store->bitmatrix, bitmatrix, sizeof(int)*k*m*w*w);
+  store->packed = jerasure_bitmatrix_pack(k, m, w, bitmatrix, &store->npacked);
+  if (store->packed == NULL) {
+    free(store->bitmatrix);
+    free(store);
+    return NULL;
+  }
+  store->hash = jerasure_bitmatrix_hash(k, m, w, bitmatrix);
+  pthread_mutex_init(&store->lock, NULL);
+
+  if (dir == NULL) dir = getenv("JERASURE_SCHEDULE_DIR");
+  if (dir != NULL && dir[0] != '\0') {
+    len = strlen(dir) + 100;
+    store->path = talloc(char, len);
+    if (store->path != NULL) {
+      snprintf(store->path, len, "%s/jerasure_k%d_m%d_w%d_%s_%016llx.sched", dir, k, m, w,
+               store->smart ? "smart" : "dumb", store->hash);
+      jerasure_store_load(store);
+    }
+  }
+  return store;
+}
+
+static int **jerasure_store_lookup(jerasure_schedule_store *store, int *erasures)
+{
+  jerasure_stored_schedule *s;
+  int *ids;
+  int ne;
+  int **schedule;
+
+  ids = talloc(int, store->k+store->m);
+  if (ids == NULL) return NULL;
+  if (erasures == NULL) {
+    ne = -1;
+  } else {
+    ne = jerasure_store_key(store->k, store->m, erasures, ids);
+    if (ne < 0) {
+      free(ids);
+      return NULL;
+    }
+  }
+
+  pthread_mutex_lock(&store->lock);
+  s = jerasure_store_find(store, ne, ids);
+  if (s == NULL) {
+    if (ne == -1) {
+      schedule = (store->smart) ?
+        jerasure_smart_bitmatrix_to_schedule(store->k, store->m, store->w, store->bitmatrix) :
+        jerasure_dumb_bitmatrix_to_schedule(store->k, store->m, store->w, store->bitmatrix);
+    } else {
+      schedule = jerasure_generate_decoding_schedule(store->k, store->m, store->w, store->bitmatrix,
+                                                     erasures, store->smart);
+    }
+    if (schedule != NULL) {
+      s = jerasure_store_add(store, ne, ids, schedule, 0);
+      if (s == NULL) {
+        jerasure_free_schedule(schedule);
+      } else {
+        store->dirty = 1;
+      }
+    }
+  }
+  pthread_mutex_unlock(&store->lock);
+  free(ids);
+  return (s == NULL) ? NULL : s->schedule;
+}
+
+int **jerasure_schedule_store_encode(jerasure_schedule_store *store)
+{
+  return jerasure_store_lookup(store, NULL);
+}
+
+int **jerasure_schedule_store_decode(jerasure_schedule_store *store, int *erasures)
+{
+  return jerasure_store_lookup(store, erasures);
+}
+
+int jerasure_schedule_decode_stored(jerasure_schedule_store *store, int *erasures,
+                            char **data_ptrs, char **coding_ptrs, int size, int packetsize)
+{
+  char **ptrs;
+  int **schedule;
+
+  schedule = jerasure_schedule_store_decode(store, erasures);
+  if (schedule == NULL) return -1;
+
+  ptrs = set_up_ptrs_for_scheduled_decoding(store->k, store->m, erasures, data_ptrs, coding_ptrs);
+  if (ptrs == NULL) return -1;
+
+  jerasure_run_schedule(store->k+store->m, ptrs, schedule, store->w, size, packetsize);
+
+  free(ptrs);
+  return 0;
+}
+
+static int jerasure_store_write(FILE *f, int *v, int n)
+{
+  return (fwrite(v, sizeof(int), n, f) == (size_t) n) ? 0 : -1;
+}
+
+int jerasure_sync_schedule_store(jerasure_schedule_store *store)
+{
+  jerasure_stored_schedule *s;
+  FILE *f;
+  char *tmp;
+  int header[9];
+  int i, j, rv;
+
+  if (store->path == NULL) return 0;
+  pthread_mutex_lock(&store->lock);
+  if (!store->dirty) {
+    pthread_mutex_unlock(&store->lock);
+    return 0;
+  }
+
+  /* Write a new file and rename it over the old one, so that a reader
+     never sees a partial file and our own mapping stays valid. */
+
+  tmp = talloc(char, strlen(store->path) + 32);
+  if (tmp == NULL) {
+    pthread_mutex_unlock(&store->lock);
+    return -1;
+  }
+  sprintf(tmp, "%s.%d", store->path, (int) getpid());
+  f = fopen(tmp, "w");
+  if (f == NULL) {
+    free(tmp);
+    pthread_mutex_unlock(&store->lock);
+    return -1;
+  }
+
+  header[0] = JER_STORE_MAGIC;
+  header[1] = JER_STORE_VERSION;
+  header[2] = store->k;
+  header[3] = store->m;
+  header[4] = store->w;
+  header[5] = store->smart;
+  memcpy(header+6, &store->hash, sizeof(unsigned long long));
+  header[8] = 0;
+  for (i = 0; i < JER_STORE_BUCKETS; i++) {
+    for (s = store->buckets[i]; s != NULL; s = s->next) header[8]++;
+  }
+  rv = jerasure_store_write(f, header, 9);
+  if (rv == 0) rv = jerasure_store_write(f, store->packed, store->npacked);
+
+  for (i = 0; i < JER_STORE_BUCKETS && rv == 0; i++) {
+    for (s = store->buckets[i]; s != NULL && rv == 0; s = s->next) {
+      rv = jerasure_store_write(f, &s->ne, 1);
+      if (rv == 0 && s->ne > 0) rv = jerasure_store_write(f, s->ids, s->ne);
+      if (rv == 0) rv = jerasure_store_write(f, &s->nops, 1);
+      for (j = 0; j <= s->nops && rv == 0; j++) rv = jerasure_store_write(f, s->schedule[j], 5);
+    }
+  }
+
+  if (fclose(f) != 0) rv = -1;
+  if (rv == 0 && rename(tmp, store->path) == 0) {
+    store->dirty = 0;
+  } else {
+    unlink(tmp);
+    rv = -1;
+  }
+  free(tmp);
+  pthread_mutex_unlock(&store->lock);
+  return rv;
+}
+
+void jerasure_close_schedule_store(jerasure_schedule_store *store)
+{
+  jerasure_stored_schedule *s, *next;
+  int i;
+
+  jerasure_sync_schedule_store(store);
+  for (i = 0; i < JER_STORE_BUCKETS; i++) {
+    for (s = store->buckets[i]; s != NULL; s = next) {
+      next = s->next;
+      if (s->mapped) {
+        free(s->schedule);
+      } else {
+        jerasure_free_schedule(s->schedule);
+      }
+      if (s->ids != NULL) free(s->ids);
+      free(s);
+    }
+  }
+  if (store->map != NULL) munmap(store->map, store->map_size);
+  pthread_mutex_destroy(&store->lock);
+  free(store->path);
+  free(store->bitmatrix);
+  free(store->packed);
+  free(store);
+}
@@ -287,6 +287,66 @@ int jerasure_schedule_decode_lazy(int k, int m, int w, int *bitmatrix, int *eras
 int jerasure_schedule_decode_cache(int k, int m, int w, int ***scache, int *erasures,
                             char **data_ptrs, char **coding_ptrs, int size, int packetsize);
 
+/* ------------------------------------------------------------ */
+/* Schedule stores -------------------------------------------- */
+
+/* A schedule store holds the encoding schedule of a bitmatrix and the
+   decoding schedules for every erasure pattern that has been decoded so
+   far, for any m.  With a directory, the schedules persist in a file keyed
+   by (k, m, w, smart, hash of the bitmatrix) that is mmap()'d back in when
+   the store is opened, so short-lived programs skip schedule generation.
+   Schedules returned by a store belong to it: do not free them. */
+
+typedef struct jerasure_schedule_store jerasure_schedule_store;
+
+/** This function opens a schedule store for the given bitmatrix, loading any schedules saved by earlier runs. The bitmatrix is copied.
+ * @param k Number of data devices
+ * @param m Number of coding devices
+ * @param w Word size
+ * @param bitmatrix Array of k*m*w*w integers. It represents an mw by kw matrix. Element i,j is in matrix[i*k*w+j]
+ * @param smart Use jerasure_smart_bitmatrix_to_schedule() instead of jerasure_dumb_bitmatrix_to_schedule()
+ * @param dir Directory of the cache file. If NULL, the JERASURE_SCHEDULE_DIR environment variable is used; if that is unset too, the store is kept in memory only.
+ * @return The store, or NULL if it could not be allocated
+ */
+jerasure_schedule_store *jerasure_open_schedule_store(int k, int m, int w, int *bitmatrix, int smart,
+                                                      const char *dir);
+
+/** This function returns the encoding schedule of the store, generating it on first use.
+ * @param store Store from jerasure_open_schedule_store()
+ * @return The schedule, to be used with jerasure_schedule_encode(), or NULL on failure
+ */
+int **jerasure_schedule_store_encode(jerasure_schedule_store *store);
+
+/** This function returns the decoding schedule for the given erasures, generating it on first use. The order of the erasures does not matter.
+ * @param store Store from jerasure_open_schedule_store()
+ * @param erasures Array of id's of erased devices. If there are e erasures, erasures[e] = -1.
+ * @return The schedule, or NULL if the erasures cannot be decoded
+ */
+int **jerasure_schedule_store_decode(jerasure_schedule_store *store, int *erasures);
+
+/** This function decodes like jerasure_schedule_decode_lazy(), but with a decoding schedule from the store.
+ * @param store Store from jerasure_open_schedule_store()
+ * @param erasures Array of id's of erased devices. If there are e erasures, erasures[e] = -1.
+ * @param data_ptrs Array of k pointers to data which is size bytes. Size must be a multiple of sizeof(long). Pointers must also be longword aligned.
+ * @param coding_ptrs Array of m pointers to coding data which is size bytes
+ * @param size Size of memory allocated by coding_ptrs/data_ptrs in bytes.
+ * @param packetsize The size of a coding block with bitmatrix coding.
+ * @return 0 on success, -1 if the erasures cannot be decoded
+ */
+int jerasure_schedule_decode_stored(jerasure_schedule_store *store, int *erasures,
+                            char **data_ptrs, char **coding_ptrs, int size, int packetsize);
+
+/** This function writes any new schedules of the store to its cache file. It is safe to call while other threads use the store.
+ * @param store Store from jerasure_open_schedule_store()
+ * @return 0 on success (or if the store has no file), -1 if the file could not be written
+ */
+int jerasure_sync_schedule_store(jerasure_schedule_store *store);
+
+/** This function syncs the store and frees it, along with all of its schedules.
+ * @param store Store from jerasure_open_schedule_store()
+ */
+void jerasure_close_schedule_store(jerasure_schedule_store *store);
+
 /** This function makes the k*k decoding matrix (or wk*wk bitmatrix) by taking the rows corresponding to k non-erased devices of the distribution matrix, and then inverting that matrix. You should already have allocated the decoding matrix and dm_ids, which is a vector of k integers.  These will be filled in appropriately.  dm_ids[i] is the id of element i of the survivors vector.  I.e. row i of the decoding matrix times dm_ids equals data drive i. Both of these routines take "erased" instead of "erasures". Erased is a vector with k+m elements, which has 0 or 1 for each device's id, according to whether the device is erased.
  * @param k Number of data devices
  * @param m Number of coding devices
@@ -459,10 +519,27 @@ void jerasure_print_bitmatrix(int *matrix, int rows, int cols, int w);
  */
 int *jerasure_matrix_multiply(int *m1, int *m2, int r1, int c1, int r2, int c2, int w);
 
+/* ------------------------------------------------------------ */
+/* Tiling ----------------------------------------------------- */
+
+/** This function sets how jerasure_schedule_encode(), jerasure_bitmatrix_encode() and the scheduled decoders tile the region. By default a tile's working set (w packets on each of the k+m devices, times the number of groups) is about half of the L2 cache: packets larger than that, or than a quarter of L1, are processed in slices, and small ones several w-packet groups at a time. The output does not depend on the tiling.
+ * @param tile_bytes Working set of a tile in bytes. 0 detects it from the caches; a negative value turns tiling off and processes one group at a time.
+ * @param max_groups Largest number of w-packet groups processed per pass of the schedule, or 0 to batch only small packets (up to 512 bytes of each packet per operation).
+ */
+void jerasure_set_tiling(int tile_bytes, int max_groups);
+
+/** This function returns a packetsize for bitmatrix coding that keeps one group of w packets on each of the k+m devices within the L2 tile budget, and each packet within a quarter of L1. It is a multiple of 64.
+ * @param k Number of data devices
+ * @param m Number of coding devices
+ * @param w Word size
+ * @return The packetsize in bytes
+ */
+int jerasure_recommended_packetsize(int k, int m, int w);
+
 /* ------------------------------------------------------------ */
 /* Stats ------------------------------------------------------ */
 
-/** This function fills in a vector of three doubles: fill_in[0] is the number of bytes that have been XOR'd, fill_in[1] is the number of bytes that have been copied, fill_in[2] is the number of bytes that have been multiplied by a constant in \f$GF(2^w)\f$. When jerasure_get_stats() is called, it resets its values.
+/** This function fills in a vector of three doubles: fill_in[0] is the number of bytes that have been XOR'd, fill_in[1] is the number of bytes that have been multiplied by a constant in \f$GF(2^w)\f$, fill_in[2] is the number of bytes that have been copied. The counts are kept per thread and summed over all threads (including ones that have exited) since the previous call, so jerasure_get_stats() may be called from any thread.
  * @param fill_in vector of three doubles to be filled
  * @code
  * jerasure_get_stats(); // reset all values
@@ -0,0 +1,93 @@
+/**
+  * @file aes.cc
+  * @brief Implements the AESCTR class.
+  * **/
+
+/* ===================================================================
+Copyright (c) 2026, the NCCloud contributors
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+  - Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+  - Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in
+    the documentation and/or other materials provided with the
+    distribution.
+
+  - Neither the name of the copyright holder nor the
+    names of its contributors may be used to endorse or promote
+    products derived from this software without specific prior written
+    permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT
+HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+=================================================================== */
+
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <openssl/evp.h>
+
+#include "aes.h"
+#include "common.h"
+
+using namespace std;
+
+
+AESCTR::AESCTR(const unsigned char *key, uint64_t nonce): nonce(nonce)
+{
+  memcpy(this->key, key, key_size);
+}
+
+
+AESCTR::~AESCTR()
+{
+  memset(key, 0, key_size);
+}
+
+
+void AESCTR::keystream(unsigned char *out, size_t size, uint64_t counter) const
+{
+  memset(out, 0, size);
+  xor_keystream(out, size, counter);
+}
+
+
+void AESCTR::xor_keystream(unsigned char *data, size_t size, uint64_t counter) const
+{
+  unsigned char iv[block_size];
+  for (int i=0; i<8; ++i) {
+    iv[i] = nonce >> (56 - 8*i);
+    iv[8+i] = counter >> (56 - 8*i);
+  }
+  EVP_CIPHER_CTX *ctx = EVP_CIPHER_CTX_new();
+  if (ctx == NULL || EVP_EncryptInit_ex(ctx, EVP_aes_256_ctr(), NULL, key, iv) != 1) {
+    show_error("EVP_EncryptInit_ex");
+  }
+
+  // counter mode encrypts in place, in pieces that fit in an int
+  while (size > 0) {
+    int len = min(size, (size_t)INT_MAX & ~(block_size - 1));
+    if (EVP_EncryptUpdate(ctx, data, &len, data, len) != 1) {
+      show_error("EVP_EncryptUpdate");
+    }
+    data += len;
+    size -= len;
+  }
+  EVP_CIPHER_CTX_free(ctx);
+}
@@ -0,0 +1,73 @@
+/**
+  * @file aes.h
+  * @brief Declares the AESCTR class.
+  * **/
+
+/* ===================================================================
+Copyright (c) 2026, the NCCloud contributors
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+  - Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+  - Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in
+    the documentation and/or other materials provided with the
+    distribution.
+
+  - Neither the name of the copyright holder nor the
+    names of its contributors may be used to endorse or promote
+    products derived from this software without specific prior written
+    permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT
+HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+=================================================================== */
+
+
+#ifndef NCCLOUD_AES_H
+#define NCCLOUD_AES_H
+
+#include <cstddef>
+#include <stdint.h>
+
+
+/** AES-256 in counter mode, through OpenSSL's EVP interface, which runs on
+ *  the AES-NI instructions where the CPU has them.  The 128-bit counter block
+ *  is a 64-bit nonce followed by a 64-bit block counter, both big-endian, so
+ *  any block of the keystream can be generated independently. */
+class AESCTR
+{
+  unsigned char key[32];
+  uint64_t nonce;
+
+public:
+  /** Size of a key in bytes. */
+  static const size_t key_size = 32;
+  /** Size of a keystream block in bytes. */
+  static const size_t block_size = 16;
+
+  AESCTR(const unsigned char *key, uint64_t nonce);
+  ~AESCTR();
+
+  /** Write size bytes of keystream starting at block "counter" to out. */
+  void keystream(unsigned char *out, size_t size, uint64_t counter=0) const;
+
+  /** XOR size bytes of keystream starting at block "counter" into data. */
+  void xor_keystream(unsigned char *data, size_t size, uint64_t counter=0) const;
+};
+
+#endif  /* NCCLOUD_AES_H */
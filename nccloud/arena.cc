@@ -0,0 +1,179 @@
+/**
+  * @file arena.cc
+  * @brief Implements the BufferArena class.
+  * **/
+
+/* ===================================================================
+Copyright (c) 2026, the NCCloud contributors
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+  - Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+  - Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in
+    the documentation and/or other materials provided with the
+    distribution.
+
+  - Neither the name of the copyright holder nor the
+    names of its contributors may be used to endorse or promote
+    products derived from this software without specific prior written
+    permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT
+HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+=================================================================== */
+
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+#include <sstream>
+
+#include <sys/mman.h>
+
+#include "arena.h"
+#include "common.h"
+
+using namespace std;
+
+
+/*  ----------------  */
+/* | Public methods | */
+/*  ----------------  */
+BufferArena *BufferArena::instance(void)
+{
+  static BufferArena _instance;
+  return &_instance;
+}
+
+
+char *BufferArena::acquire(size_t size)
+{
+  size_t cls = size_class(size);
+  {
+    lock_guard<mutex> lock(arena_mutex);
+    acquires++;
+    auto it = idle_buffers.find(cls);
+    if (it != idle_buffers.end() && !it->second.empty()) {
+      char *buffer = it->second.back();
+      it->second.pop_back();
+      idle_bytes -= cls;
+      reuses++;
+      return buffer;
+    }
+  }
+
+  // nothing idle in this size class, so allocate a new buffer
+  void *buffer = NULL;
+  size_t align = (cls >= huge_page_size)? huge_page_size : alignment;
+  if (posix_memalign(&buffer, align, cls) != 0) {
+    throw bad_alloc();
+  }
+  if (cls >= huge_page_size) {
+    madvise(buffer, cls, MADV_HUGEPAGE);  // only a hint
+  }
+
+  lock_guard<mutex> lock(arena_mutex);
+  buffer_sizes[(char *)buffer] = cls;
+  owned_bytes += cls;
+  if (owned_bytes > peak_bytes) {
+    peak_bytes = owned_bytes;
+  }
+  return (char *)buffer;
+}
+
+
+void BufferArena::release(void *buffer)
+{
+  if (buffer == NULL) {
+    return;
+  }
+  lock_guard<mutex> lock(arena_mutex);
+  size_t cls = buffer_sizes[(char *)buffer];
+  idle_buffers[cls].push_back((char *)buffer);
+  idle_bytes += cls;
+  trim();
+}
+
+
+void BufferArena::set_idle_cap(size_t bytes)
+{
+  lock_guard<mutex> lock(arena_mutex);
+  idle_cap = bytes;
+  trim();
+}
+
+
+void BufferArena::print_stats(void)
+{
+  lock_guard<mutex> lock(arena_mutex);
+  print(stringstream() << "Buffer arena: " << acquires << " acquired, "
+                       << reuses << " reused, "
+                       << acquires - reuses << " allocated, peak "
+                       << (peak_bytes >> 20) << " MB" << endl);
+}
+
+
+/*  -----------------  */
+/* | Private methods | */
+/*  -----------------  */
+BufferArena::BufferArena(): idle_cap((size_t)1 << 30), idle_bytes(0),
+    acquires(0), reuses(0), owned_bytes(0), peak_bytes(0)
+{
+}
+
+
+BufferArena::~BufferArena()
+{
+  idle_cap = 0;
+  trim();
+}
+
+
+size_t BufferArena::size_class(size_t size)
+{
+  // four classes per power of two, so at most a quarter is wasted
+  if (size <= alignment) {
+    return alignment;
+  }
+  size_t power = alignment;
+  while (power * 2 < size) {
+    power *= 2;
+  }
+  size_t step = max(power / 4, alignment);
+  size_t cls = (size + step - 1) / step * step;
+  if (cls >= huge_page_size) {
+    cls = (cls + huge_page_size - 1) / huge_page_size * huge_page_size;
+  }
+  return cls;
+}
+
+
+void BufferArena::trim(void)
+{
+  // free the largest idle buffers first
+  for (auto it = idle_buffers.rbegin(); it != idle_buffers.rend() && idle_bytes > idle_cap; ++it) {
+    while (!it->second.empty() && idle_bytes > idle_cap) {
+      char *buffer = it->second.back();
+      it->second.pop_back();
+      buffer_sizes.erase(buffer);
+      idle_bytes -= it->first;
+      owned_bytes -= it->first;
+      free(buffer);
+    }
+  }
+}
@@ -0,0 +1,118 @@
+/**
+  * @file arena.h
+  * @brief Declares the BufferArena class.
+  * **/
+
+/* ===================================================================
+Copyright (c) 2026, the NCCloud contributors
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+  - Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+  - Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in
+    the documentation and/or other materials provided with the
+    distribution.
+
+  - Neither the name of the copyright holder nor the
+    names of its contributors may be used to endorse or promote
+    products derived from this software without specific prior written
+    permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT
+HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+=================================================================== */
+
+
+#ifndef NCCLOUD_ARENA_H
+#define NCCLOUD_ARENA_H
+
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <vector>
+
+
+/** Singleton pool of aligned buffers for the file-sized work areas of the
+ *  coding modules.  Buffers are grouped in size classes and recycled across
+ *  files and jobs, so that batch operations stop paying for fresh
+ *  allocations and the page faults that come with them.
+ *
+ *  The arena only holds data that has no file behind it: code chunks before
+ *  upload, chunks downloaded to memory and decoding scratch space.  Source
+ *  files, chunk files and decoded files are mapped instead (see
+ *  Coding::map_input() and Coding::map_output()).
+ *
+ *  The arena does not bound the memory in use: acquire() always succeeds
+ *  while the system has memory, and only the buffers kept idle for reuse are
+ *  limited (see set_idle_cap()). */
+class BufferArena
+{
+  std::mutex arena_mutex;
+  std::map<size_t, std::vector<char *> > idle_buffers;  // idle buffers by size class
+  std::map<char *, size_t> buffer_sizes;  // size class of every buffer owned
+  size_t idle_cap;    // most bytes kept in idle buffers
+  size_t idle_bytes;  // bytes currently in idle buffers
+
+  size_t acquires;     // number of acquire() calls
+  size_t reuses;       // acquire() calls served by an idle buffer
+  size_t owned_bytes;  // bytes currently owned, idle or not
+  size_t peak_bytes;   // most bytes ever owned at once
+
+  BufferArena();
+  ~BufferArena();
+
+  /** Round size up to its size class. */
+  static size_t size_class(size_t size);
+
+  /** Free idle buffers until at most idle_cap bytes are idle.  Caller holds arena_mutex. */
+  void trim(void);
+
+public:
+  /** Alignment of every buffer, a cache line. */
+  static const size_t alignment = 64;
+
+  /** Buffers of at least this size are aligned to it and backed by huge pages
+   *  where the kernel allows. */
+  static const size_t huge_page_size = 2 << 20;
+
+
+  /** Returns a singleton instance of BufferArena. */
+  static BufferArena *instance(void);
+
+
+  /** Get a buffer of at least size bytes, recycling an idle one if possible.
+   *  Its contents are undefined.
+   *  @param[in] size number of bytes needed
+   *  @return pointer to the buffer (throws std::bad_alloc on failure) */
+  char *acquire(size_t size);
+
+
+  /** Give a buffer from acquire() back to the arena (NULL is ignored). */
+  void release(void *buffer);
+
+
+  /** Set the most bytes kept in idle buffers for reuse, freeing any excess.
+   *  Buffers in use do not count towards it. */
+  void set_idle_cap(size_t bytes);
+
+
+  /** Print reuse statistics. */
+  void print_stats(void);
+};
+
+#endif  /* NCCLOUD_ARENA_H */
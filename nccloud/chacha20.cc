@@ -0,0 +1,183 @@
+/**
+  * @file chacha20.cc
+  * @brief Implements the ChaCha20 class.
+  * **/
+
+/* ===================================================================
+Copyright (c) 2026, the NCCloud contributors
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+  - Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+  - Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in
+    the documentation and/or other materials provided with the
+    distribution.
+
+  - Neither the name of the copyright holder nor the
+    names of its contributors may be used to endorse or promote
+    products derived from this software without specific prior written
+    permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT
+HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+=================================================================== */
+
+
+#include <cstring>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "chacha20.h"
+
+/** Number of blocks generated side by side. */
+#define LANES 8
+
+/** One 32-bit word from each of LANES blocks, in a GCC vector. */
+typedef uint32_t lanes __attribute__((vector_size(4 * LANES)));
+
+
+static inline void quarter_round(lanes &a, lanes &b, lanes &c, lanes &d)
+{
+  a += b; d ^= a; d = (d << 16) | (d >> 16);
+  c += d; b ^= c; b = (b << 12) | (b >> 20);
+  a += b; d ^= a; d = (d << 8) | (d >> 24);
+  c += d; b ^= c; b = (b << 7) | (b >> 25);
+}
+
+
+/*  ----------------  */
+/* | Public methods | */
+/*  ----------------  */
+ChaCha20::ChaCha20(const unsigned char *key, uint64_t nonce)
+{
+  static const char sigma[] = "expand 32-byte k";
+  for (int i=0; i<4; ++i) {
+    memcpy(&input[i], sigma + 4*i, 4);
+  }
+  for (int i=0; i<8; ++i) {
+    input[4+i] = (uint32_t)key[4*i] | (uint32_t)key[4*i+1] << 8 |
+                 (uint32_t)key[4*i+2] << 16 | (uint32_t)key[4*i+3] << 24;
+  }
+  input[12] = input[13] = 0;
+  input[14] = (uint32_t)nonce;
+  input[15] = (uint32_t)(nonce >> 32);
+}
+
+
+void ChaCha20::keystream(unsigned char *out, size_t size, uint64_t counter) const
+{
+  const size_t batch = LANES * block_size;
+  for (; size >= batch; size -= batch, out += batch, counter += LANES) {
+    blocks(out, counter);
+  }
+  if (size) {
+    unsigned char last[LANES * block_size];
+    blocks(last, counter);
+    memcpy(out, last, size);
+  }
+}
+
+
+void ChaCha20::xor_keystream(unsigned char *data, size_t size, uint64_t counter) const
+{
+  const size_t batch = LANES * block_size;
+  unsigned char stream[LANES * block_size];
+  while (size) {
+    size_t len = size < batch? size : batch;
+    blocks(stream, counter);
+    for (size_t i=0; i<len; ++i) {
+      data[i] ^= stream[i];
+    }
+    size -= len;
+    data += len;
+    counter += LANES;
+  }
+}
+
+
+int ChaCha20::random_key(unsigned char *key)
+{
+  int fd = open("/dev/urandom", O_RDONLY);
+  if (fd == -1) {
+    return -1;
+  }
+  size_t done = 0;
+  while (done < key_size) {
+    ssize_t len = read(fd, key + done, key_size - done);
+    if (len == -1 && errno == EINTR) {
+      continue;
+    } else if (len <= 0) {
+      close(fd);
+      return -1;
+    }
+    done += len;
+  }
+  close(fd);
+  return 0;
+}
+
+
+/*  -----------------  */
+/* | Private methods | */
+/*  -----------------  */
+void ChaCha20::blocks(unsigned char *out, uint64_t counter) const
+{
+  // x[i][l] is word i of block "counter + l"
+  lanes init[16], x[16];
+  for (int i=0; i<16; ++i) {
+    for (int l=0; l<LANES; ++l) {
+      init[i][l] = input[i];
+    }
+  }
+  for (int l=0; l<LANES; ++l) {
+    init[12][l] = (uint32_t)(counter + l);
+    init[13][l] = (uint32_t)((counter + l) >> 32);
+  }
+  memcpy(x, init, sizeof(x));
+
+  for (int round=0; round<10; ++round) {
+    quarter_round(x[0], x[4], x[8], x[12]);
+    quarter_round(x[1], x[5], x[9], x[13]);
+    quarter_round(x[2], x[6], x[10], x[14]);
+    quarter_round(x[3], x[7], x[11], x[15]);
+    quarter_round(x[0], x[5], x[10], x[15]);
+    quarter_round(x[1], x[6], x[11], x[12]);
+    quarter_round(x[2], x[7], x[8], x[13]);
+    quarter_round(x[3], x[4], x[9], x[14]);
+  }
+  for (int i=0; i<16; ++i) {
+    x[i] += init[i];
+  }
+
+  // serialise in little-endian order, one block after another
+  for (int l=0; l<LANES; ++l) {
+    unsigned char *block = out + l * block_size;
+    for (int i=0; i<16; ++i) {
+      uint32_t word = x[i][l];
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+      memcpy(block + 4*i, &word, 4);
+#else
+      block[4*i] = (unsigned char)word;
+      block[4*i+1] = (unsigned char)(word >> 8);
+      block[4*i+2] = (unsigned char)(word >> 16);
+      block[4*i+3] = (unsigned char)(word >> 24);
+#endif
+    }
+  }
+}
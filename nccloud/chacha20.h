@@ -0,0 +1,78 @@
+/**
+  * @file chacha20.h
+  * @brief Declares the ChaCha20 keystream generator.
+  * **/
+
+/* ===================================================================
+Copyright (c) 2026, the NCCloud contributors
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+  - Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+  - Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in
+    the documentation and/or other materials provided with the
+    distribution.
+
+  - Neither the name of the copyright holder nor the
+    names of its contributors may be used to endorse or promote
+    products derived from this software without specific prior written
+    permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT
+HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+=================================================================== */
+
+
+#ifndef NCCLOUD_CHACHA20_H
+#define NCCLOUD_CHACHA20_H
+
+#include <cstddef>
+#include <stdint.h>
+
+
+/** ChaCha20 stream cipher keystream (Bernstein's variant with a 64-bit
+ *  nonce and a 64-bit block counter).  Blocks are generated several at a
+ *  time in lane-parallel form so that the compiler vectorises the rounds.
+ *  Any block can be generated independently, so one keystream can be
+ *  split across threads by block counter. */
+class ChaCha20
+{
+  uint32_t input[16];
+
+  void blocks(unsigned char *out, uint64_t counter) const;
+
+public:
+  /** Size of a key in bytes. */
+  static const size_t key_size = 32;
+  /** Size of a keystream block in bytes. */
+  static const size_t block_size = 64;
+
+  ChaCha20(const unsigned char *key, uint64_t nonce);
+
+  /** Write size bytes of keystream starting at block "counter" to out. */
+  void keystream(unsigned char *out, size_t size, uint64_t counter=0) const;
+
+  /** XOR size bytes of keystream starting at block "counter" into data. */
+  void xor_keystream(unsigned char *data, size_t size, uint64_t counter=0) const;
+
+  /** Fill key with key_size bytes from the kernel's random number generator.
+   *  Returns 0 on success and -1 on failure. */
+  static int random_key(unsigned char *key);
+};
+
+#endif  /* NCCLOUD_CHACHA20_H */
@@ -39,56 +39,417 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 =================================================================== */
 
 
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "aes.h"
+#include "chacha20.h"
 #include "coding.h"
+#include "codings/crs.h"
 #include "codings/fmsr.h"
+#include "codings/liberation.h"
+#include "codings/lrc.h"
 #include "codings/ofmsr.h"
+#include "codings/parity.h"
 #include "codings/replication.h"
 #include "codings/rs.h"
 #include "common.h"
 
+extern "C"
+{
+#include <galois.h>
+#include <jerasure.h>
+}
+
 using namespace std;
 
 
+Coding::Coding(): type(0), param_k(0), param_n(0), param_t(0), param_w(0)
+{
+}
+
+
 Coding *Coding::use_coding(int type, int k, int n, int t, int w)
 {
+  Coding *coding;
   switch (type) {
-    case 0:
-      return new FMSRCode(k, n, w);
     case 1:
-      return new RSCode(k, n, w);
+      coding = new RSCode(k, n, w);
+      break;
     case 2:
-      return new Replication(k, n, w);
-	 case 3:
-      return new OFMSRCode(k, n, t, w);
+      coding = new Replication(k, n, w);
+      break;
+    case 3:
+      coding = new OFMSRCode(k, n, t, w);
+      break;
+    case 4:
+      coding = new CRSCode(k, n, w);
+      break;
+    case 5:
+      coding = new LRCCode(k, n, w);
+      break;
+    case 6:
+      coding = new LiberationCode(k, n, w, LiberationCode::LIBERATION);
+      break;
+    case 7:
+      coding = new LiberationCode(k, n, w, LiberationCode::BLAUM_ROTH);
+      break;
+    case 8:
+      coding = new LiberationCode(k, n, w, LiberationCode::LIBER8TION);
+      break;
+    case 9:
+      coding = new ParityCode(k, n, w);
+      break;
+    case 0:
     default:
-      return new FMSRCode(k, n, w);
+      type = 0;
+      coding = new FMSRCode(k, n, w);
+  }
+  coding->type = type;
+  coding->param_k = k;
+  coding->param_n = n;
+  coding->param_t = t;
+  coding->param_w = w;
+  return coding;
+}
+
+
+int Coding::init(map<string,string> &coding_param)
+{
+  // encryption at rest is the only optional field common to all schemes
+  if (coding_param.count("encrypt_keyfile") == 1) {
+    if (!encryption()) {
+      print_error(stringstream() << "[Coding] encrypt_keyfile is not supported by coding type "
+                                 << type << "." << endl);
+      return -1;
+    }
+    if (read_keyfile(coding_param["encrypt_keyfile"], encryption_key) == -1) {
+      print_error(stringstream() << "[Coding] encrypt_keyfile must hold at least "
+                                 << AESCTR::key_size << " bytes." << endl);
+      return -1;
+    }
+  }
+  return 0;
+}
+
+
+int Coding::encryption(void)
+{
+  return 0;
+}
+
+
+int Coding::buffered_io(void)
+{
+  return 0;
+}
+
+
+int Coding::encode_buffer(string &dstdir, string &srcdir, string &filename,
+                          char* &chunks, size_t &chunksize)
+{
+  string src = srcdir + '/' + filename;
+  return encode_segment(dstdir, src, 0, file_size(src), filename, chunks, chunksize);
+}
+
+
+int Coding::encode_segment(string &dstdir, string &src, size_t offset, size_t size,
+                           string &filename, char* &chunks, size_t &chunksize)
+{
+  // chunks only go through files by default
+  return -1;
+}
+
+
+int Coding::decode_buffer(string &dst, string &srcdir, string &filename,
+                          vector<int> &chunk_indices, vector<char *> &chunks)
+{
+  // chunks only go through files by default
+  return -1;
+}
+
+
+int Coding::decode_nodes(vector<int> &healthy_nodes, vector<int> &nodes_to_retrieve)
+{
+  // any k nodes will do by default
+  if (healthy_nodes.size() < (unsigned int)getk()) {
+    return -1;
+  }
+  nodes_to_retrieve.assign(healthy_nodes.begin(), healthy_nodes.begin()+getk());
+  return 0;
+}
+
+
+int Coding::chunks_are_copies(void)
+{
+  return 0;
+}
+
+
+int Coding::striped_read_ranges(string &srcdir, string &filename, int num_nodes,
+                                vector<size_t> &offsets, vector<size_t> &lengths)
+{
+  // chunks are downloaded whole by default
+  return -1;
+}
+
+
+int Coding::range_reads(string &srcdir, string &filename, vector<int> &chunk_indices,
+                        size_t offset, size_t length, vector<ChunkRange> &ranges)
+{
+  // files are decoded whole by default
+  return -1;
+}
+
+
+int Coding::decode_range(string &dst, string &srcdir, string &filename,
+                         vector<int> &chunk_indices, size_t offset, size_t length)
+{
+  return -1;
+}
+
+
+int Coding::dummy_chunks_on_node(int node, vector<int> &chunk_indices)
+{
+  // no dummy chunks by default
+  return 0;
+}
+
+
+int Coding::generate_dummy_chunk(string &filename, int chunk_index,
+                                 char* &data, size_t &size)
+{
+  // no dummy chunks by default
+  return -1;
+}
+
+
+void Coding::write_segments(string &dstdir, string &filename, size_t filesize,
+                            vector<MetadataStripe> &segments)
+{
+  string dst = dstdir + '/' + filename;
+  Metadata meta;
+  meta.header.filesize = filesize;
+  meta.stripes = segments;
+  save_metadata(dst, meta);
+}
+
+
+int Coding::read_segments(string &srcdir, string &filename, vector<MetadataStripe> &segments)
+{
+  string src = srcdir + '/' + filename;
+  Metadata meta;
+  load_metadata(src, meta);
+  segments = meta.stripes;
+  if (segments.size() == 1 && (segments[0].flags & MetadataStripe::in_place)) {
+    segments.clear();
   }
+  return segments.size();
+}
+
+
+void Coding::write_stripe(string &dstdir, string &filename, MetadataStripe &stripe)
+{
+  string dst = dstdir + '/' + filename;
+  Metadata meta;
+  load_metadata(dst, meta);
+  meta.stripes.assign(1, stripe);
+  meta.stripes[0].flags |= MetadataStripe::in_place;
+  save_metadata(dst, meta);
+}
+
+
+int Coding::read_stripe(string &srcdir, string &filename, MetadataStripe &stripe)
+{
+  string src = srcdir + '/' + filename;
+  Metadata meta;
+  load_metadata(src, meta);
+  if (meta.stripes.size() != 1 || !(meta.stripes[0].flags & MetadataStripe::in_place)) {
+    return -1;
+  }
+  stripe = meta.stripes[0];
+  return 0;
+}
+
+
+size_t Coding::chunk_size(string &srcdir, string &filename)
+{
+  string src = srcdir + '/' + filename;
+  size_t chunksize = 0;
+  read_metadata(src, chunksize);
+  return chunksize;
+}
+
+
+string Coding::segment_name(string &filename, int index)
+{
+  return filename + ".seg" + to_string(index);
 }
 
 
 void Coding::read_metadata(string &path, size_t &chunksize)
 {
   // read chunk size from existing metadata
+  Metadata meta;
+  load_metadata(path, meta);
+  chunksize = meta.header.chunksize;
+}
+
+
+void Coding::write_metadata(string &path, size_t chunksize, size_t filesize,
+                            uint64_t key_nonce)
+{
+  // write chunk size to metadata
+  Metadata meta;
+  meta.header.chunksize = chunksize;
+  meta.header.filesize = filesize;
+  meta.header.key_nonce = key_nonce;
+  save_metadata(path, meta);
+}
+
+
+void Coding::load_metadata(string &path, Metadata &meta)
+{
   string meta_path = path + ".meta";
-  FILE *metafile = fopen(meta_path.c_str(), "rb");
-  if (metafile == NULL) {
-    show_file_error("fopen", meta_path.c_str(), NULL);
+  string data;
+  if (meta.load(meta_path, data) == -1) {
+    // legacy metadata does not record the coding, so it is taken to be this
+    // one; the copy is rewritten in the binary format, which is what repairs
+    // upload from then on
+    meta = Metadata();
+    if (parse_legacy_metadata(data, meta) == -1) {
+      print_error(stringstream() << "[Coding] invalid metadata: " << meta_path << endl);
+      exit(-1);
+    }
+    meta.header.filesize = Metadata::unknown_filesize;
+    save_metadata(path, meta);
   }
-  char stchunksize[21] = {0};
-  if (fread(stchunksize, 1, 20, metafile) <= 0) {
-    show_file_error("fread", meta_path.c_str(), metafile);
+  if (meta.header.coding_type != type) {
+    print_error(stringstream() << "[Coding] " << meta_path << " was written by coding type "
+                               << meta.header.coding_type << ", not " << type << endl);
+    exit(-1);
   }
-  chunksize = strtoul(stchunksize, NULL, 10);
-  fclose(metafile);
 }
 
 
-void Coding::write_metadata(string &path, size_t chunksize)
+int Coding::parse_legacy_metadata(string &data, Metadata &meta)
+{
+  // the chunk size in ASCII
+  if (data.empty() || strspn(data.c_str(), "0123456789") != data.size()) {
+    return -1;
+  }
+  meta.header.chunksize = strtoull(data.c_str(), NULL, 10);
+  return 0;
+}
+
+
+void Coding::save_metadata(string &path, Metadata &meta)
 {
-  // write chunk size to metadata
   string meta_path = path + ".meta";
-  string stchunksize = to_string(chunksize);
-  write_file(meta_path, (char *)stchunksize.c_str(), stchunksize.length());
+  meta.header.coding_type = type;
+  meta.header.k = param_k;
+  meta.header.n = param_n;
+  meta.header.t = param_t;
+  meta.header.w = param_w;
+  meta.store(meta_path);
+}
+
+
+int Coding::read_keyfile(string &keyfile, string &key)
+{
+  FILE *fp = fopen(keyfile.c_str(), "rb");
+  char buf[AESCTR::key_size];
+  int result = (fp != NULL && fread(buf, 1, sizeof(buf), fp) == sizeof(buf))? 0 : -1;
+  if (fp) {
+    fclose(fp);
+  }
+  if (result == 0) {
+    key.assign(buf, sizeof(buf));
+  }
+  memset(buf, 0, sizeof(buf));
+  return result;
+}
+
+
+uint64_t Coding::new_key_nonce(void)
+{
+  uint64_t key_nonce = 0;
+  unsigned char random[ChaCha20::key_size];
+  while (!encryption_key.empty() && key_nonce == 0) {
+    if (ChaCha20::random_key(random) == -1) {
+      show_error("random_key");
+    }
+    memcpy(&key_nonce, random, sizeof(key_nonce));
+  }
+  return key_nonce;
+}
+
+
+uint64_t Coding::read_key_nonce(string &path)
+{
+  Metadata meta;
+  load_metadata(path, meta);
+  if (meta.header.key_nonce != 0 && encryption_key.empty()) {
+    print_error(stringstream() << "[Coding] " << path << " is encrypted; "
+                               << "encrypt_keyfile is required to decode it." << endl);
+    exit(-1);
+  }
+  return meta.header.key_nonce;
+}
+
+
+uint64_t Coding::read_filesize(string &path)
+{
+  Metadata meta;
+  load_metadata(path, meta);
+  return meta.header.filesize;
+}
+
+
+void Coding::crypt_range(uint64_t key_nonce, int chunk_index, size_t offset,
+                         char *data, size_t size)
+{
+  if (key_nonce == 0 || size == 0) {
+    return;
+  }
+
+  // the file key is the first two AES-CTR blocks of the master key under the
+  // nonce of the file, and each data chunk has a keystream of its own under it
+  unsigned char file_key[AESCTR::key_size];
+  AESCTR((unsigned char *)encryption_key.data(), key_nonce).keystream(file_key,
+                                                                     sizeof(file_key));
+  AESCTR cipher(file_key, chunk_index);
+  memset(file_key, 0, sizeof(file_key));
+
+  // a range may start in the middle of a keystream block
+  size_t head = offset % AESCTR::block_size;
+  if (head) {
+    unsigned char block[AESCTR::block_size];
+    cipher.keystream(block, sizeof(block), offset / AESCTR::block_size);
+    size_t head_size = min(size, AESCTR::block_size - head);
+    for (size_t i=0; i<head_size; ++i) {
+      data[i] ^= block[head + i];
+    }
+    data += head_size;
+    offset += head_size;
+    size -= head_size;
+  }
+  cipher.xor_keystream((unsigned char *)data, size, offset / AESCTR::block_size);
+}
+
+
+size_t Coding::crypt_tile_size(int num_chunks)
+{
+  // tiles of all chunks together fill about half of a typical L2 cache
+  size_t tile = (256 << 10) / max(num_chunks, 1);
+  return max(tile - tile % AESCTR::block_size, (size_t)4096);
 }
 
 
@@ -96,6 +457,7 @@ void Coding::read_chunks(string &path, size_t chunksize,
                          vector<int> &chunk_indices, char *chunks)
 {
   // read chunks stored as path.chunk_ into a single buffer "chunks"
+  // (a buffered read, as the chunks are copied into place either way)
   string chunk_partial_path = path + ".chunk";
   for (unsigned int i=0; i<chunk_indices.size(); ++i) {
     string chunk_path = chunk_partial_path + to_string(chunk_indices[i]);
@@ -122,3 +484,263 @@ void Coding::write_chunks(string &path, size_t chunksize,
   }
 }
 
+
+void Coding::append_chunk(int fd, string &dst, string &chunk_path, size_t chunksize)
+{
+  // copy a whole chunk file to the end of fd, in-kernel where possible
+  int infd = open(chunk_path.c_str(), O_RDONLY);
+  if (infd == -1) {
+    show_file_error("open", chunk_path.c_str(), NULL);
+  }
+  size_t copied = 0;
+  while (copied < chunksize) {
+    ssize_t ret = copy_file_range(infd, NULL, fd, NULL, chunksize-copied, 0);
+    if (ret == -1 && copied == 0 &&
+        (errno == ENOSYS || errno == EXDEV || errno == EINVAL || errno == EOPNOTSUPP)) {
+      break;  // fall back to read() and write() below
+    }
+    if (ret <= 0) {
+      show_file_error("copy_file_range", chunk_path.c_str(), NULL);
+    }
+    copied += ret;
+  }
+  if (copied < chunksize) {
+    // read() may return less than asked for, so read until the chunk is
+    // complete (running into its end first means the chunk is short)
+    size_t size = chunksize - copied;
+    char *buf = new char[size];
+    for (size_t done = 0; done < size; ) {
+      ssize_t ret = read(infd, buf + done, size - done);
+      if (ret <= 0) {
+        show_file_error("read", chunk_path.c_str(), NULL);
+      }
+      done += ret;
+    }
+    append_data(fd, dst, buf, size);
+    delete[] buf;
+  }
+  close(infd);
+}
+
+
+void Coding::append_data(int fd, string &dst, char *data, size_t size)
+{
+  while (size > 0) {
+    ssize_t ret = write(fd, data, size);
+    if (ret <= 0) {
+      show_file_error("write", dst.c_str(), NULL);
+    }
+    data += ret;
+    size -= ret;
+  }
+}
+
+
+size_t Coding::padded_size(size_t size, size_t unit)
+{
+  return (size/unit + 1) * unit;
+}
+
+
+void Coding::pad_data(char *data, size_t data_size, size_t unit)
+{
+  data[data_size] = 1;
+  memset(data+data_size+1, 0, padded_size(data_size, unit)-data_size-1);
+}
+
+
+size_t Coding::unpad_data(char *data, size_t data_size)
+{
+  // unpad starting from the end of padded data
+  char *ptr = &data[data_size-1];
+  if (*ptr) { return *ptr==1? data_size-1 : 0; }
+  for (size_t i=data_size; i; i--, ptr--) {
+    if (*ptr) { return i-1; }
+  }
+  return 0;
+}
+
+
+void Coding::trim_padding(int fd, string &dst, size_t padded_filesize, size_t unit)
+{
+  size_t tailsize = min(padded_filesize, unit);
+  char *tail = new char[tailsize];
+  if (pread(fd, tail, tailsize, padded_filesize-tailsize) != (ssize_t)tailsize) {
+    show_file_error("pread", dst.c_str(), NULL);
+  }
+  size_t decoded_filesize = padded_filesize - tailsize + unpad_data(tail, tailsize);
+  delete[] tail;
+  if (ftruncate(fd, decoded_filesize) == -1) {
+    show_file_error("ftruncate", dst.c_str(), NULL);
+  }
+}
+
+
+int *Coding::decoding_rows(int k, int w, int *coding_matrix,
+                           vector<int> &sources, vector<int> &targets)
+{
+  // generator rows of the k source chunks, inverted to map sources to data
+  int *matrix = new int[k*k];
+  int *inverse = new int[k*k];
+  memset(matrix, 0, k*k*sizeof(int));
+  for (int i=0; i<k; ++i) {
+    if (sources[i] < k) {
+      matrix[i*k + sources[i]] = 1;
+    } else {
+      memcpy(matrix + i*k, coding_matrix + (sources[i]-k)*k, k*sizeof(int));
+    }
+  }
+  if (jerasure_invert_matrix(matrix, inverse, k, w) == -1) {
+    print_error(stringstream() << "[Coding] retrieved chunks are not decodable." << endl);
+    delete[] matrix;
+    delete[] inverse;
+    return NULL;
+  }
+  delete[] matrix;
+
+  // a data chunk is a row of the inverse; a code chunk is its generator row times it
+  int *rows = new int[targets.size() * k];
+  for (unsigned int t=0; t<targets.size(); ++t) {
+    int *row = rows + t*k;
+    if (targets[t] < k) {
+      memcpy(row, inverse + targets[t]*k, k*sizeof(int));
+      continue;
+    }
+    int *coeffs = coding_matrix + (targets[t]-k)*k;
+    for (int j=0; j<k; ++j) {
+      row[j] = 0;
+      for (int l=0; l<k; ++l) {
+        row[j] ^= galois_single_multiply(coeffs[l], inverse[l*k + j], w);
+      }
+    }
+  }
+  delete[] inverse;
+  return rows;
+}
+
+
+void Coding::read_chunk_range(string &path, int chunk_index, size_t offset, size_t length,
+                              char *data)
+{
+  string chunk_path = path + ".chunk" + to_string(chunk_index);
+  int fd = open(chunk_path.c_str(), O_RDONLY);
+  if (fd == -1) {
+    show_file_error("open", chunk_path.c_str(), NULL);
+  }
+  while (length > 0) {
+    ssize_t ret = pread(fd, data, length, offset);
+    if (ret <= 0) {
+      show_file_error("pread", chunk_path.c_str(), NULL);
+    }
+    data += ret;
+    offset += ret;
+    length -= ret;
+  }
+  close(fd);
+}
+
+
+void Coding::add_range(vector<ChunkRange> &ranges, int chunk_index, size_t offset, size_t length)
+{
+  for (auto &r : ranges) {
+    if (r.chunk_index == chunk_index && offset <= r.offset + r.length &&
+        r.offset <= offset + length) {
+      size_t end = max(r.offset + r.length, offset + length);
+      r.offset = min(r.offset, offset);
+      r.length = end - r.offset;
+      return;
+    }
+  }
+  ranges.push_back((ChunkRange){chunk_index, offset, length});
+}
+
+
+void Coding::split_range(size_t chunksize, size_t begin, size_t end, vector<ChunkRange> &pieces)
+{
+  while (begin < end) {
+    int chunk_index = begin / chunksize;
+    size_t chunk_end = min(end, (chunk_index+1) * chunksize);
+    pieces.push_back((ChunkRange){chunk_index, begin - chunk_index*chunksize, chunk_end - begin});
+    begin = chunk_end;
+  }
+}
+
+
+size_t Coding::file_size(string &path)
+{
+  struct stat st;
+  if (stat(path.c_str(), &st) == -1) {
+    show_file_error("stat", path.c_str(), NULL);
+  }
+  return st.st_size;
+}
+
+
+char *Coding::map_input(string &path, size_t size, size_t capacity, size_t offset)
+{
+  if (capacity == 0) {
+    return NULL;
+  }
+
+  // zero-filled anonymous memory for the whole capacity, with the file mapped
+  // privately over its start
+  char *start = (char *)mmap(NULL, capacity, PROT_READ | PROT_WRITE,
+                             MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (start == MAP_FAILED) {
+    show_file_error("mmap", path.c_str(), NULL);
+  }
+  if (size > 0) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd == -1) {
+      show_file_error("open", path.c_str(), NULL);
+    }
+    struct stat st;
+    if (fstat(fd, &st) == -1 || (size_t)st.st_size < offset + size) {
+      errno = EIO;  // mapping a short file would fault past its end
+      show_file_error("mmap", path.c_str(), NULL);
+    }
+    if (mmap(start, size, PROT_READ | PROT_WRITE,
+             MAP_PRIVATE | MAP_FIXED | MAP_POPULATE, fd, offset) == MAP_FAILED) {
+      show_file_error("mmap", path.c_str(), NULL);
+    }
+    close(fd);
+    madvise(start, size, MADV_SEQUENTIAL);
+
+    // the last page of a range may hold the file's following bytes
+    size_t page_size = sysconf(_SC_PAGESIZE);
+    size_t tail = min(capacity, (size + page_size - 1) / page_size * page_size) - size;
+    if (offset + size < (size_t)st.st_size && tail > 0) {
+      memset(start + size, 0, tail);
+    }
+  }
+  return start;
+}
+
+
+char *Coding::map_output(string &path, size_t size)
+{
+  int fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (fd == -1) {
+    show_file_error("open", path.c_str(), NULL);
+  }
+  if (ftruncate(fd, size) == -1) {
+    show_file_error("ftruncate", path.c_str(), NULL);
+  }
+  char *start = NULL;
+  if (size > 0) {
+    start = (char *)mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (start == MAP_FAILED) {
+      show_file_error("mmap", path.c_str(), NULL);
+    }
+  }
+  close(fd);
+  return start;
+}
+
+
+void Coding::unmap_file(char *start, size_t size)
+{
+  if (start != NULL && size > 0) {
+    munmap(start, size);
+  }
+}
@@ -42,13 +42,31 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef NCCLOUD_CODING_H
 #define NCCLOUD_CODING_H
 
+#include <map>
 #include <string>
 #include <vector>
 
+#include "metadata.h"
+
+
+/** A byte range of a chunk. */
+struct ChunkRange
+{
+  int chunk_index;  /**< index of the chunk */
+  size_t offset;    /**< offset of the first byte of the range */
+  size_t length;    /**< number of bytes in the range */
+};
+
 
 /** Abstract base class for coding modules. */
 class Coding
 {
+  /** Coding type and parameters given to use_coding(), recorded in metadata. */
+  int type, param_k, param_n, param_t, param_w;
+
+  /** Master key for encryption at rest, from the encrypt_keyfile field (empty for none). */
+  std::string encryption_key;
+
 protected:
   /** Read metadata from disk.
    *  @param[in]       path path to metadata without the ".meta" suffix
@@ -58,8 +76,79 @@ protected:
 
   /** Write metadata to disk.
    *  @param[in]      path path to metadata without the ".meta" suffix
-   *  @param[in] chunksize chunk size to write to the metadata */
-  virtual void write_metadata(std::string &path, size_t chunksize);
+   *  @param[in] chunksize chunk size to write to the metadata
+   *  @param[in]  filesize size of the original file
+   *  @param[in] key_nonce key nonce of the file (see new_key_nonce()) */
+  virtual void write_metadata(std::string &path, size_t chunksize, size_t filesize,
+                              uint64_t key_nonce=0);
+
+
+  /** Load and check a metadata file written by this coding scheme.  Metadata
+   *  in the legacy format is converted (see parse_legacy_metadata()), and the
+   *  file rewritten in the binary format.
+   *  Exits if the file cannot be read or was written by another scheme.
+   *  @param[in]  path path to metadata without the ".meta" suffix
+   *  @param[out] meta the parsed metadata */
+  void load_metadata(std::string &path, Metadata &meta);
+
+
+  /** Parse metadata in the legacy format, written before the binary format
+   *  (by default the chunk size in ASCII).  Only the chunk size, repair hints
+   *  and payload are filled in; the size of the original file is unknown.
+   *  @param[in]  data contents of the metadata file
+   *  @param[out] meta the parsed metadata
+   *  @return 0 on success, -1 if data is not metadata in the legacy format */
+  virtual int parse_legacy_metadata(std::string &data, Metadata &meta);
+
+
+  /** Fill in the coding type and parameters of the header and save metadata.
+   *  @param[in] path path to metadata without the ".meta" suffix
+   *  @param[in] meta metadata to save */
+  void save_metadata(std::string &path, Metadata &meta);
+
+
+  /** Read the first AESCTR::key_size bytes of a key file.
+   *  @param[in] keyfile pathname of the key file
+   *  @param[out]    key the key read
+   *  @return 0 on success, -1 if the file cannot be read or is too short */
+  static int read_keyfile(std::string &keyfile, std::string &key);
+
+
+  /** Pick the key nonce of a file about to be encoded, from which the key its
+   *  data chunks are encrypted under is derived.
+   *  @return a random nonzero nonce, or 0 if encryption is off */
+  uint64_t new_key_nonce(void);
+
+
+  /** Return the key nonce in the metadata of a file.  Exits if the file is
+   *  encrypted but no key was given.
+   *  @param[in] path path to metadata without the ".meta" suffix
+   *  @return the key nonce, or 0 if the file is not encrypted */
+  uint64_t read_key_nonce(std::string &path);
+
+
+  /** Return the size of the original file recorded in the metadata of a file.
+   *  @param[in] path path to metadata without the ".meta" suffix
+   *  @return the file size, or Metadata::unknown_filesize for metadata
+   *          converted from the legacy format */
+  uint64_t read_filesize(std::string &path);
+
+
+  /** Encrypt or decrypt (the same operation) a byte range of a data chunk in
+   *  place, XORing it with the AES-256-CTR keystream of the chunk under the file key.
+   *  @param[in]   key_nonce key nonce of the file (nothing is done if 0)
+   *  @param[in] chunk_index index of the data chunk
+   *  @param[in]      offset offset of the range in the chunk
+   *  @param[in,out]    data the range
+   *  @param[in]        size size of the range */
+  void crypt_range(uint64_t key_nonce, int chunk_index, size_t offset, char *data, size_t size);
+
+
+  /** Return the size of the tiles that encryption and coding take turns on,
+   *  so that a tile is still in the cache when the other one gets to it.
+   *  @param[in] num_chunks number of chunks a tile spans
+   *  @return a multiple of AESCTR::block_size */
+  static size_t crypt_tile_size(int num_chunks);
 
 
   /** Read chunks from disk to a single char buffer.
@@ -82,7 +171,131 @@ protected:
                             std::vector<int> &chunk_indices, char *chunks);
 
 
+  /** Append a whole chunk file to an open file, in-kernel where possible.
+   *  @param[in]         fd descriptor of the file being written
+   *  @param[in]        dst pathname of the file being written (for errors)
+   *  @param[in] chunk_path pathname of the chunk to append
+   *  @param[in]  chunksize size of a chunk */
+  void append_chunk(int fd, std::string &dst, std::string &chunk_path, size_t chunksize);
+
+
+  /** Append a buffer to an open file.
+   *  @param[in]   fd descriptor of the file being written
+   *  @param[in]  dst pathname of the file being written (for errors)
+   *  @param[in] data buffer to append
+   *  @param[in] size size of the buffer */
+  void append_data(int fd, std::string &dst, char *data, size_t size);
+
+
+  /** Return the size of data after pad_data(): the next multiple of unit
+   *  strictly greater than size, so that there is always some padding.
+   *  @param[in] size size of the data
+   *  @param[in] unit size the padded data is a multiple of
+   *  @return the padded size */
+  static size_t padded_size(size_t size, size_t unit);
+
+
+  /** Pad data in place with a 1 byte followed by zeros.
+   *  @param[in,out]      data buffer of at least padded_size(data_size, unit) bytes
+   *  @param[in]     data_size size of the data
+   *  @param[in]          unit size the padded data is a multiple of */
+  static void pad_data(char *data, size_t data_size, size_t unit);
+
+
+  /** Return the size of data before pad_data().
+   *  @param[in]      data padded data, or its tail
+   *  @param[in] data_size size of the padded data
+   *  @return the size without the padding */
+  static size_t unpad_data(char *data, size_t data_size);
+
+
+  /** Truncate an open file holding padded data to the size of the original
+   *  data.  Padding never exceeds one unit, so only the last unit is read.
+   *  @param[in]              fd descriptor of the padded file
+   *  @param[in]             dst pathname of the padded file (for errors)
+   *  @param[in] padded_filesize size of the padded file
+   *  @param[in]            unit size the padded data is a multiple of */
+  static void trim_padding(int fd, std::string &dst, size_t padded_filesize, size_t unit);
+
+
+  /** Compute the coefficients that rebuild chunks of a systematic code over
+   *  GF(2^w) from k chunks that are known to span the data.  Chunks [0,k)
+   *  are the data chunks; chunk k+i is generated by row i of coding_matrix.
+   *  @param[in]             k number of data chunks
+   *  @param[in]             w word size of the code
+   *  @param[in] coding_matrix rows of k coefficients generating the code chunks
+   *  @param[in]       sources indices of the k chunks decoded from
+   *  @param[in]       targets indices of the chunks to rebuild
+   *  @return one row of k coefficients per target, applied to the sources in
+   *          order (free with delete[]), or NULL if the sources are not
+   *          decodable */
+  static int *decoding_rows(int k, int w, int *coding_matrix,
+                            std::vector<int> &sources, std::vector<int> &targets);
+
+
+  /** Read a byte range of a chunk file, which may hold only the ranges that
+   *  were retrieved (see range_reads()).
+   *  @param[in]        path path to chunks without the ".chunk_" suffix
+   *  @param[in] chunk_index index of the chunk to read
+   *  @param[in]      offset offset of the first byte to read
+   *  @param[in]      length number of bytes to read
+   *  @param[out]       data buffer of at least length bytes */
+  void read_chunk_range(std::string &path, int chunk_index, size_t offset, size_t length,
+                        char *data);
+
+
+  /** Add a chunk range to a list, merging it into a range of the same chunk
+   *  that it overlaps or touches. */
+  static void add_range(std::vector<ChunkRange> &ranges, int chunk_index,
+                        size_t offset, size_t length);
+
+
+  /** Split a byte range of a padded file, laid out as consecutive chunks of
+   *  chunksize bytes, into one range per chunk.
+   *  @param[in] chunksize size of a chunk
+   *  @param[in]     begin offset of the first byte of the range
+   *  @param[in]       end offset past the last byte of the range
+   *  @param[out]   pieces ranges of the chunks, in file order */
+  static void split_range(size_t chunksize, size_t begin, size_t end,
+                          std::vector<ChunkRange> &pieces);
+
+
+  /** Return the size of a file.
+   *  @param[in] path pathname of the file */
+  size_t file_size(std::string &path);
+
+
+  /** Map a file into memory for reading, prefaulted and read ahead sequentially.
+   *  The mapping is private and writable, and bytes past the end of the file
+   *  (or of the range mapped) read as zero, so it can be padded in place
+   *  without touching the file.
+   *  @param[in]     path pathname of the file
+   *  @param[in]     size size of the file (or of the range to map)
+   *  @param[in] capacity size of the mapping (at least size)
+   *  @param[in]   offset start of the range to map (a multiple of the page size)
+   *  @return start of the mapping (NULL if capacity is 0);
+   *          release with unmap_file(start, capacity) */
+  char *map_input(std::string &path, size_t size, size_t capacity, size_t offset=0);
+
+
+  /** Create (or truncate) a file of a given size and map it for writing, so
+   *  that its contents can be computed directly in the page cache.
+   *  @param[in] path pathname of the file
+   *  @param[in] size size of the file
+   *  @return start of the mapping (NULL if size is 0);
+   *          release with unmap_file(start, size) */
+  char *map_output(std::string &path, size_t size);
+
+
+  /** Release a mapping from map_input() or map_output(). */
+  void unmap_file(char *start, size_t size);
+
+
 public:
+  Coding();
+  virtual ~Coding() {}
+
+
   /** Return an instance of a coding scheme, based on user's choice.
    *  @param[in] type choice of coding scheme (0, 1 or 2)
    *  @param[in]    k number of nodes required to reconstruct data
@@ -92,6 +305,12 @@ public:
   static Coding *use_coding(int type, int k, int n, int t, int w);
 
 
+  /** Initialize the Coding instance based on optional fields in coding_param.
+   *  @param[in] coding_param dictionary of parameters under [Coding]
+   *  @return 0 on success, -1 on failure (e.g., invalid parameters) */
+  virtual int init(std::map<std::string, std::string> &coding_param);
+
+
   /** Encode a file at srcdir/filename into chunks stored under dstdir.
    *  @param[in]   dstdir destination directory where encoded chunks are stored
    *  @param[in]   srcdir source directory of source file to be encoded
@@ -110,6 +329,113 @@ public:
                           std::vector<int> &chunk_indices) = 0;
 
 
+  /** Tell whether files can be encrypted at rest (the encrypt_keyfile field).
+   *  @return 1 if supported, 0 otherwise */
+  virtual int encryption(void);
+
+
+  /** Tell whether encode_buffer() and decode_buffer() are supported, so that
+   *  chunks can move between memory and the repositories without chunk files.
+   *  @return 1 if supported, 0 otherwise */
+  virtual int buffered_io(void);
+
+
+  /** Encode a file at srcdir/filename into chunks held in memory.  Only the
+   *  metadata is written under dstdir.  Same as encode_segment() on the whole file.
+   *  @param[in]     dstdir destination directory where the metadata is stored
+   *  @param[in]     srcdir source directory of source file to be encoded
+   *  @param[in]   filename filename of source file to be encoded
+   *  @param[out]    chunks buffer from BufferArena holding all chunks in index order
+   *                        (give it back with release())
+   *  @param[out] chunksize size of a chunk
+   *  @return 0 on success, -1 on failure */
+  int encode_buffer(std::string &dstdir, std::string &srcdir, std::string &filename,
+                    char* &chunks, size_t &chunksize);
+
+
+  /** Encode a byte range of a file into chunks held in memory, as if the range
+   *  were a file of its own named filename.  Only the metadata is written under
+   *  dstdir.  May be called from several threads at once.
+   *  @param[in]     dstdir destination directory where the metadata is stored
+   *  @param[in]        src pathname of source file
+   *  @param[in]     offset start of the range (a multiple of the page size)
+   *  @param[in]       size size of the range
+   *  @param[in]   filename name given to the encoded range
+   *  @param[out]    chunks buffer from BufferArena holding all chunks in index order
+   *                        (give it back with release())
+   *  @param[out] chunksize size of a chunk
+   *  @return 0 on success, -1 on failure */
+  virtual int encode_segment(std::string &dstdir, std::string &src, size_t offset, size_t size,
+                             std::string &filename, char* &chunks, size_t &chunksize);
+
+
+  /** Reconstruct a file from chunks held in memory into dst.
+   *  May be called from several threads at once.
+   *  @param[in]           dst pathname of reconstructed file
+   *  @param[in]        srcdir directory where retrieved metadata is at
+   *  @param[in]      filename filename of file to reconstruct
+   *  @param[in] chunk_indices Indices of chunks retrieved for use in decoding
+   *  @param[in]        chunks retrieved chunks, following order in chunk_indices
+   *  @return 0 on success, -1 on failure */
+  virtual int decode_buffer(std::string &dst, std::string &srcdir, std::string &filename,
+                            std::vector<int> &chunk_indices, std::vector<char *> &chunks);
+
+
+  /** Choose the byte ranges of the chunks needed to decode a byte range of a
+   *  file, so that only those are downloaded.  The range is clipped to the
+   *  size of the file.
+   *  @param[in]        srcdir directory where retrieved metadata is at
+   *  @param[in]      filename filename of file to read
+   *  @param[in] chunk_indices Indices of chunks that can be retrieved (as for decode_file())
+   *  @param[in]        offset offset of the first byte of the file to decode
+   *  @param[in]        length number of bytes to decode
+   *  @param[out]       ranges chunk ranges to retrieve into sparse chunk files under srcdir
+   *  @return 0 on success, -1 if ranged decoding is not supported */
+  virtual int range_reads(std::string &srcdir, std::string &filename,
+                          std::vector<int> &chunk_indices, size_t offset, size_t length,
+                          std::vector<ChunkRange> &ranges);
+
+
+  /** Decode a byte range of a file from the chunk ranges chosen by range_reads().
+   *  May be called from several threads at once.
+   *  @param[in]           dst pathname of the decoded range
+   *  @param[in]        srcdir directory where retrieved metadata and chunk ranges are at
+   *  @param[in]      filename filename of file to read
+   *  @param[in] chunk_indices same as given to range_reads()
+   *  @param[in]        offset offset of the first byte of the file to decode
+   *  @param[in]        length number of bytes to decode
+   *  @return 0 on success, -1 on failure */
+  virtual int decode_range(std::string &dst, std::string &srcdir, std::string &filename,
+                           std::vector<int> &chunk_indices, size_t offset, size_t length);
+
+
+  /** Choose the healthy nodes to download chunks from for decoding.
+   *  @param[in]       healthy_nodes list of healthy nodes, in order of preference
+   *  @param[out] nodes_to_retrieve nodes whose chunks suffice for decoding
+   *  @return 0 on success, -1 on failure (e.g., too few healthy nodes) */
+  virtual int decode_nodes(std::vector<int> &healthy_nodes, std::vector<int> &nodes_to_retrieve);
+
+
+  /** Tell whether every chunk is an exact copy of the source file, in which case
+   *  encode_file() only writes the metadata and the source file itself is
+   *  uploaded as each chunk.
+   *  @return 1 if chunks are copies of the source file, 0 otherwise */
+  virtual int chunks_are_copies(void);
+
+
+  /** Split the chunk to read into byte ranges, one per node, so that they can be
+   *  downloaded in parallel.  Only codings where every node stores a full copy
+   *  of the same chunk (e.g., replication) support this.
+   *  @param[in]     srcdir directory where retrieved metadata is at
+   *  @param[in]   filename filename of file to read
+   *  @param[in]  num_nodes number of nodes to read from
+   *  @param[out]   offsets offset of the range to read from each node
+   *  @param[out]   lengths length of the range to read from each node (may be 0)
+   *  @return 0 on success, -1 if striped reads are not supported */
+  virtual int striped_read_ranges(std::string &srcdir, std::string &filename, int num_nodes,
+                                  std::vector<size_t> &offsets, std::vector<size_t> &lengths);
+
+
   /** Setup repair and inform the user which chunks to retrieve for use in repair.
    *  @param[in]              srcdir directory where retrieved metadata is at
    *  @param[in]            filename filename of file to repair
@@ -157,6 +483,75 @@ public:
   virtual int chunks_on_node(int node, std::vector<int> &chunk_indices) = 0;
 
 
+  /** Return the indices of the dummy chunks on a specified node.  Dummy chunks
+   *  carry no data and only obfuscate the real ones: they are uploaded,
+   *  repaired and deleted along with them, but never downloaded.
+   *  @param[in]           node node number
+   *  @param[out] chunk_indices vector of dummy chunk indices on node
+   *  @return 0 on success, -1 on failure */
+  virtual int dummy_chunks_on_node(int node, std::vector<int> &chunk_indices);
+
+
+  /** Generate a dummy chunk in memory, so that it can be uploaded without
+   *  staging a chunk file.  Valid once encode_file() or repair_file() has
+   *  processed the file.
+   *  @param[in]    filename name of file the dummy chunk belongs to
+   *  @param[in] chunk_index index of the dummy chunk
+   *  @param[out]       data chunk buffer from BufferArena (give it back with release())
+   *  @param[out]       size size of the chunk
+   *  @return 0 on success, -1 on failure */
+  virtual int generate_dummy_chunk(std::string &filename, int chunk_index,
+                                   char* &data, size_t &size);
+
+
+  /** Write the metadata of a file split into segments, each stored as a file
+   *  of its own named segment_name(filename, i).
+   *  @param[in]   dstdir destination directory where the metadata is stored
+   *  @param[in] filename filename of the segmented file
+   *  @param[in] filesize size of the segmented file
+   *  @param[in] segments offset, size and chunk size of each segment */
+  void write_segments(std::string &dstdir, std::string &filename, size_t filesize,
+                      std::vector<MetadataStripe> &segments);
+
+
+  /** Read the segments of a file from its metadata.
+   *  @param[in]    srcdir directory where retrieved metadata is at
+   *  @param[in]  filename filename of the file
+   *  @param[out] segments offset, size and chunk size of each segment
+   *  @return number of segments (0 if the file is not split into segments) */
+  int read_segments(std::string &srcdir, std::string &filename,
+                    std::vector<MetadataStripe> &segments);
+
+
+  /** Record in the metadata of a file encoded as a whole how its chunks hold
+   *  the file, e.g., compressed before encoding.
+   *  @param[in]   dstdir destination directory where the metadata is stored
+   *  @param[in] filename filename of the file
+   *  @param[in]   stripe size of the file, chunk size and flags of the stripe */
+  void write_stripe(std::string &dstdir, std::string &filename, MetadataStripe &stripe);
+
+
+  /** Read the stripe written by write_stripe().
+   *  @param[in]   srcdir directory where retrieved metadata is at
+   *  @param[in] filename filename of the file
+   *  @param[out]  stripe the stripe
+   *  @return 0 on success, -1 if the file has no such stripe */
+  int read_stripe(std::string &srcdir, std::string &filename, MetadataStripe &stripe);
+
+
+  /** Read the size of each chunk of a file from its metadata.
+   *  @param[in]   srcdir directory where retrieved metadata is at
+   *  @param[in] filename filename of the file
+   *  @return chunk size */
+  size_t chunk_size(std::string &srcdir, std::string &filename);
+
+
+  /** Return the name under which a segment of a file is stored.
+   *  @param[in] filename filename of the segmented file
+   *  @param[in]    index segment index */
+  static std::string segment_name(std::string &filename, int index);
+
+
   /** Clear all cached parameters other than n, k and w. */
   virtual void reset(void) = 0;
 };
@@ -0,0 +1,421 @@
+/**
+  * @file codings/crs.cc
+  * @brief Implements the CRSCode class.
+  * **/
+
+/* ===================================================================
+Copyright (c) 2026, the NCCloud contributors
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+  - Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+  - Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in
+    the documentation and/or other materials provided with the
+    distribution.
+
+  - Neither the name of the copyright holder nor the
+    names of its contributors may be used to endorse or promote
+    products derived from this software without specific prior written
+    permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT
+HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+=================================================================== */
+
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <unistd.h>
+
+#include "../common.h"
+#include "crs.h"
+
+extern "C"
+{
+#include <jerasure.h>
+#include <cauchy.h>
+}
+
+using namespace std;
+
+
+/*  ----------------  */
+/* | Public methods | */
+/*  ----------------  */
+CRSCode::CRSCode(int k, int n, int w): packetsize(0), bitmatrix(NULL), schedules(NULL),
+                                       n(n), k(k), m(n-k), w(w)
+{
+}
+
+
+CRSCode::~CRSCode()
+{
+  reset();
+}
+
+
+int CRSCode::init(map<string,string> &coding_param)
+{
+  if (Coding::init(coding_param) == -1) {
+    return -1;
+  }
+  if (w < 2 || w > 32 || (w < 30 && n > (1 << w))) {
+    print_error(stringstream() << "[Coding:CRSCode] n must be at most 2^w." << endl);
+    return -1;
+  }
+  if (coding_param.count("packetsize") == 1) {
+    packetsize = atoi(coding_param["packetsize"].c_str());
+    if (packetsize <= 0 || packetsize % sizeof(long) != 0) {
+      print_error(stringstream() << "[Coding:CRSCode] packetsize must be a positive multiple of "
+                                 << sizeof(long) << "." << endl);
+      return -1;
+    }
+  } else {
+    packetsize = jerasure_recommended_packetsize(k, m, w);
+  }
+  if (coding_param.count("schedule_dir") == 1) {
+    schedule_dir = coding_param["schedule_dir"];
+  }
+  return 0;
+}
+
+
+int CRSCode::encode_file(string &dstdir, string &srcdir, string &filename)
+{
+  // map input file as aggregated data chunks, with room for padding (each
+  // chunk must be a multiple of w packets)
+  string src = srcdir + '/' + filename;
+  size_t filesize = file_size(src);
+  size_t padded_filesize = padded_size(filesize, (size_t)k * w * packetsize);
+  size_t chunksize = padded_filesize / k;
+  char *data = map_input(src, filesize, padded_filesize);
+
+  // pad file and split into data chunks for encoding
+  pad_data(data, filesize, (size_t)k * w * packetsize);
+  char **data_ptrs = new char*[k];
+  for (int i=0; i<k; ++i) {
+    data_ptrs[i] = data + i*chunksize;
+  }
+
+  // write chunk size and packet size to metadata file
+  string dst = dstdir + '/' + filename;
+  write_metadata(dst, chunksize, filesize, packetsize);
+
+  // encode data chunks to code chunks, straight into their mapped files
+  char **code_ptrs = new char*[m];
+  for (int i=k; i<n; ++i) {
+    string chunk_path = dst + ".chunk" + to_string(i);
+    code_ptrs[i-k] = map_output(chunk_path, chunksize);
+  }
+  init_schedules();
+  jerasure_schedule_encode(k, m, w, jerasure_schedule_store_encode(schedules),
+                           data_ptrs, code_ptrs, chunksize, packetsize);
+  for (int i=k; i<n; ++i) {
+    unmap_file(code_ptrs[i-k], chunksize);
+  }
+  delete[] data_ptrs;
+  delete[] code_ptrs;
+
+  // write data chunks to files
+  vector<int> chunk_indices(k);
+  for (int i=0; i<k; ++i) {
+    chunk_indices[i] = i;
+  }
+  write_chunks(dst, chunksize, chunk_indices, data);
+  unmap_file(data, padded_filesize);
+
+  return 0;
+}
+
+
+int CRSCode::decode_file(string &dst, string &srcdir, string &filename,
+                         vector<int> &chunk_indices)
+{
+  if (chunk_indices.size() < (unsigned int)k) {
+    print_error(stringstream() << "Insufficient chunks retrieved." << endl);
+    return -1;
+  }
+
+  // load chunk size and packet size from metadata
+  string src = srcdir + '/' + filename;
+  size_t chunksize = 0;
+  int file_packetsize = 0;
+  read_metadata(src, chunksize, file_packetsize);
+
+  vector<int> missing;
+  for (int i=0; i<k; ++i) {
+    if (find(chunk_indices.begin(), chunk_indices.end(), i) == chunk_indices.end()) {
+      missing.push_back(i);
+    }
+  }
+
+  // systematic code: if all data chunks are here, the padded file is just
+  // the data chunks in order
+  if (missing.empty()) {
+    int fd = open(dst.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd == -1) {
+      show_file_error("open", dst.c_str(), NULL);
+    }
+    string chunk_partial_path = src + ".chunk";
+    for (int i=0; i<k; ++i) {
+      string chunk_path = chunk_partial_path + to_string(i);
+      append_chunk(fd, dst, chunk_path, chunksize);
+    }
+    trim_padding(fd, dst, k * chunksize, (size_t)k * w * file_packetsize);
+    close(fd);
+    return 0;
+  }
+
+  // load downloaded chunks into their places, then decode the missing data chunks
+  char *chunks = new char[n * chunksize];
+  char **data_ptrs = new char*[k];
+  char **code_ptrs = new char*[m];
+  if (decode_chunks(src, chunk_indices, missing, chunksize, file_packetsize,
+                    chunks, data_ptrs, code_ptrs) == -1) {
+    delete[] chunks;
+    delete[] data_ptrs;
+    delete[] code_ptrs;
+    return -1;
+  }
+  delete[] data_ptrs;
+  delete[] code_ptrs;
+
+  // data chunks are contiguous at the start of chunks
+  size_t decoded_filesize = unpad_data(chunks, k*chunksize);
+  write_file(dst, chunks, decoded_filesize);
+  delete[] chunks;
+
+  return 0;
+}
+
+
+int CRSCode::repair_file_preprocess(string &srcdir, string &filename,
+                                    vector<int> &erasures,
+                                    vector<int> &chunks_to_retrieve)
+{
+  if (erasures.size() > (unsigned int)m) {
+    print_error(stringstream() << "Too many erasures." << endl);
+    return -1;
+  }
+  retrieved_chunk_indices.erase(retrieved_chunk_indices.begin(),
+                                retrieved_chunk_indices.end());
+  failed_nodes.erase(failed_nodes.begin(), failed_nodes.end());
+  for (auto e : erasures) {
+    failed_nodes.push_back(e);  // stored internally for repair_file()
+  }
+  for (int i=0, j=0; j<k && i<n; ++i) {
+    if (find(erasures.begin(), erasures.end(), i) == erasures.end()) {
+      chunks_to_retrieve.push_back(i);       // list to return to caller
+      retrieved_chunk_indices.push_back(i);  // internal list
+      ++j;
+    }
+  }
+  return 0;
+}
+
+
+int CRSCode::repair_file(string &dstdir, string &srcdir, string &filename)
+{
+  // load chunk size and packet size from metadata
+  string src = srcdir + '/' + filename;
+  size_t chunksize = 0;
+  int file_packetsize = 0;
+  read_metadata(src, chunksize, file_packetsize);
+
+  // load downloaded chunks and decode the failed ones
+  char *chunks = new char[n * chunksize];
+  char **data_ptrs = new char*[k];
+  char **code_ptrs = new char*[m];
+  int ret = decode_chunks(src, retrieved_chunk_indices, failed_nodes, chunksize,
+                          file_packetsize, chunks, data_ptrs, code_ptrs);
+  delete[] data_ptrs;
+  delete[] code_ptrs;
+
+  // write repaired chunks to disk
+  if (ret == 0) {
+    string dst = dstdir + '/' + filename;
+    for (auto index : failed_nodes) {
+      vector<int> chunk_index {index};
+      write_chunks(dst, chunksize, chunk_index, chunks + index*chunksize);
+    }
+  }
+  delete[] chunks;
+  return ret;
+}
+
+
+int CRSCode::getn(void) { return n; }
+int CRSCode::getk(void) { return k; }
+int CRSCode::nodeid(int index) { return index; }
+int CRSCode::chunks_per_node(void) { return 1; }
+
+
+int CRSCode::chunks_on_node(int node, vector<int> &chunk_indices)
+{
+  chunk_indices.push_back(node);
+  return (node>=0 && node<n)? 0 : -1;
+}
+
+
+void CRSCode::reset(void)
+{
+  if (schedules != NULL) {
+    jerasure_close_schedule_store(schedules);
+    schedules = NULL;
+  }
+  if (bitmatrix != NULL) {
+    free(bitmatrix);
+    bitmatrix = NULL;
+  }
+  failed_nodes.erase(failed_nodes.begin(), failed_nodes.end());
+  retrieved_chunk_indices.erase(retrieved_chunk_indices.begin(),
+                                retrieved_chunk_indices.end());
+}
+
+
+/*  -----------------  */
+/* | Private methods | */
+/*  -----------------  */
+void CRSCode::init_schedules(void)
+{
+  if (schedules != NULL) {
+    return;
+  }
+  // schedules are kept across runs if schedule_dir (or JERASURE_SCHEDULE_DIR) is set
+  bitmatrix = create_bitmatrix();
+  schedules = jerasure_open_schedule_store(k, m, w, bitmatrix, 1,
+                                           schedule_dir.empty()? NULL : schedule_dir.c_str());
+  if (schedules == NULL) {
+    show_error("jerasure_open_schedule_store");
+  }
+}
+
+
+int *CRSCode::create_bitmatrix(void)
+{
+  int *matrix = cauchy_good_general_coding_matrix(k, m, w);
+  int *coding_bitmatrix = jerasure_matrix_to_bitmatrix(k, m, w, matrix);
+  free(matrix);
+  return coding_bitmatrix;
+}
+
+
+void CRSCode::read_metadata(string &path, size_t &chunksize, int &packetsize)
+{
+  // the payload holds the packet size
+  Metadata meta;
+  load_metadata(path, meta);
+  chunksize = meta.header.chunksize;
+  packetsize = 0;
+  if (meta.payload.size() == sizeof(uint32_t)) {
+    uint32_t stored_packetsize;
+    memcpy(&stored_packetsize, meta.payload.data(), sizeof(stored_packetsize));
+    packetsize = stored_packetsize;
+  }
+}
+
+
+int CRSCode::parse_legacy_metadata(string &data, Metadata &meta)
+{
+  // "<chunk size> <packet size>" in ASCII
+  size_t len = strspn(data.c_str(), "0123456789");
+  if (len == 0 || len + 1 >= data.size() || data[len] != ' ' ||
+      strspn(data.c_str() + len + 1, "0123456789") != data.size() - len - 1) {
+    return -1;
+  }
+  meta.header.chunksize = strtoull(data.c_str(), NULL, 10);
+  uint32_t stored_packetsize = strtoul(data.c_str() + len + 1, NULL, 10);
+  meta.payload.assign((char *)&stored_packetsize, sizeof(stored_packetsize));
+  return 0;
+}
+
+
+void CRSCode::write_metadata(string &path, size_t chunksize, size_t filesize, int packetsize)
+{
+  Metadata meta;
+  meta.header.chunksize = chunksize;
+  meta.header.filesize = filesize;
+  uint32_t stored_packetsize = packetsize;
+  meta.payload.assign((char *)&stored_packetsize, sizeof(stored_packetsize));
+  save_metadata(path, meta);
+}
+
+
+int CRSCode::decode_chunks(string &src, vector<int> &chunk_indices, vector<int> &targets,
+                           size_t chunksize, int packetsize, char *chunks,
+                           char **data_ptrs, char **code_ptrs)
+{
+  if (packetsize <= 0 || chunksize % ((size_t)w * packetsize) != 0) {
+    print_error(stringstream() << "[Coding:CRSCode] invalid packet size in metadata." << endl);
+    return -1;
+  }
+
+  // read each chunk straight into its place: chunk i at chunks + i*chunksize
+  vector<bool> erased(n, true);
+  for (auto index : chunk_indices) {
+    vector<int> chunk_index {index};
+    read_chunks(src, chunksize, chunk_index, chunks + index*chunksize);
+    erased[index] = false;
+  }
+  for (int i=0; i<k; ++i) {
+    data_ptrs[i] = chunks + i*chunksize;
+  }
+  for (int i=0; i<m; ++i) {
+    code_ptrs[i] = chunks + (k+i)*chunksize;
+  }
+
+  // list the erasures, terminated by -1: the targets and missing data chunks,
+  // and the code chunks not retrieved below the last one that jerasure takes
+  // in place of a missing data chunk (it takes the lowest ones not erased);
+  // the schedule rebuilds every listed chunk, so no others are listed
+  int *erasures = new int[n+1];
+  int num_erased = 0;
+  int substitutes = 0;
+  for (int i=0; i<k; ++i) {
+    if (erased[i]) {
+      erasures[num_erased++] = i;
+      ++substitutes;
+    }
+  }
+  for (int i=k; i<n; ++i) {
+    if (!erased[i]) {
+      if (substitutes > 0) {
+        --substitutes;
+      }
+    } else if (substitutes > 0 || find(targets.begin(), targets.end(), i) != targets.end()) {
+      erasures[num_erased++] = i;
+    }
+  }
+  erasures[num_erased] = -1;
+
+  int ret = 0;
+  if (num_erased > 0) {
+    init_schedules();
+    ret = jerasure_schedule_decode_stored(schedules, erasures, data_ptrs, code_ptrs,
+                                          chunksize, packetsize);
+    if (ret == -1) {
+      print_error(stringstream() << "[Coding:CRSCode] decoding failed." << endl);
+    }
+  }
+  delete[] erasures;
+  return ret;
+}
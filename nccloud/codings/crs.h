@@ -0,0 +1,99 @@
+/**
+  * @file codings/crs.h
+  * @brief Declares the CRSCode class.
+  * **/
+
+/* ===================================================================
+Copyright (c) 2026, the NCCloud contributors
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+  - Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+  - Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in
+    the documentation and/or other materials provided with the
+    distribution.
+
+  - Neither the name of the copyright holder nor the
+    names of its contributors may be used to endorse or promote
+    products derived from this software without specific prior written
+    permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT
+HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+=================================================================== */
+
+
+#ifndef NCCLOUD_CODINGS_CRS_H
+#define NCCLOUD_CODINGS_CRS_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "../coding.h"
+
+struct jerasure_schedule_store;
+
+
+/** Coding module class for Cauchy Reed-Solomon code.
+ *  Coding is done with XORs only, following a schedule generated from the
+ *  bitmatrix of cauchy_good_general_coding_matrix(). */
+class CRSCode: public Coding
+{
+  int packetsize;
+  std::string schedule_dir;
+  int *bitmatrix;
+  struct jerasure_schedule_store *schedules;
+  std::vector<int> failed_nodes;
+  std::vector<int> retrieved_chunk_indices;
+
+  void init_schedules(void);
+  void read_metadata(std::string &path, size_t &chunksize, int &packetsize);
+  void write_metadata(std::string &path, size_t chunksize, size_t filesize, int packetsize);
+  int parse_legacy_metadata(std::string &data, Metadata &meta);
+  int decode_chunks(std::string &src, std::vector<int> &chunk_indices, std::vector<int> &targets,
+                    size_t chunksize, int packetsize, char *chunks,
+                    char **data_ptrs, char **code_ptrs);
+
+protected:
+  int n, k, m, w;
+
+  /** Return the k*w columns by m*w rows coding bitmatrix (allocated with malloc). */
+  virtual int *create_bitmatrix(void);
+
+public:
+  CRSCode(int k, int n, int w);
+  virtual ~CRSCode();
+  int init(std::map<std::string, std::string> &coding_param);
+  int encode_file(std::string &dstdir, std::string &srcdir, std::string &filename);
+  int decode_file(std::string &dst, std::string &srcdir, std::string &filename,
+                  std::vector<int> &chunk_indices);
+  int repair_file_preprocess(std::string &srcdir, std::string &filename,
+                             std::vector<int> &erasures,
+                             std::vector<int> &chunks_to_retrieve);
+  int repair_file(std::string &dstdir, std::string &srcdir, std::string &filename);
+
+  int getn(void);
+  int getk(void);
+  int nodeid(int index);
+  int chunks_per_node(void);
+  int chunks_on_node(int node, std::vector<int> &chunk_indices);
+  void reset(void);
+};
+
+#endif  /* NCCLOUD_CODINGS_CRS_H */
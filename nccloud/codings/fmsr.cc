@@ -39,14 +39,25 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 =================================================================== */
 
 
+#include <algorithm>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <fcntl.h>
 #include <iostream>
+#include <unistd.h>
 
+#include "../arena.h"
 #include "../common.h"
 #include "fmsr.h"
 
+extern "C"
+{
+#include <fmsrutil.h>
+#include <gf.h>
+#include <matrix.h>
+}
+
 using namespace std;
 
 
@@ -55,7 +66,7 @@ using namespace std;
 /*  ----------------  */
 FMSRCode::FMSRCode(int k, int n, int w):
     k(k), n(n), nn(fmsr_nn(k, n)), nc(fmsr_nc(k, n)),
-    encode_matrix(NULL), decode_matrix(NULL), repair_matrix(NULL),
+    encode_matrix(NULL), repair_matrix(NULL),
     gf_retrieved_chunk_indices(NULL), gf_repair_chunk_indices(NULL),
     hints((fmsr_repair_hints){255, 0})
 {
@@ -75,50 +86,61 @@ FMSRCode::~FMSRCode()
 
 int FMSRCode::encode_file(string &dstdir, string &srcdir, string &filename)
 {
-  // read input file as native chunks
-  string src = srcdir + '/' + filename;
-  FILE *infile = fopen(src.c_str(), "rb");
-  if (infile == NULL) {
-    show_file_error("fopen", src.c_str(), NULL);
+  // encode in memory, then write code chunks to files
+  char *code_chunks = NULL;
+  size_t chunksize = 0;
+  if (encode_buffer(dstdir, srcdir, filename, code_chunks, chunksize) == -1) {
+    return -1;
   }
-  fseek(infile, 0, SEEK_END);
-  size_t filesize = ftell(infile);
-  size_t padded_filesize = fmsr_padded_size(k, n, filesize);
-  rewind(infile);
-  gf *native_chunks = new gf[padded_filesize];
-  if (fread(native_chunks, 1, filesize, infile) != filesize) {
-    show_file_error("fread", src.c_str(), infile);
+  string dst = dstdir + '/' + filename;
+  vector<int> chunk_indices(nc);
+  for (unsigned int i=0; i<nc; ++i) {
+    chunk_indices[i] = i;
   }
-  fclose(infile);
+  write_chunks(dst, chunksize, chunk_indices, code_chunks);
+  BufferArena::instance()->release(code_chunks);
+
+  return 0;
+}
+
+
+int FMSRCode::encode_segment(string &dstdir, string &src, size_t offset, size_t size,
+                             string &filename, char* &chunks, size_t &chunksize)
+{
+  // map input range as native chunks, with room for padding
+  size_t filesize = size;
+  size_t padded_filesize = fmsr_padded_size(k, n, filesize);
+  gf *native_chunks = (gf *)map_input(src, filesize, padded_filesize, offset);
 
   // encode native chunks to code chunks
-  size_t chunksize = padded_filesize / nn;
-  gf *code_chunks = new gf[nc * chunksize];
+  chunksize = padded_filesize / nn;
+  gf *code_chunks = (gf *)BufferArena::instance()->acquire(nc * chunksize);
+  unique_lock<mutex> lock(metadata_mutex);  // held only while creating the matrix
   int create_new = encode_matrix? 0 : 1;
   if (create_new) {
     encode_matrix = new gf[nc*nn];
+  } else {
+    lock.unlock();
+  }
+  uint64_t key_nonce = new_key_nonce();
+  int result = key_nonce?
+      encrypt_encode(native_chunks, filesize, create_new, code_chunks, key_nonce) :
+      fmsr_encode(k, n, native_chunks, filesize, create_new, code_chunks, encode_matrix);
+  if (lock.owns_lock()) {
+    lock.unlock();
   }
-  int result = fmsr_encode(k, n, native_chunks, filesize, create_new,
-                           code_chunks, encode_matrix);
   if (result == -1) {
     print_error(stringstream() << "FMSR not supported for k=" << k
                                << " and n=" << n << endl);
     return -1;
   }
-  delete[] native_chunks;
+  unmap_file((char *)native_chunks, padded_filesize);
 
   // write encoding matrix, chunk size and default repair hints to metadata file
   string dst = dstdir + '/' + filename;
-  write_metadata(dst, chunksize);
-
-  // write code chunks to files
-  vector<int> chunk_indices(nc);
-  for (unsigned int i=0; i<nc; ++i) {
-    chunk_indices[i] = i;
-  }
-  write_chunks(dst, chunksize, chunk_indices, (char *)code_chunks);
-  delete[] code_chunks;
+  write_metadata(dst, chunksize, filesize, key_nonce);
 
+  chunks = (char *)code_chunks;
   return 0;
 }
 
@@ -126,8 +148,7 @@ int FMSRCode::encode_file(string &dstdir, string &srcdir, string &filename)
 int FMSRCode::decode_file(string &dst, string &srcdir, string &filename,
                           vector<int> &chunk_indices)
 {
-  unsigned int num_chunks = chunk_indices.size();
-  if (num_chunks < nn) {
+  if (chunk_indices.size() < nn) {
     print_error(stringstream() << "Insufficient chunks retrieved." << endl);
     return -1;
   }
@@ -138,34 +159,108 @@ int FMSRCode::decode_file(string &dst, string &srcdir, string &filename,
   read_metadata(src, chunksize);
 
   // load code chunks
-  gf *code_chunks = new gf[nn * chunksize];
+  gf *code_chunks = (gf *)BufferArena::instance()->acquire(nn * chunksize);
   read_chunks(src, chunksize, chunk_indices, (char *)code_chunks);
+  int result = decode_chunks(dst, chunksize, chunk_indices, code_chunks, read_key_nonce(src));
+  BufferArena::instance()->release(code_chunks);
+  return result;
+}
+
 
-  // decode code chunks into original data
-  reset_array<gf>(&gf_retrieved_chunk_indices, num_chunks);
-  for (unsigned int i=0; i<num_chunks; ++i) {
-    gf_retrieved_chunk_indices[i] = (gf)chunk_indices[i];
+int FMSRCode::decode_buffer(string &dst, string &srcdir, string &filename,
+                            vector<int> &chunk_indices, vector<char *> &chunks)
+{
+  if (chunk_indices.size() < nn) {
+    print_error(stringstream() << "Insufficient chunks retrieved." << endl);
+    return -1;
   }
-  int create_new = decode_matrix? 0 : 1;
-  if (create_new) {
-    decode_matrix = new gf[nn*nn];
+
+  // load encoding matrix and chunk size
+  string src = srcdir + '/' + filename;
+  size_t chunksize = 0;
+  read_metadata(src, chunksize);
+
+  // gather code chunks, as libfmsr takes them in one buffer
+  gf *code_chunks = (gf *)BufferArena::instance()->acquire(nn * chunksize);
+  for (unsigned int i=0; i<nn; ++i) {
+    memcpy(code_chunks + i*chunksize, chunks[i], chunksize);
   }
-  gf *decoded_file = new gf[nn * chunksize];
-  size_t decoded_filesize = 0;
-  int result = fmsr_decode(k, n, code_chunks, chunksize,
-                           gf_retrieved_chunk_indices, num_chunks, encode_matrix,
-                           decode_matrix, create_new,
-                           decoded_file, &decoded_filesize);
-  if (result == -1) {
-    print_error(stringstream() << "Invalid parameters passed to fmsr_decode()" << endl);
+  int result = decode_chunks(dst, chunksize, chunk_indices, code_chunks, read_key_nonce(src));
+  BufferArena::instance()->release(code_chunks);
+  return result;
+}
+
+
+int FMSRCode::range_reads(string &srcdir, string &filename, vector<int> &chunk_indices,
+                          size_t offset, size_t length, vector<ChunkRange> &ranges)
+{
+  if (chunk_indices.size() < nn) {
+    print_error(stringstream() << "Insufficient chunks retrieved." << endl);
     return -1;
   }
-  delete[] code_chunks;
 
-  // write decoded file to dst
-  write_file(dst, (char *)decoded_file, decoded_filesize);
-  delete[] decoded_file;
+  // a native chunk range is decoded from the same range of the nn code chunks
+  string src = srcdir + '/' + filename;
+  if (read_filesize(src) == Metadata::unknown_filesize) {
+    return -1;  // legacy metadata gives no file size to clip the range to
+  }
+  vector<ChunkRange> pieces;
+  native_pieces(src, offset, length, pieces);
+  for (auto &piece : pieces) {
+    for (unsigned int i=0; i<nn; ++i) {
+      add_range(ranges, chunk_indices[i], piece.offset, piece.length);
+    }
+  }
+  return 0;
+}
+
+
+int FMSRCode::decode_range(string &dst, string &srcdir, string &filename,
+                           vector<int> &chunk_indices, size_t offset, size_t length)
+{
+  if (chunk_indices.size() < nn) {
+    print_error(stringstream() << "Insufficient chunks retrieved." << endl);
+    return -1;
+  }
+
+  // load encoding matrix, and invert the rows of the code chunks retrieved
+  string src = srcdir + '/' + filename;
+  size_t chunksize = 0;
+  read_metadata(src, chunksize);
+  vector<ChunkRange> pieces;
+  native_pieces(src, offset, length, pieces);
+  gf *decode_matrix = decoding_matrix(chunk_indices);
+  if (decode_matrix == NULL) {
+    return -1;
+  }
+
+  // each native chunk range is a row of the inverse times the code chunk
+  // ranges, decrypted if the file is encrypted
+  uint64_t key_nonce = read_key_nonce(src);
+  int fd = open(dst.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd == -1) {
+    show_file_error("open", dst.c_str(), NULL);
+  }
+  for (auto &piece : pieces) {
+    gf *data = (gf *)BufferArena::instance()->acquire(piece.length);
+    gf *code = (gf *)BufferArena::instance()->acquire(piece.length);
+    gf *row = decode_matrix + piece.chunk_index*nn;
+    for (unsigned int i=0; i<nn; ++i) {
+      read_chunk_range(src, chunk_indices[i], piece.offset, piece.length, (char *)code);
+      if (i == 0) {
+        gf_mul_bytes(code, piece.length, row[i], data);
+      } else {
+        gf_mulxor_bytes(code, piece.length, row[i], data);
+      }
+    }
+    crypt_range(key_nonce, piece.chunk_index, piece.offset, (char *)data, piece.length);
+    append_data(fd, dst, (char *)data, piece.length);
+    BufferArena::instance()->release((char *)code);
+    BufferArena::instance()->release((char *)data);
+  }
+  close(fd);
 
+  delete[] decode_matrix;
   return 0;
 }
 
@@ -227,7 +322,7 @@ int FMSRCode::repair_file_preprocess(string &srcdir, string &filename,
   // write new encoding matrix and new repair hints to metadata
   memcpy(encode_matrix, new_encode_matrix, nc*nn);
   delete[] new_encode_matrix;
-  write_metadata(src, chunksize);
+  update_metadata(src);
 
   return 0;
 }
@@ -239,10 +334,10 @@ int FMSRCode::repair_file(string &dstdir, string &srcdir, string &filename)
   string src = srcdir + '/' + filename;
   size_t chunksize = 0;
   read_metadata(src, chunksize);
-  write_metadata(src, chunksize); // update encoding matrix and repair hints
+  update_metadata(src);  // update encoding matrix and repair hints
 
   // load retrieved chunks
-  gf *retrieved_chunks = new gf[(n-1) * chunksize];
+  gf *retrieved_chunks = (gf *)BufferArena::instance()->acquire((n-1) * chunksize);
   if (gf_retrieved_chunk_indices == NULL) {
     return -1;  // haven't called repair_file_preprocess()?
   }
@@ -256,11 +351,11 @@ int FMSRCode::repair_file(string &dstdir, string &srcdir, string &filename)
   if (chunks_per_node() == -1) {
     return -1;
   }
-  gf *new_code_chunks = new gf[chunks_per_node() * chunksize];
+  gf *new_code_chunks = (gf *)BufferArena::instance()->acquire(chunks_per_node() * chunksize);
   fmsr_regenerate(repair_matrix, chunks_per_node(), n-1,
                   retrieved_chunks, chunksize,
                   new_code_chunks);
-  delete[] retrieved_chunks;
+  BufferArena::instance()->release(retrieved_chunks);
 
   // write new chunks to dstdir
   if (gf_repair_chunk_indices == NULL) {
@@ -272,7 +367,7 @@ int FMSRCode::repair_file(string &dstdir, string &srcdir, string &filename)
   }
   string dst = dstdir + '/' + filename;
   write_chunks(dst, chunksize, repair_chunk_indices, (char *)new_code_chunks);
-  delete[] new_code_chunks;
+  BufferArena::instance()->release(new_code_chunks);
 
   return 0;
 }
@@ -280,6 +375,8 @@ int FMSRCode::repair_file(string &dstdir, string &srcdir, string &filename)
 
 int FMSRCode::getn(void) { return (int)n; }
 int FMSRCode::getk(void) { return (int)k; }
+int FMSRCode::buffered_io(void) { return 1; }
+int FMSRCode::encryption(void) { return 1; }
 
 
 int FMSRCode::nodeid(int index)
@@ -315,7 +412,6 @@ int FMSRCode::chunks_on_node(int node, std::vector<int> &chunk_indices)
 void FMSRCode::reset(void)
 {
   reset_array<gf>(&encode_matrix);
-  reset_array<gf>(&decode_matrix);
   reset_array<gf>(&repair_matrix);
   reset_array<gf>(&gf_retrieved_chunk_indices);
   reset_array<gf>(&gf_repair_chunk_indices);
@@ -325,60 +421,201 @@ void FMSRCode::reset(void)
 /*  -----------------  */
 /* | Private methods | */
 /*  -----------------  */
-void FMSRCode::read_metadata(string &path, size_t &chunksize)
+int FMSRCode::decode_chunks(string &dst, size_t chunksize, vector<int> &chunk_indices,
+                            gf *code_chunks, uint64_t key_nonce)
 {
-  // read encoding matrix, chunk size and repair hints from existing metadata
-  string meta_path = path + ".meta";
-  FILE *metafile = fopen(meta_path.c_str(), "rb");
-  if (metafile == NULL) {
-    show_file_error("fopen", meta_path.c_str(), NULL);
-  }
-  int update = 0;
-  if (encode_matrix == NULL) {
-    update = 1;
-    encode_matrix = new gf[nc*nn];
-    if (fread(encode_matrix, 1, nc*nn, metafile) != nc*nn) {
-      show_file_error("fread", meta_path.c_str(), metafile);
+  if (key_nonce != 0) {
+    return decrypt_decode(dst, chunksize, chunk_indices, code_chunks, key_nonce);
+  }
+
+  // decode code chunks into original data (with local state, as several
+  // segments of a file may be decoded at once)
+  gf *retrieved_chunk_indices = new gf[nn];
+  for (unsigned int i=0; i<nn; ++i) {
+    retrieved_chunk_indices[i] = (gf)chunk_indices[i];
+  }
+  gf *decode_matrix = new gf[nn*nn];
+  gf *decoded_file = (gf *)map_output(dst, nn * chunksize);
+  size_t decoded_filesize = 0;
+  int result = fmsr_decode(k, n, code_chunks, chunksize,
+                           retrieved_chunk_indices, nn, encode_matrix,
+                           decode_matrix, 1,
+                           decoded_file, &decoded_filesize);
+  delete[] retrieved_chunk_indices;
+  delete[] decode_matrix;
+  if (result == -1) {
+    print_error(stringstream() << "Invalid parameters passed to fmsr_decode()" << endl);
+    return -1;
+  }
+
+  // decoded straight into dst, which only needs trimming to the original size
+  unmap_file((char *)decoded_file, nn * chunksize);
+  if (truncate(dst.c_str(), decoded_filesize) == -1) {
+    show_file_error("truncate", dst.c_str(), NULL);
+  }
+
+  return 0;
+}
+
+
+size_t FMSRCode::native_pieces(string &src, size_t offset, size_t &length,
+                               vector<ChunkRange> &pieces)
+{
+  // clip the range to the file, whose bytes are the native chunks in order
+  Metadata meta;
+  load_metadata(src, meta);
+  size_t filesize = meta.header.filesize;
+  length = offset < filesize? min(length, filesize - offset) : 0;
+  split_range(meta.header.chunksize, offset, offset + length, pieces);
+  return meta.header.chunksize;
+}
+
+
+int FMSRCode::encrypt_encode(gf *native_chunks, size_t filesize, int create_new,
+                             gf *code_chunks, uint64_t key_nonce)
+{
+  // as fmsr_encode(), but encrypting each tile of the native chunks right
+  // before multiplying it, while it is still in the cache
+  if (!fmsr_encode_support(k, n)) {
+    return -1;
+  }
+  if (create_new) {
+    fmsr_create_encode_matrix(k, n, encode_matrix);
+  }
+  fmsr_pad_data(k, n, native_chunks, filesize);
+  size_t chunksize = fmsr_padded_size(k, n, filesize) / nn;
+  size_t tile = crypt_tile_size(nn + nc);
+  for (size_t offset=0; offset<chunksize; offset+=tile) {
+    size_t size = min(tile, chunksize - offset);
+    for (unsigned int j=0; j<nn; ++j) {
+      crypt_range(key_nonce, j, offset, (char *)native_chunks + j*chunksize + offset, size);
+    }
+    for (unsigned int i=0; i<nc; ++i) {
+      gf *code = code_chunks + i*chunksize + offset;
+      gf *row = encode_matrix + i*nn;
+      gf_mul_bytes(native_chunks + offset, size, row[0], code);
+      for (unsigned int j=1; j<nn; ++j) {
+        gf_mulxor_bytes(native_chunks + j*chunksize + offset, size, row[j], code);
+      }
     }
   }
-  fseek(metafile, nc*nn, SEEK_SET);
-  char stchunksize[25] = {0};
-  if (fread(stchunksize, 1, 24, metafile) <= 0) {
-    show_file_error("fread", meta_path.c_str(), metafile);
+  return 0;
+}
+
+
+int FMSRCode::decrypt_decode(string &dst, size_t chunksize, vector<int> &chunk_indices,
+                             gf *code_chunks, uint64_t key_nonce)
+{
+  // as fmsr_decode(), but decrypting each tile of the native chunks right
+  // after computing it, while it is still in the cache
+  gf *decode_matrix = decoding_matrix(chunk_indices);
+  if (decode_matrix == NULL) {
+    return -1;
+  }
+  gf *decoded_file = (gf *)map_output(dst, nn * chunksize);
+  size_t tile = crypt_tile_size(nn + nn);
+  for (size_t offset=0; offset<chunksize; offset+=tile) {
+    size_t size = min(tile, chunksize - offset);
+    for (unsigned int j=0; j<nn; ++j) {
+      gf *data = decoded_file + j*chunksize + offset;
+      gf *row = decode_matrix + j*nn;
+      gf_mul_bytes(code_chunks + offset, size, row[0], data);
+      for (unsigned int i=1; i<nn; ++i) {
+        gf_mulxor_bytes(code_chunks + i*chunksize + offset, size, row[i], data);
+      }
+      crypt_range(key_nonce, j, offset, (char *)data, size);
+    }
   }
-  int st_len = strlen(stchunksize);
-  if (update) {  // prevents overwriting new hints with stale hints
-    hints.last_used = stchunksize[st_len-1] - '0';
-    stchunksize[st_len-1] = 0;
-    hints.last_repaired = strtoul(&stchunksize[st_len-4], NULL, 10);
+  delete[] decode_matrix;
+
+  // the padding is only visible once decrypted
+  size_t decoded_filesize = fmsr_unpad_data(decoded_file, nn * chunksize);
+  unmap_file((char *)decoded_file, nn * chunksize);
+  if (truncate(dst.c_str(), decoded_filesize) == -1) {
+    show_file_error("truncate", dst.c_str(), NULL);
   }
-  stchunksize[st_len-4] = 0;
-  chunksize = strtoul(stchunksize, NULL, 10);
-  fclose(metafile);
+  return 0;
 }
 
 
-void FMSRCode::write_metadata(string &path, size_t chunksize)
+gf *FMSRCode::decoding_matrix(vector<int> &chunk_indices)
 {
-  // write encoding matrix, chunk size and repair hints to metadata
-  string meta_path = path + ".meta";
-  FILE *metafile = fopen(meta_path.c_str(), "wb");
-  if (metafile == NULL) {
-    show_file_error("fopen", meta_path.c_str(), NULL);
+  // invert the rows of the encoding matrix of the first nn chunks
+  gf *decode_matrix = new gf[nn*nn];
+  for (unsigned int i=0; i<nn; ++i) {
+    memcpy(decode_matrix + i*nn, encode_matrix + chunk_indices[i]*nn, nn);
   }
-  if (fwrite(encode_matrix, 1, nc*nn, metafile) != nc*nn) {
-    show_file_error("fwrite", meta_path.c_str(), metafile);
+  if (matrix_invert(decode_matrix, nn) == -1) {
+    print_error(stringstream() << "[Coding:FMSRCode] retrieved chunks are not decodable." << endl);
+    delete[] decode_matrix;
+    return NULL;
   }
-  string stchunksize = to_string(chunksize);
-  if (fwrite(stchunksize.c_str(), 1, stchunksize.length(), metafile)
-      != stchunksize.length()) {
-    show_file_error("fwrite", meta_path.c_str(), metafile);
+  return decode_matrix;
+}
+
+
+void FMSRCode::read_metadata(string &path, size_t &chunksize)
+{
+  // read encoding matrix, chunk size and repair hints from existing metadata
+  Metadata meta;
+  load_metadata(path, meta);
+  if (meta.payload.size() < (size_t)nc*nn) {
+    print_error(stringstream() << "[Coding:FMSRCode] encoding matrix missing from metadata." << endl);
+    exit(-1);
   }
-  string sthints = to_string((unsigned long)hints.last_repaired*10 + hints.last_used);
-  sthints.insert(0, string(4-sthints.length(), '0'));
-  if (fwrite(sthints.c_str(), 1, sthints.length(), metafile) != sthints.length()) {
-    show_file_error("fwrite", meta_path.c_str(), metafile);
+  lock_guard<mutex> lock(metadata_mutex);
+  if (encode_matrix == NULL) {  // prevents overwriting new hints with stale hints
+    encode_matrix = new gf[nc*nn];
+    memcpy(encode_matrix, meta.payload.data(), nc*nn);
+    hints.last_repaired = meta.header.hints & 0xff;
+    hints.last_used = meta.header.hints >> 8;
   }
-  fclose(metafile);
+  chunksize = meta.header.chunksize;
+}
+
+
+int FMSRCode::parse_legacy_metadata(string &data, Metadata &meta)
+{
+  // the encoding matrix, then the chunk size and four digits of repair hints
+  // in ASCII (the previously repaired node, then the chunk used in that repair)
+  size_t len = data.size() > (size_t)nc*nn? data.size() - nc*nn : 0;
+  if (len < 5 || strspn(data.c_str() + nc*nn, "0123456789") != len) {
+    return -1;
+  }
+  unsigned long sthints = strtoul(data.substr(data.size() - 4).c_str(), NULL, 10);
+  meta.header.hints = (sthints / 10) | ((sthints % 10) << 8);
+  meta.header.chunksize = strtoull(data.substr(nc*nn, len - 4).c_str(), NULL, 10);
+  meta.payload.assign(data, 0, nc*nn);
+  return 0;
+}
+
+
+void FMSRCode::write_metadata(string &path, size_t chunksize, size_t filesize,
+                              uint64_t key_nonce)
+{
+  // write encoding matrix, chunk size and repair hints to metadata
+  Metadata meta;
+  meta.header.chunksize = chunksize;
+  meta.header.filesize = filesize;
+  meta.header.key_nonce = key_nonce;
+  fill_metadata(meta);
+  save_metadata(path, meta);
+}
+
+
+void FMSRCode::update_metadata(string &path)
+{
+  // replace encoding matrix and repair hints, keeping the rest of the metadata
+  Metadata meta;
+  load_metadata(path, meta);
+  fill_metadata(meta);
+  save_metadata(path, meta);
+}
+
+
+void FMSRCode::fill_metadata(Metadata &meta)
+{
+  meta.header.hints = hints.last_repaired | (hints.last_used << 8);
+  meta.payload.assign((char *)encode_matrix, nc*nn);
 }
 
@@ -42,6 +42,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef NCCLOUD_CODINGS_FMSR_H
 #define NCCLOUD_CODINGS_FMSR_H
 
+#include <mutex>
 #include <vector>
 #include <string>
 
@@ -62,13 +63,27 @@ typedef unsigned char gf;
 class FMSRCode: public Coding
 {
   gf k, n, nn, nc;  // (n,k)-FMSR code with nn native chunks and nc code chunks
-  gf *encode_matrix, *decode_matrix, *repair_matrix;
+  gf *encode_matrix, *repair_matrix;
   gf *gf_retrieved_chunk_indices;  // chunks retrieved during download or repair
   gf *gf_repair_chunk_indices;     // chunks to repair
   fmsr_repair_hints hints;         // info about previous repair for use in the next repair
+  std::mutex metadata_mutex;       // guards creating or loading the encoding matrix
 
   void read_metadata(std::string &path, size_t &chunksize);
-  void write_metadata(std::string &path, size_t chunksize);
+  void write_metadata(std::string &path, size_t chunksize, size_t filesize,
+                      uint64_t key_nonce=0);
+  void update_metadata(std::string &path);
+  void fill_metadata(Metadata &meta);
+  int parse_legacy_metadata(std::string &data, Metadata &meta);
+  int decode_chunks(std::string &dst, size_t chunksize, std::vector<int> &chunk_indices,
+                    gf *code_chunks, uint64_t key_nonce);
+  int encrypt_encode(gf *native_chunks, size_t filesize, int create_new,
+                     gf *code_chunks, uint64_t key_nonce);
+  int decrypt_decode(std::string &dst, size_t chunksize, std::vector<int> &chunk_indices,
+                     gf *code_chunks, uint64_t key_nonce);
+  gf *decoding_matrix(std::vector<int> &chunk_indices);
+  size_t native_pieces(std::string &src, size_t offset, size_t &length,
+                       std::vector<ChunkRange> &pieces);
 
 public:
   FMSRCode(int k, int n, int w);
@@ -76,6 +91,17 @@ public:
   int encode_file(std::string &dstdir, std::string &srcdir, std::string &filename);
   int decode_file(std::string &dst, std::string &srcdir, std::string &filename,
                   std::vector<int> &chunk_indices);
+  int buffered_io(void);
+  int encryption(void);
+  int encode_segment(std::string &dstdir, std::string &src, size_t offset, size_t size,
+                     std::string &filename, char* &chunks, size_t &chunksize);
+  int decode_buffer(std::string &dst, std::string &srcdir, std::string &filename,
+                    std::vector<int> &chunk_indices, std::vector<char *> &chunks);
+  int range_reads(std::string &srcdir, std::string &filename,
+                  std::vector<int> &chunk_indices, size_t offset, size_t length,
+                  std::vector<ChunkRange> &ranges);
+  int decode_range(std::string &dst, std::string &srcdir, std::string &filename,
+                   std::vector<int> &chunk_indices, size_t offset, size_t length);
   int repair_file_preprocess(std::string &srcdir, std::string &filename,
                              std::vector<int> &erasures,
                              std::vector<int> &chunks_to_retrieve);
@@ -0,0 +1,112 @@
+/**
+  * @file codings/liberation.cc
+  * @brief Implements the LiberationCode class.
+  * **/
+
+/* ===================================================================
+Copyright (c) 2026, the NCCloud contributors
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+  - Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+  - Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in
+    the documentation and/or other materials provided with the
+    distribution.
+
+  - Neither the name of the copyright holder nor the
+    names of its contributors may be used to endorse or promote
+    products derived from this software without specific prior written
+    permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT
+HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+=================================================================== */
+
+
+#include <iostream>
+
+#include "../common.h"
+#include "liberation.h"
+
+extern "C"
+{
+#include <liberation.h>
+}
+
+using namespace std;
+
+
+static bool is_prime(int p)
+{
+  if (p < 2) {
+    return false;
+  }
+  for (int i=2; i*i<=p; ++i) {
+    if (p % i == 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+
+/*  ----------------  */
+/* | Public methods | */
+/*  ----------------  */
+LiberationCode::LiberationCode(int k, int n, int w, int technique):
+  CRSCode(k, n, w), technique(technique)
+{
+}
+
+
+int LiberationCode::init(map<string,string> &coding_param)
+{
+  if (m != 2) {
+    print_error(stringstream() << "[Coding:LiberationCode] n-k must be 2." << endl);
+    return -1;
+  }
+  if (k > w) {
+    print_error(stringstream() << "[Coding:LiberationCode] k must not exceed w." << endl);
+    return -1;
+  }
+  if ((technique == LIBERATION && (w <= 2 || !is_prime(w))) ||
+      (technique == BLAUM_ROTH && (w <= 2 || !is_prime(w+1))) ||
+      (technique == LIBER8TION && w != 8)) {
+    print_error(stringstream() << "[Coding:LiberationCode] w must be a prime > 2 for"
+                               << " Liberation, one less than a prime for Blaum-Roth,"
+                               << " and 8 for Liber8tion." << endl);
+    return -1;
+  }
+  return CRSCode::init(coding_param);
+}
+
+
+/*  -----------------  */
+/* | Private methods | */
+/*  -----------------  */
+int *LiberationCode::create_bitmatrix(void)
+{
+  switch (technique) {
+    case BLAUM_ROTH:
+      return blaum_roth_coding_bitmatrix(k, w);
+    case LIBER8TION:
+      return liber8tion_coding_bitmatrix(k);
+    default:
+      return liberation_coding_bitmatrix(k, w);
+  }
+}
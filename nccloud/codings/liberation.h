@@ -0,0 +1,66 @@
+/**
+  * @file codings/liberation.h
+  * @brief Declares the LiberationCode class.
+  * **/
+
+/* ===================================================================
+Copyright (c) 2026, the NCCloud contributors
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+  - Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+  - Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in
+    the documentation and/or other materials provided with the
+    distribution.
+
+  - Neither the name of the copyright holder nor the
+    names of its contributors may be used to endorse or promote
+    products derived from this software without specific prior written
+    permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT
+HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+=================================================================== */
+
+
+#ifndef NCCLOUD_CODINGS_LIBERATION_H
+#define NCCLOUD_CODINGS_LIBERATION_H
+
+#include <map>
+#include <string>
+
+#include "crs.h"
+
+
+/** Coding module class for the minimal density RAID-6 codes (n-k=2):
+ *  Liberation, Blaum-Roth and Liber8tion.  Apart from the bitmatrix, coding
+ *  is identical to CRSCode. */
+class LiberationCode: public CRSCode
+{
+  int technique;
+
+  int *create_bitmatrix(void);
+
+public:
+  enum { LIBERATION = 0, BLAUM_ROTH = 1, LIBER8TION = 2 };
+
+  LiberationCode(int k, int n, int w, int technique);
+  int init(std::map<std::string, std::string> &coding_param);
+};
+
+#endif  /* NCCLOUD_CODINGS_LIBERATION_H */
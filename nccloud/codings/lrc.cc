@@ -0,0 +1,430 @@
+/**
+  * @file codings/lrc.cc
+  * @brief Implements the LRCCode class.
+  * **/
+
+/* ===================================================================
+Copyright (c) 2026, the NCCloud contributors
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+  - Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+  - Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in
+    the documentation and/or other materials provided with the
+    distribution.
+
+  - Neither the name of the copyright holder nor the
+    names of its contributors may be used to endorse or promote
+    products derived from this software without specific prior written
+    permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT
+HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+=================================================================== */
+
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <unistd.h>
+
+#include "../common.h"
+#include "lrc.h"
+
+extern "C"
+{
+#include <galois.h>
+#include <jerasure.h>
+#include <reed_sol.h>
+}
+
+using namespace std;
+
+
+/*  ----------------  */
+/* | Public methods | */
+/*  ----------------  */
+LRCCode::LRCCode(int k, int n, int w): n(n), k(k), l(0), r(0), w(w), coding_matrix(NULL)
+{
+}
+
+
+LRCCode::~LRCCode()
+{
+  reset();
+}
+
+
+int LRCCode::init(map<string,string> &coding_param)
+{
+  if (Coding::init(coding_param) == -1) {
+    return -1;
+  }
+  if (coding_param.count("l") != 1) {
+    print_error(stringstream() << "[Coding:LRCCode] l field missing." << endl);
+    return -1;
+  }
+  l = atoi(coding_param["l"].c_str());
+  r = n - k - l;
+  if (l < 1 || k % l != 0 || r < 0) {
+    print_error(stringstream() << "[Coding:LRCCode] l must divide k and be at most n-k."
+                               << endl);
+    return -1;
+  }
+  if (w != 8 && w != 16 && w != 32) {
+    print_error(stringstream() << "[Coding:LRCCode] w must be 8, 16 or 32." << endl);
+    return -1;
+  }
+  return 0;
+}
+
+
+int LRCCode::encode_file(string &dstdir, string &srcdir, string &filename)
+{
+  // map input file as aggregated data chunks, with room for padding
+  string src = srcdir + '/' + filename;
+  size_t filesize = file_size(src);
+  size_t padded_filesize = padded_size(filesize, k*8);
+  size_t chunksize = padded_filesize / k;
+  char *data = map_input(src, filesize, padded_filesize);
+
+  // pad file and split into data chunks for encoding
+  pad_data(data, filesize, k*8);
+  char **data_ptrs = new char*[k];
+  for (int i=0; i<k; ++i) {
+    data_ptrs[i] = data + i*chunksize;
+  }
+
+  // write chunk size to metadata file
+  string dst = dstdir + '/' + filename;
+  write_metadata(dst, chunksize, filesize);
+
+  // encode data chunks to local and global parities in one pass, straight into their mapped files
+  char **code_ptrs = new char*[n-k];
+  for (int i=k; i<n; ++i) {
+    string chunk_path = dst + ".chunk" + to_string(i);
+    code_ptrs[i-k] = map_output(chunk_path, chunksize);
+  }
+  init_coding_matrix();
+  jerasure_matrix_encode(k, n-k, w, coding_matrix, data_ptrs, code_ptrs, chunksize);
+  for (int i=k; i<n; ++i) {
+    unmap_file(code_ptrs[i-k], chunksize);
+  }
+  delete[] data_ptrs;
+  delete[] code_ptrs;
+
+  // write data chunks to files
+  vector<int> chunk_indices(k);
+  for (int i=0; i<k; ++i) {
+    chunk_indices[i] = i;
+  }
+  write_chunks(dst, chunksize, chunk_indices, data);
+  unmap_file(data, padded_filesize);
+
+  return 0;
+}
+
+
+int LRCCode::decode_nodes(vector<int> &healthy_nodes, vector<int> &nodes_to_retrieve)
+{
+  // unlike an MDS code, not every k chunks can be decoded
+  vector<int> candidates;
+  for (auto node : healthy_nodes) {
+    if (node >= 0 && node < n) {
+      candidates.push_back(node);
+    }
+  }
+  return select_sources(candidates, nodes_to_retrieve)? 0 : -1;
+}
+
+
+int LRCCode::decode_file(string &dst, string &srcdir, string &filename,
+                         vector<int> &chunk_indices)
+{
+  if (chunk_indices.size() < (unsigned int)k) {
+    print_error(stringstream() << "Insufficient chunks retrieved." << endl);
+    return -1;
+  }
+
+  // load chunk size from metadata
+  string src = srcdir + '/' + filename;
+  size_t chunksize = 0;
+  read_metadata(src, chunksize);
+
+  // find data chunks missing from the k chunks used for decoding
+  vector<int> sources(chunk_indices.begin(), chunk_indices.begin()+k);
+  vector<int> missing;
+  for (int i=0; i<k; ++i) {
+    if (find(sources.begin(), sources.end(), i) == sources.end()) {
+      missing.push_back(i);
+    }
+  }
+
+  int fd = open(dst.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (fd == -1) {
+    show_file_error("open", dst.c_str(), NULL);
+  }
+  if (missing.empty()) {
+    // systematic code: the padded file is just the data chunks in order
+    string chunk_partial_path = src + ".chunk";
+    for (int i=0; i<k; ++i) {
+      string chunk_path = chunk_partial_path + to_string(i);
+      append_chunk(fd, dst, chunk_path, chunksize);
+    }
+  } else {
+    // load the k retrieved chunks and compute only the missing data chunks
+    init_coding_matrix();
+    int *rows = decoding_rows(k, w, coding_matrix, sources, missing);
+    if (rows == NULL) {
+      close(fd);
+      return -1;
+    }
+    char *chunks = new char[k * chunksize];
+    read_chunks(src, chunksize, sources, chunks);
+    char **src_ptrs = new char*[k];
+    char **data_ptrs = new char*[k];
+    for (int i=0; i<k; ++i) {
+      src_ptrs[i] = chunks + i*chunksize;
+      if (sources[i] < k) {
+        data_ptrs[sources[i]] = src_ptrs[i];
+      }
+    }
+    char *decoded_chunks = new char[missing.size() * chunksize];
+    char **dst_ptrs = new char*[missing.size()];
+    for (unsigned int i=0; i<missing.size(); ++i) {
+      dst_ptrs[i] = decoded_chunks + i*chunksize;
+      data_ptrs[missing[i]] = dst_ptrs[i];
+      jerasure_matrix_dotprod(k, w, rows + i*k, NULL, k+i, src_ptrs, dst_ptrs, chunksize);
+    }
+    for (int i=0; i<k; ++i) {
+      append_data(fd, dst, data_ptrs[i], chunksize);
+    }
+    delete[] rows;
+    delete[] chunks;
+    delete[] src_ptrs;
+    delete[] data_ptrs;
+    delete[] decoded_chunks;
+    delete[] dst_ptrs;
+  }
+
+  trim_padding(fd, dst, k * chunksize, k*8);
+  close(fd);
+
+  return 0;
+}
+
+
+int LRCCode::repair_file_preprocess(string &srcdir, string &filename,
+                                    vector<int> &erasures,
+                                    vector<int> &chunks_to_retrieve)
+{
+  retrieved_chunk_indices.erase(retrieved_chunk_indices.begin(),
+                                retrieved_chunk_indices.end());
+  failed_nodes.erase(failed_nodes.begin(), failed_nodes.end());
+  for (auto e : erasures) {
+    failed_nodes.push_back(e);  // stored internally for repair_file()
+  }
+
+  if (erasures.size() == 1 && erasures[0] >= 0 && erasures[0] < k+l) {
+    // local repair: XOR the rest of the failed chunk's group
+    int group_size = k / l;
+    int group = (erasures[0] < k)? erasures[0] / group_size : erasures[0] - k;
+    for (int i=group*group_size; i<(group+1)*group_size; ++i) {
+      if (i != erasures[0]) {
+        retrieved_chunk_indices.push_back(i);
+      }
+    }
+    if (erasures[0] != k+group) {
+      retrieved_chunk_indices.push_back(k+group);
+    }
+  } else {
+    // global repair: any k independent surviving chunks
+    vector<int> candidates;
+    for (int i=0; i<n; ++i) {
+      if (find(erasures.begin(), erasures.end(), i) == erasures.end()) {
+        candidates.push_back(i);
+      }
+    }
+    if (!select_sources(candidates, retrieved_chunk_indices)) {
+      print_error(stringstream() << "Too many erasures." << endl);
+      return -1;
+    }
+  }
+  chunks_to_retrieve.insert(chunks_to_retrieve.end(),
+                            retrieved_chunk_indices.begin(), retrieved_chunk_indices.end());
+  return 0;
+}
+
+
+int LRCCode::repair_file(string &dstdir, string &srcdir, string &filename)
+{
+  // load chunk size from metadata
+  string src = srcdir + '/' + filename;
+  size_t chunksize = 0;
+  read_metadata(src, chunksize);
+
+  // load downloaded chunks
+  int num_sources = retrieved_chunk_indices.size();
+  char *chunks = new char[num_sources * chunksize];
+  read_chunks(src, chunksize, retrieved_chunk_indices, chunks);
+
+  // one row per failed chunk, expressing it in terms of the retrieved chunks
+  int *rows;
+  if (num_sources < k) {
+    // local repair: the failed chunk is the XOR of the rest of its group
+    rows = new int[num_sources];
+    for (int i=0; i<num_sources; ++i) {
+      rows[i] = 1;
+    }
+  } else {
+    init_coding_matrix();
+    rows = decoding_rows(k, w, coding_matrix, retrieved_chunk_indices, failed_nodes);
+    if (rows == NULL) {
+      delete[] chunks;
+      return -1;
+    }
+  }
+
+  // compute only the failed chunks, straight into the output buffer
+  char **src_ptrs = new char*[num_sources];
+  for (int i=0; i<num_sources; ++i) {
+    src_ptrs[i] = chunks + i*chunksize;
+  }
+  char *repaired_chunks = new char[failed_nodes.size() * chunksize];
+  char **dst_ptrs = new char*[failed_nodes.size()];
+  for (unsigned int i=0; i<failed_nodes.size(); ++i) {
+    dst_ptrs[i] = repaired_chunks + i*chunksize;
+    jerasure_matrix_dotprod(num_sources, w, rows + i*num_sources, NULL, num_sources+i,
+                            src_ptrs, dst_ptrs, chunksize);
+  }
+  delete[] rows;
+  delete[] src_ptrs;
+  delete[] dst_ptrs;
+  delete[] chunks;
+
+  // write repaired chunks to disk
+  string dst = dstdir + '/' + filename;
+  write_chunks(dst, chunksize, failed_nodes, repaired_chunks);
+  delete[] repaired_chunks;
+  return 0;
+}
+
+
+int LRCCode::getn(void) { return n; }
+int LRCCode::getk(void) { return k; }
+int LRCCode::nodeid(int index) { return index; }
+int LRCCode::chunks_per_node(void) { return 1; }
+
+
+int LRCCode::chunks_on_node(int node, vector<int> &chunk_indices)
+{
+  chunk_indices.push_back(node);
+  return (node>=0 && node<n)? 0 : -1;
+}
+
+
+void LRCCode::reset(void)
+{
+  reset_array<int>(&coding_matrix);
+  failed_nodes.erase(failed_nodes.begin(), failed_nodes.end());
+  retrieved_chunk_indices.erase(retrieved_chunk_indices.begin(),
+                                retrieved_chunk_indices.end());
+}
+
+
+/*  -----------------  */
+/* | Private methods | */
+/*  -----------------  */
+void LRCCode::init_coding_matrix(void)
+{
+  if (coding_matrix != NULL) {
+    return;
+  }
+  coding_matrix = new int[(n-k)*k];
+
+  // local parities: XOR of the data chunks in each group
+  int group_size = k / l;
+  for (int g=0; g<l; ++g) {
+    for (int j=0; j<k; ++j) {
+      coding_matrix[g*k + j] = (j/group_size == g)? 1 : 0;
+    }
+  }
+
+  // global parities: Vandermonde rows, skipping the all-ones row that the
+  // local parities already sum to
+  if (r > 0) {
+    int *matrix = reed_sol_vandermonde_coding_matrix(k, r+1, w);
+    memcpy(coding_matrix + l*k, matrix + k, r*k*sizeof(int));
+    free(matrix);
+  }
+}
+
+
+void LRCCode::generator_row(int index, int *row)
+{
+  if (index < k) {
+    memset(row, 0, k*sizeof(int));
+    row[index] = 1;
+  } else {
+    memcpy(row, coding_matrix + (index-k)*k, k*sizeof(int));
+  }
+}
+
+
+bool LRCCode::select_sources(vector<int> &candidates, vector<int> &sources)
+{
+  // greedily keep candidates whose generator rows are linearly independent,
+  // by Gaussian elimination against the rows kept so far
+  init_coding_matrix();
+  int *basis = new int[k*k];
+  int *pivots = new int[k];
+  int rank = 0;
+  for (auto index : candidates) {
+    if (rank == k) {
+      break;
+    }
+    int *row = basis + rank*k;
+    generator_row(index, row);
+    for (int b=0; b<rank; ++b) {
+      int coeff = row[pivots[b]];
+      if (coeff == 0) {
+        continue;
+      }
+      for (int j=0; j<k; ++j) {
+        row[j] ^= galois_single_multiply(coeff, basis[b*k + j], w);
+      }
+    }
+    int pivot = 0;
+    for ( ; pivot<k && row[pivot]==0; ++pivot);
+    if (pivot == k) {
+      continue;  // dependent on chunks already kept
+    }
+    int inv = galois_single_divide(1, row[pivot], w);
+    for (int j=0; j<k; ++j) {
+      row[j] = galois_single_multiply(row[j], inv, w);
+    }
+    pivots[rank++] = pivot;
+    sources.push_back(index);
+  }
+  delete[] basis;
+  delete[] pivots;
+  return rank == k;
+}
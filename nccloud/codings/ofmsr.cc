@@ -39,14 +39,27 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 =================================================================== */
 
 
+#include <algorithm>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <fcntl.h>
 #include <iostream>
+#include <thread>
+#include <unistd.h>
 
+#include "../arena.h"
+#include "../chacha20.h"
 #include "../common.h"
 #include "ofmsr.h"
 
+extern "C"
+{
+#include <fmsrutil.h>
+#include <gf.h>
+#include <matrix.h>
+}
+
 #define DEBUG_MODE
 
 #ifdef DEBUG_MODE
@@ -58,13 +71,16 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 using namespace std;
 
+/** Size of a sealed dummy seed in the metadata: a nonce and the encrypted seed. */
+static const size_t sealed_size = sizeof(uint64_t) + ChaCha20::key_size;
+
 
 /*  ----------------  */
 /* | Public methods | */
 /*  ----------------  */
 OFMSRCode::OFMSRCode(int k, int n, int t, int w):
     k(k), n(n), t(t), nn(fmsr_nn(k, n)), nc(fmsr_nc(k, n)),
-    encode_matrix(NULL), decode_matrix(NULL), repair_matrix(NULL),
+    encode_matrix(NULL), repair_matrix(NULL),
     gf_retrieved_chunk_indices(NULL), gf_repair_chunk_indices(NULL),
     hints((fmsr_repair_hints){255, 0})
 {
@@ -79,76 +95,115 @@ OFMSRCode::OFMSRCode(int k, int n, int t, int w):
 OFMSRCode::~OFMSRCode()
 {
   reset();
+  for (auto &it : dummies) {
+    memset(it.second.seed, 0, sizeof(it.second.seed));
+  }
+}
+
+
+int OFMSRCode::init(map<string,string> &coding_param)
+{
+  if (Coding::init(coding_param) == -1) {
+    return -1;
+  }
+  if (t < n) {
+    print_error(stringstream() << "[Coding:OFMSRCode] t must be at least n." << endl);
+    return -1;
+  }
+  if (coding_param.count("keyfile") == 1) {
+    if (read_keyfile(coding_param["keyfile"], master_key) == -1) {
+      print_error(stringstream() << "[Coding:OFMSRCode] keyfile must hold at least "
+                                 << ChaCha20::key_size << " bytes." << endl);
+      return -1;
+    }
+  }
+  return 0;
 }
 
 
 int OFMSRCode::encode_file(string &dstdir, string &srcdir, string &filename)
 {
-  // read input file as native chunks
-  string src = srcdir + '/' + filename;
-  FILE *infile = fopen(src.c_str(), "rb");
-  if (infile == NULL) {
-    show_file_error("fopen", src.c_str(), NULL);
+  // encode in memory, then write code chunks to files
+  char *code_chunks = NULL;
+  size_t chunksize = 0;
+  if (encode_buffer(dstdir, srcdir, filename, code_chunks, chunksize) == -1) {
+    return -1;
   }
-  fseek(infile, 0, SEEK_END);
-  size_t filesize = ftell(infile);
-  size_t padded_filesize = fmsr_padded_size(k, n, filesize);
-  rewind(infile);
-  gf *native_chunks = new gf[padded_filesize];
-  if (fread(native_chunks, 1, filesize, infile) != filesize) {
-    show_file_error("fread", src.c_str(), infile);
+  string dst = dstdir + '/' + filename;
+  vector<int> chunk_indices(nc);
+  for (unsigned int i=0; i<nc; ++i) {
+    chunk_indices[i] = i;
   }
-  fclose(infile);
+  write_chunks(dst, chunksize, chunk_indices, code_chunks);
+  BufferArena::instance()->release(code_chunks);
+
+  return 0;
+}
+
+
+int OFMSRCode::encode_segment(string &dstdir, string &src, size_t offset, size_t size,
+                              string &filename, char* &chunks, size_t &chunksize)
+{
+  // map input range as native chunks, with room for padding
+  size_t filesize = size;
+  size_t padded_filesize = fmsr_padded_size(k, n, filesize);
+  gf *native_chunks = (gf *)map_input(src, filesize, padded_filesize, offset);
 
   // encode native chunks to code chunks
-  size_t chunksize = padded_filesize / nn;
-  gf *code_chunks = new gf[nc * chunksize];
+  chunksize = padded_filesize / nn;
+  gf *code_chunks = (gf *)BufferArena::instance()->acquire(nc * chunksize);
+  unique_lock<mutex> lock(metadata_mutex);  // held only while creating the matrix
   int create_new = encode_matrix? 0 : 1;
   if (create_new) {
     encode_matrix = new gf[nc*nn];
+  } else {
+    lock.unlock();
+  }
+  uint64_t key_nonce = new_key_nonce();
+  int result = key_nonce?
+      encrypt_encode(native_chunks, filesize, create_new, code_chunks, key_nonce) :
+      fmsr_encode(k, n, native_chunks, filesize, create_new, code_chunks, encode_matrix);
+  if (lock.owns_lock()) {
+    lock.unlock();
   }
-  int result = fmsr_encode(k, n, native_chunks, filesize, create_new,
-                           code_chunks, encode_matrix);
   if (result == -1) {
-    print_error(stringstream() << "FMSR not supported for k= " << k
+    print_error(stringstream() << "FMSR not supported for k=" << k
                                << " and n=" << n << endl);
     return -1;
   }
-  delete[] native_chunks;
+  unmap_file((char *)native_chunks, padded_filesize);
 
-  // write encoding matrix, chunk size and default repair hints to metadata file
-  string dst = dstdir + '/' + filename;
-  write_metadata(dst, chunksize);
+  // pick a fresh seed for the dummy chunks of this file
+  unsigned char seed[ChaCha20::key_size];
+  if (ChaCha20::random_key(seed) == -1) {
+    show_error("random_key");
+  }
 
-  // write code chunks to files
-  vector<int> chunk_indices(nc);
-  for (unsigned int i=0; i<nc; ++i) {
-    chunk_indices[i] = i;
+  // write encoding matrix, chunk size, default repair hints and sealed seed
+  // to metadata file
+  string dst = dstdir + '/' + filename;
+  lock.lock();
+  seal_seed(seed);
+  write_metadata(dst, chunksize, filesize, key_nonce);
+  lock.unlock();
+
+  // the t-n dummy chunks are generated from the seed during upload
+  vector<int> dummy_indices;
+  for (int i=0; i<n; ++i) {
+    dummy_chunks_on_node(i, dummy_indices);
   }
-  write_chunks(dst, chunksize, chunk_indices, (char *)code_chunks);
-	
-	// dummy chunks  
-	// FIXME:
-  int on = t-n;
-  vector<int> dummy_chunk_indices(on);
-  for (unsigned int i=nc; i<nc+(unsigned int)on; ++i) {
-		INFO("index i = " << i);
-		dummy_chunk_indices[i - nc] = i;
-    	INFO("dummy_chunk_indices[i - nc] = " << dummy_chunk_indices[i - nc]);
-  }
-  write_dummy_chunks(dst, chunksize, dummy_chunk_indices);
-  
-  delete[] code_chunks;
+  add_dummies(filename, seed, chunksize, dummy_indices);
+  memset(seed, 0, sizeof(seed));
 
+  chunks = (char *)code_chunks;
   return 0;
 }
 
 
 int OFMSRCode::decode_file(string &dst, string &srcdir, string &filename,
-                          vector<int> &chunk_indices)
+                           vector<int> &chunk_indices)
 {
-  unsigned int num_chunks = chunk_indices.size();
-  if (num_chunks < nn) {
+  if (chunk_indices.size() < nn) {
     print_error(stringstream() << "Insufficient chunks retrieved." << endl);
     return -1;
   }
@@ -159,34 +214,108 @@ int OFMSRCode::decode_file(string &dst, string &srcdir, string &filename,
   read_metadata(src, chunksize);
 
   // load code chunks
-  gf *code_chunks = new gf[nn * chunksize];
+  gf *code_chunks = (gf *)BufferArena::instance()->acquire(nn * chunksize);
   read_chunks(src, chunksize, chunk_indices, (char *)code_chunks);
+  int result = decode_chunks(dst, chunksize, chunk_indices, code_chunks, read_key_nonce(src));
+  BufferArena::instance()->release(code_chunks);
+  return result;
+}
+
 
-  // decode code chunks into original data
-  reset_array<gf>(&gf_retrieved_chunk_indices, num_chunks);
-  for (unsigned int i=0; i<num_chunks; ++i) {
-    gf_retrieved_chunk_indices[i] = (gf)chunk_indices[i];
+int OFMSRCode::decode_buffer(string &dst, string &srcdir, string &filename,
+                             vector<int> &chunk_indices, vector<char *> &chunks)
+{
+  if (chunk_indices.size() < nn) {
+    print_error(stringstream() << "Insufficient chunks retrieved." << endl);
+    return -1;
   }
-  int create_new = decode_matrix? 0 : 1;
-  if (create_new) {
-    decode_matrix = new gf[nn*nn];
+
+  // load encoding matrix and chunk size
+  string src = srcdir + '/' + filename;
+  size_t chunksize = 0;
+  read_metadata(src, chunksize);
+
+  // gather code chunks, as libfmsr takes them in one buffer
+  gf *code_chunks = (gf *)BufferArena::instance()->acquire(nn * chunksize);
+  for (unsigned int i=0; i<nn; ++i) {
+    memcpy(code_chunks + i*chunksize, chunks[i], chunksize);
   }
-  gf *decoded_file = new gf[nn * chunksize];
-  size_t decoded_filesize = 0;
-  int result = fmsr_decode(k, n, code_chunks, chunksize,
-                           gf_retrieved_chunk_indices, num_chunks, encode_matrix,
-                           decode_matrix, create_new,
-                           decoded_file, &decoded_filesize);
-  if (result == -1) {
-    print_error(stringstream() << "Invalid parameters passed to fmsr_decode()" << endl);
+  int result = decode_chunks(dst, chunksize, chunk_indices, code_chunks, read_key_nonce(src));
+  BufferArena::instance()->release(code_chunks);
+  return result;
+}
+
+
+int OFMSRCode::range_reads(string &srcdir, string &filename, vector<int> &chunk_indices,
+                           size_t offset, size_t length, vector<ChunkRange> &ranges)
+{
+  if (chunk_indices.size() < nn) {
+    print_error(stringstream() << "Insufficient chunks retrieved." << endl);
+    return -1;
+  }
+
+  // a native chunk range is decoded from the same range of the nn code chunks
+  string src = srcdir + '/' + filename;
+  if (read_filesize(src) == Metadata::unknown_filesize) {
+    return -1;  // legacy metadata gives no file size to clip the range to
+  }
+  vector<ChunkRange> pieces;
+  native_pieces(src, offset, length, pieces);
+  for (auto &piece : pieces) {
+    for (unsigned int i=0; i<nn; ++i) {
+      add_range(ranges, chunk_indices[i], piece.offset, piece.length);
+    }
+  }
+  return 0;
+}
+
+
+int OFMSRCode::decode_range(string &dst, string &srcdir, string &filename,
+                            vector<int> &chunk_indices, size_t offset, size_t length)
+{
+  if (chunk_indices.size() < nn) {
+    print_error(stringstream() << "Insufficient chunks retrieved." << endl);
+    return -1;
+  }
+
+  // load encoding matrix, and invert the rows of the code chunks retrieved
+  string src = srcdir + '/' + filename;
+  size_t chunksize = 0;
+  read_metadata(src, chunksize);
+  vector<ChunkRange> pieces;
+  native_pieces(src, offset, length, pieces);
+  gf *decode_matrix = decoding_matrix(chunk_indices);
+  if (decode_matrix == NULL) {
     return -1;
   }
-  delete[] code_chunks;
 
-  // write decoded file to dst
-  write_file(dst, (char *)decoded_file, decoded_filesize);
-  delete[] decoded_file;
+  // each native chunk range is a row of the inverse times the code chunk
+  // ranges, decrypted if the file is encrypted
+  uint64_t key_nonce = read_key_nonce(src);
+  int fd = open(dst.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd == -1) {
+    show_file_error("open", dst.c_str(), NULL);
+  }
+  for (auto &piece : pieces) {
+    gf *data = (gf *)BufferArena::instance()->acquire(piece.length);
+    gf *code = (gf *)BufferArena::instance()->acquire(piece.length);
+    gf *row = decode_matrix + piece.chunk_index*nn;
+    for (unsigned int i=0; i<nn; ++i) {
+      read_chunk_range(src, chunk_indices[i], piece.offset, piece.length, (char *)code);
+      if (i == 0) {
+        gf_mul_bytes(code, piece.length, row[i], data);
+      } else {
+        gf_mulxor_bytes(code, piece.length, row[i], data);
+      }
+    }
+    crypt_range(key_nonce, piece.chunk_index, piece.offset, (char *)data, piece.length);
+    append_data(fd, dst, (char *)data, piece.length);
+    BufferArena::instance()->release((char *)code);
+    BufferArena::instance()->release((char *)data);
+  }
+  close(fd);
 
+  delete[] decode_matrix;
   return 0;
 }
 
@@ -248,7 +377,7 @@ int OFMSRCode::repair_file_preprocess(string &srcdir, string &filename,
   // write new encoding matrix and new repair hints to metadata
   memcpy(encode_matrix, new_encode_matrix, nc*nn);
   delete[] new_encode_matrix;
-  write_metadata(src, chunksize);
+  update_metadata(src);
 
   return 0;
 }
@@ -260,10 +389,10 @@ int OFMSRCode::repair_file(string &dstdir, string &srcdir, string &filename)
   string src = srcdir + '/' + filename;
   size_t chunksize = 0;
   read_metadata(src, chunksize);
-  write_metadata(src, chunksize); // update encoding matrix and repair hints
+  update_metadata(src);  // update encoding matrix and repair hints
 
   // load retrieved chunks
-  gf *retrieved_chunks = new gf[(n-1) * chunksize];
+  gf *retrieved_chunks = (gf *)BufferArena::instance()->acquire((n-1) * chunksize);
   if (gf_retrieved_chunk_indices == NULL) {
     return -1;  // haven't called repair_file_preprocess()?
   }
@@ -277,11 +406,11 @@ int OFMSRCode::repair_file(string &dstdir, string &srcdir, string &filename)
   if (chunks_per_node() == -1) {
     return -1;
   }
-  gf *new_code_chunks = new gf[chunks_per_node() * chunksize];
+  gf *new_code_chunks = (gf *)BufferArena::instance()->acquire(chunks_per_node() * chunksize);
   fmsr_regenerate(repair_matrix, chunks_per_node(), n-1,
                   retrieved_chunks, chunksize,
                   new_code_chunks);
-  delete[] retrieved_chunks;
+  BufferArena::instance()->release(retrieved_chunks);
 
   // write new chunks to dstdir
   if (gf_repair_chunk_indices == NULL) {
@@ -293,7 +422,16 @@ int OFMSRCode::repair_file(string &dstdir, string &srcdir, string &filename)
   }
   string dst = dstdir + '/' + filename;
   write_chunks(dst, chunksize, repair_chunk_indices, (char *)new_code_chunks);
-  delete[] new_code_chunks;
+  BufferArena::instance()->release(new_code_chunks);
+
+  // the dummy chunks of the failed node are regenerated from the seed during
+  // upload, with no downloads
+  vector<int> dummy_indices;
+  dummy_chunks_on_node(gf_repair_chunk_indices[0] / chunks_per_node(), dummy_indices);
+  unsigned char seed[ChaCha20::key_size];
+  dummy_seed(seed);
+  add_dummies(filename, seed, chunksize, dummy_indices);
+  memset(seed, 0, sizeof(seed));
 
   return 0;
 }
@@ -301,10 +439,15 @@ int OFMSRCode::repair_file(string &dstdir, string &srcdir, string &filename)
 
 int OFMSRCode::getn(void) { return (int)n; }
 int OFMSRCode::getk(void) { return (int)k; }
+int OFMSRCode::buffered_io(void) { return 1; }
+int OFMSRCode::encryption(void) { return 1; }
 
 
 int OFMSRCode::nodeid(int index)
 {
+  if (index >= nc && index < nc+t-n) {
+    return (index - nc) % n;  // dummy chunks are dealt out round-robin
+  }
   return (index>255 || index<0)? -1 : (int)(char)fmsr_nodeid(k, n, index);
 }
 
@@ -333,93 +476,350 @@ int OFMSRCode::chunks_on_node(int node, std::vector<int> &chunk_indices)
 }
 
 
+int OFMSRCode::dummy_chunks_on_node(int node, std::vector<int> &chunk_indices)
+{
+  if (node < 0 || node >= n) {
+    return -1;
+  }
+  for (int i=nc+node; i<nc+t-n; i+=n) {
+    chunk_indices.push_back(i);
+  }
+  return 0;
+}
+
+
+int OFMSRCode::generate_dummy_chunk(string &filename, int chunk_index,
+                                    char* &data, size_t &size)
+{
+  // take a copy of the seed, forgetting it once the last pending dummy chunk
+  // of the file is generated
+  unsigned char seed[ChaCha20::key_size];
+  dummies_mutex.lock();
+  auto it = dummies.find(filename);
+  vector<int>::iterator pending;
+  if (it == dummies.end() ||
+      (pending = find(it->second.pending.begin(), it->second.pending.end(), chunk_index)) ==
+      it->second.pending.end()) {
+    dummies_mutex.unlock();
+    return -1;
+  }
+  memcpy(seed, it->second.seed, sizeof(seed));
+  size = it->second.chunksize;
+  it->second.pending.erase(pending);
+  if (it->second.pending.empty()) {
+    memset(it->second.seed, 0, sizeof(it->second.seed));
+    dummies.erase(it);
+  }
+  dummies_mutex.unlock();
+
+  data = BufferArena::instance()->acquire(size);
+  fill_dummy_chunk(seed, chunk_index, data, size);
+  memset(seed, 0, sizeof(seed));
+  return 0;
+}
+
+
 void OFMSRCode::reset(void)
 {
   reset_array<gf>(&encode_matrix);
-  reset_array<gf>(&decode_matrix);
   reset_array<gf>(&repair_matrix);
   reset_array<gf>(&gf_retrieved_chunk_indices);
   reset_array<gf>(&gf_repair_chunk_indices);
+  sealed_seed.clear();
 }
 
 
 /*  -----------------  */
 /* | Private methods | */
 /*  -----------------  */
+int OFMSRCode::decode_chunks(string &dst, size_t chunksize, vector<int> &chunk_indices,
+                             gf *code_chunks, uint64_t key_nonce)
+{
+  if (key_nonce != 0) {
+    return decrypt_decode(dst, chunksize, chunk_indices, code_chunks, key_nonce);
+  }
+
+  // decode code chunks into original data (with local state, as several
+  // segments of a file may be decoded at once)
+  gf *retrieved_chunk_indices = new gf[nn];
+  for (unsigned int i=0; i<nn; ++i) {
+    retrieved_chunk_indices[i] = (gf)chunk_indices[i];
+  }
+  gf *decode_matrix = new gf[nn*nn];
+  gf *decoded_file = (gf *)map_output(dst, nn * chunksize);
+  size_t decoded_filesize = 0;
+  int result = fmsr_decode(k, n, code_chunks, chunksize,
+                           retrieved_chunk_indices, nn, encode_matrix,
+                           decode_matrix, 1,
+                           decoded_file, &decoded_filesize);
+  delete[] retrieved_chunk_indices;
+  delete[] decode_matrix;
+  if (result == -1) {
+    print_error(stringstream() << "Invalid parameters passed to fmsr_decode()" << endl);
+    return -1;
+  }
+
+  // decoded straight into dst, which only needs trimming to the original size
+  unmap_file((char *)decoded_file, nn * chunksize);
+  if (truncate(dst.c_str(), decoded_filesize) == -1) {
+    show_file_error("truncate", dst.c_str(), NULL);
+  }
+
+  return 0;
+}
+
+
+size_t OFMSRCode::native_pieces(string &src, size_t offset, size_t &length,
+                                vector<ChunkRange> &pieces)
+{
+  // clip the range to the file, whose bytes are the native chunks in order
+  Metadata meta;
+  load_metadata(src, meta);
+  size_t filesize = meta.header.filesize;
+  length = offset < filesize? min(length, filesize - offset) : 0;
+  split_range(meta.header.chunksize, offset, offset + length, pieces);
+  return meta.header.chunksize;
+}
+
+
+int OFMSRCode::encrypt_encode(gf *native_chunks, size_t filesize, int create_new,
+                              gf *code_chunks, uint64_t key_nonce)
+{
+  // as fmsr_encode(), but encrypting each tile of the native chunks right
+  // before multiplying it, while it is still in the cache
+  if (!fmsr_encode_support(k, n)) {
+    return -1;
+  }
+  if (create_new) {
+    fmsr_create_encode_matrix(k, n, encode_matrix);
+  }
+  fmsr_pad_data(k, n, native_chunks, filesize);
+  size_t chunksize = fmsr_padded_size(k, n, filesize) / nn;
+  size_t tile = crypt_tile_size(nn + nc);
+  for (size_t offset=0; offset<chunksize; offset+=tile) {
+    size_t size = min(tile, chunksize - offset);
+    for (unsigned int j=0; j<nn; ++j) {
+      crypt_range(key_nonce, j, offset, (char *)native_chunks + j*chunksize + offset, size);
+    }
+    for (unsigned int i=0; i<nc; ++i) {
+      gf *code = code_chunks + i*chunksize + offset;
+      gf *row = encode_matrix + i*nn;
+      gf_mul_bytes(native_chunks + offset, size, row[0], code);
+      for (unsigned int j=1; j<nn; ++j) {
+        gf_mulxor_bytes(native_chunks + j*chunksize + offset, size, row[j], code);
+      }
+    }
+  }
+  return 0;
+}
+
+
+int OFMSRCode::decrypt_decode(string &dst, size_t chunksize, vector<int> &chunk_indices,
+                              gf *code_chunks, uint64_t key_nonce)
+{
+  // as fmsr_decode(), but decrypting each tile of the native chunks right
+  // after computing it, while it is still in the cache
+  gf *decode_matrix = decoding_matrix(chunk_indices);
+  if (decode_matrix == NULL) {
+    return -1;
+  }
+  gf *decoded_file = (gf *)map_output(dst, nn * chunksize);
+  size_t tile = crypt_tile_size(nn + nn);
+  for (size_t offset=0; offset<chunksize; offset+=tile) {
+    size_t size = min(tile, chunksize - offset);
+    for (unsigned int j=0; j<nn; ++j) {
+      gf *data = decoded_file + j*chunksize + offset;
+      gf *row = decode_matrix + j*nn;
+      gf_mul_bytes(code_chunks + offset, size, row[0], data);
+      for (unsigned int i=1; i<nn; ++i) {
+        gf_mulxor_bytes(code_chunks + i*chunksize + offset, size, row[i], data);
+      }
+      crypt_range(key_nonce, j, offset, (char *)data, size);
+    }
+  }
+  delete[] decode_matrix;
+
+  // the padding is only visible once decrypted
+  size_t decoded_filesize = fmsr_unpad_data(decoded_file, nn * chunksize);
+  unmap_file((char *)decoded_file, nn * chunksize);
+  if (truncate(dst.c_str(), decoded_filesize) == -1) {
+    show_file_error("truncate", dst.c_str(), NULL);
+  }
+  return 0;
+}
+
+
+gf *OFMSRCode::decoding_matrix(vector<int> &chunk_indices)
+{
+  // invert the rows of the encoding matrix of the first nn chunks
+  gf *decode_matrix = new gf[nn*nn];
+  for (unsigned int i=0; i<nn; ++i) {
+    memcpy(decode_matrix + i*nn, encode_matrix + chunk_indices[i]*nn, nn);
+  }
+  if (matrix_invert(decode_matrix, nn) == -1) {
+    print_error(stringstream() << "[Coding:OFMSRCode] retrieved chunks are not decodable." << endl);
+    delete[] decode_matrix;
+    return NULL;
+  }
+  return decode_matrix;
+}
+
+
 void OFMSRCode::read_metadata(string &path, size_t &chunksize)
 {
   // read encoding matrix, chunk size and repair hints from existing metadata
-  string meta_path = path + ".meta";
-  FILE *metafile = fopen(meta_path.c_str(), "rb");
-  if (metafile == NULL) {
-    show_file_error("fopen", meta_path.c_str(), NULL);
-  }
-  int update = 0;
-  if (encode_matrix == NULL) {
-    update = 1;
-    encode_matrix = new gf[nc*nn];
-    if (fread(encode_matrix, 1, nc*nn, metafile) != nc*nn) {
-      show_file_error("fread", meta_path.c_str(), metafile);
-    }
+  Metadata meta;
+  load_metadata(path, meta);
+  if (meta.payload.size() < (size_t)nc*nn) {
+    print_error(stringstream() << "[Coding:OFMSRCode] encoding matrix missing from metadata." << endl);
+    exit(-1);
   }
-  fseek(metafile, nc*nn, SEEK_SET);
-  char stchunksize[25] = {0};
-  if (fread(stchunksize, 1, 24, metafile) <= 0) {
-    show_file_error("fread", meta_path.c_str(), metafile);
+  lock_guard<mutex> lock(metadata_mutex);
+  if (encode_matrix == NULL) {  // prevents overwriting new hints with stale hints
+    encode_matrix = new gf[nc*nn];
+    memcpy(encode_matrix, meta.payload.data(), nc*nn);
+    hints.last_repaired = meta.header.hints & 0xff;
+    hints.last_used = meta.header.hints >> 8;
   }
-  int st_len = strlen(stchunksize);
-  if (update) {  // prevents overwriting new hints with stale hints
-    hints.last_used = stchunksize[st_len-1] - '0';
-    stchunksize[st_len-1] = 0;
-    hints.last_repaired = strtoul(&stchunksize[st_len-4], NULL, 10);
+  if (meta.payload.size() == (size_t)nc*nn + sealed_size) {
+    sealed_seed.assign(meta.payload, nc*nn, sealed_size);
+  } else {
+    sealed_seed.clear();
   }
-  stchunksize[st_len-4] = 0;
-  chunksize = strtoul(stchunksize, NULL, 10);
-  fclose(metafile);
+  chunksize = meta.header.chunksize;
 }
 
 
-void OFMSRCode::write_metadata(string &path, size_t chunksize)
+int OFMSRCode::parse_legacy_metadata(string &data, Metadata &meta)
 {
-	//TODO: change path to local/path
-	
-	// write encoding matrix, chunk size and repair hints to metadata
-  string meta_path = path + ".meta";
-  FILE *metafile = fopen(meta_path.c_str(), "wb");
-  if (metafile == NULL) {
-    show_file_error("fopen", meta_path.c_str(), NULL);
+  // the encoding matrix, then the chunk size and four digits of repair hints
+  // in ASCII (the previously repaired node, then the chunk used in that repair),
+  // then 'S' and the sealed seed if the file has dummy chunks
+  if (data.size() < (size_t)nc*nn + 5) {
+    return -1;
   }
-  if (fwrite(encode_matrix, 1, nc*nn, metafile) != nc*nn) {
-    show_file_error("fwrite", meta_path.c_str(), metafile);
+  size_t size = data.size() - nc*nn;
+  size_t len = strspn(data.c_str() + nc*nn, "0123456789");
+  if (len < 5 ||
+      (len != size && (size != len + 1 + sealed_size || data[nc*nn + len] != 'S'))) {
+    return -1;
   }
-  string stchunksize = to_string(chunksize);
-  if (fwrite(stchunksize.c_str(), 1, stchunksize.length(), metafile)
-      != stchunksize.length()) {
-    show_file_error("fwrite", meta_path.c_str(), metafile);
+  unsigned long sthints = strtoul(data.substr(nc*nn + len - 4, 4).c_str(), NULL, 10);
+  meta.header.hints = (sthints / 10) | ((sthints % 10) << 8);
+  meta.header.chunksize = strtoull(data.substr(nc*nn, len - 4).c_str(), NULL, 10);
+  meta.payload.assign(data, 0, nc*nn);
+  if (len != size) {
+    meta.payload.append(data, nc*nn + len + 1, sealed_size);
   }
-  string sthints = to_string((unsigned long)hints.last_repaired*10 + hints.last_used);
-  sthints.insert(0, string(4-sthints.length(), '0'));
-  if (fwrite(sthints.c_str(), 1, sthints.length(), metafile) != sthints.length()) {
-    show_file_error("fwrite", meta_path.c_str(), metafile);
+  return 0;
+}
+
+
+void OFMSRCode::write_metadata(string &path, size_t chunksize, size_t filesize,
+                               uint64_t key_nonce)
+{
+  // write encoding matrix, chunk size and repair hints to metadata
+  Metadata meta;
+  meta.header.chunksize = chunksize;
+  meta.header.filesize = filesize;
+  meta.header.key_nonce = key_nonce;
+  fill_metadata(meta);
+  save_metadata(path, meta);
+}
+
+
+void OFMSRCode::update_metadata(string &path)
+{
+  // replace encoding matrix and repair hints, keeping the rest of the metadata
+  Metadata meta;
+  load_metadata(path, meta);
+  fill_metadata(meta);
+  save_metadata(path, meta);
+}
+
+
+void OFMSRCode::fill_metadata(Metadata &meta)
+{
+  meta.header.hints = hints.last_repaired | (hints.last_used << 8);
+  meta.payload.assign((char *)encode_matrix, nc*nn);
+  meta.payload.append(sealed_seed);
+}
+
+
+void OFMSRCode::seal_seed(unsigned char *seed)
+{
+  // encrypt the seed under the master key with a random nonce, if we have a key
+  sealed_seed.clear();
+  if (master_key.empty()) {
+    return;
+  }
+  unsigned char sealed[sealed_size];
+  if (ChaCha20::random_key(sealed) == -1) {
+    show_error("random_key");
   }
-  fclose(metafile);
+  uint64_t nonce;
+  memcpy(&nonce, sealed, sizeof(nonce));
+  memcpy(sealed + sizeof(nonce), seed, ChaCha20::key_size);
+  ChaCha20((unsigned char *)master_key.data(), nonce).xor_keystream(
+      sealed + sizeof(nonce), ChaCha20::key_size);
+  sealed_seed.assign((char *)sealed, sealed_size);
 }
 
 
-void OFMSRCode::write_dummy_chunks(string &path, size_t chunksize,
-                          vector<int> &chunk_indices)
+void OFMSRCode::dummy_seed(unsigned char *seed)
 {
-  // write chunks in the buffer "chunks" to their corresponding destinations
-  string chunk_partial_path = path + ".chunk";
-  for (unsigned int i=0; i<chunk_indices.size(); ++i) {
-  	char buffer[chunksize];
-		for (size_t i = 0; i < chunksize; i++)
-		{
-			buffer[i] = (char) (rand() % 256);
-		}
-    string chunk_path = chunk_partial_path + to_string(chunk_indices[i]);
-    INFO("write dummy chunks: string chunk_path = " << chunk_path << ", i = " << i << ", chunksize = " << chunksize << ", index = " << chunk_indices[i] );
-    write_file(chunk_path, buffer, chunksize);
+  // Decrypt the seed of the current file.  Without a key or a sealed seed,
+  // any fresh random seed does: no one ever reads dummy chunks.
+  if (master_key.empty() || sealed_seed.empty()) {
+    if (ChaCha20::random_key(seed) == -1) {
+      show_error("random_key");
+    }
+    return;
+  }
+  uint64_t nonce;
+  memcpy(&nonce, sealed_seed.data(), sizeof(nonce));
+  memcpy(seed, sealed_seed.data() + sizeof(nonce), ChaCha20::key_size);
+  ChaCha20((unsigned char *)master_key.data(), nonce).xor_keystream(
+      seed, ChaCha20::key_size);
+}
+
+
+void OFMSRCode::add_dummies(string &filename, unsigned char *seed, size_t chunksize,
+                            vector<int> &chunk_indices)
+{
+  if (chunk_indices.empty()) {
+    return;
   }
+  lock_guard<mutex> lock(dummies_mutex);
+  DummyInfo &info = dummies[filename];
+  memcpy(info.seed, seed, sizeof(info.seed));
+  info.chunksize = chunksize;
+  info.pending = chunk_indices;
 }
 
+
+void OFMSRCode::fill_dummy_chunk(unsigned char *seed, int chunk_index,
+                                 char *chunk, size_t chunksize)
+{
+  // Dummy chunks are ChaCha20 keystream keyed by the seed of the file, with
+  // the chunk index as nonce, so they look as uniform as the real code chunks
+  // and any of them can be regenerated on its own.
+  ChaCha20 generator(seed, chunk_index);
+
+  // split the chunk into block-aligned pieces so that all cores are busy
+  unsigned int num_threads = max(thread::hardware_concurrency(), 1u);
+  size_t blocks_per_chunk = (chunksize + ChaCha20::block_size - 1) / ChaCha20::block_size;
+  size_t blocks_per_piece = (blocks_per_chunk + num_threads - 1) / num_threads;
+  size_t piece_size = max(blocks_per_piece, (size_t)1) * ChaCha20::block_size;
+
+  vector<thread> threads;
+  for (size_t offset=0; offset<chunksize; offset+=piece_size) {
+    threads.push_back(thread(&ChaCha20::keystream, &generator,
+                             (unsigned char *)chunk + offset,
+                             min(piece_size, chunksize - offset),
+                             offset / ChaCha20::block_size));
+  }
+  for (unsigned int i=0; i<threads.size(); ++i) {
+    threads[i].join();
+  }
+}
@@ -44,6 +44,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef NCCLOUD_CODINGS_OFMSR_H
 #define NCCLOUD_CODINGS_OFMSR_H
 
+#include <map>
+#include <mutex>
 #include <vector>
 #include <string>
 
@@ -64,20 +66,62 @@ typedef unsigned char gf;
 class OFMSRCode: public Coding
 {
   gf k, n, t, nn, nc;  // (n,k)-FMSR code with nn native chunks and nc code chunks
-  gf *encode_matrix, *decode_matrix, *repair_matrix;
+  gf *encode_matrix, *repair_matrix;
   gf *gf_retrieved_chunk_indices;  // chunks retrieved during download or repair
   gf *gf_repair_chunk_indices;     // chunks to repair
   fmsr_repair_hints hints;         // info about previous repair for use in the next repair
+  std::string master_key;   // key from keyfile that seals the per-file dummy seeds (if any)
+  std::string sealed_seed;  // nonce and encrypted dummy seed of the current file (if any)
+
+  // seed and chunk size of the dummy chunks of each file, kept until they are uploaded
+  struct DummyInfo {
+    unsigned char seed[32];
+    size_t chunksize;
+    std::vector<int> pending;  // dummy chunks not generated yet
+  };
+  std::map<std::string, DummyInfo> dummies;
+  std::mutex dummies_mutex;
+  std::mutex metadata_mutex;  // guards the encoding matrix and sealed seed
 
   void read_metadata(std::string &path, size_t &chunksize);
-  void write_metadata(std::string &path, size_t chunksize);
+  void write_metadata(std::string &path, size_t chunksize, size_t filesize,
+                      uint64_t key_nonce=0);
+  void update_metadata(std::string &path);
+  void fill_metadata(Metadata &meta);
+  int parse_legacy_metadata(std::string &data, Metadata &meta);
+  int decode_chunks(std::string &dst, size_t chunksize, std::vector<int> &chunk_indices,
+                    gf *code_chunks, uint64_t key_nonce);
+  int encrypt_encode(gf *native_chunks, size_t filesize, int create_new,
+                     gf *code_chunks, uint64_t key_nonce);
+  int decrypt_decode(std::string &dst, size_t chunksize, std::vector<int> &chunk_indices,
+                     gf *code_chunks, uint64_t key_nonce);
+  gf *decoding_matrix(std::vector<int> &chunk_indices);
+  size_t native_pieces(std::string &src, size_t offset, size_t &length,
+                       std::vector<ChunkRange> &pieces);
+  void seal_seed(unsigned char *seed);
+  void dummy_seed(unsigned char *seed);
+  void add_dummies(std::string &filename, unsigned char *seed, size_t chunksize,
+                   std::vector<int> &chunk_indices);
+  void fill_dummy_chunk(unsigned char *seed, int chunk_index, char *chunk, size_t chunksize);
 
 public:
   OFMSRCode(int k, int n, int t, int w);
   ~OFMSRCode();
+  int init(std::map<std::string, std::string> &coding_param);
   int encode_file(std::string &dstdir, std::string &srcdir, std::string &filename);
   int decode_file(std::string &dst, std::string &srcdir, std::string &filename,
                   std::vector<int> &chunk_indices);
+  int buffered_io(void);
+  int encryption(void);
+  int encode_segment(std::string &dstdir, std::string &src, size_t offset, size_t size,
+                     std::string &filename, char* &chunks, size_t &chunksize);
+  int decode_buffer(std::string &dst, std::string &srcdir, std::string &filename,
+                    std::vector<int> &chunk_indices, std::vector<char *> &chunks);
+  int range_reads(std::string &srcdir, std::string &filename,
+                  std::vector<int> &chunk_indices, size_t offset, size_t length,
+                  std::vector<ChunkRange> &ranges);
+  int decode_range(std::string &dst, std::string &srcdir, std::string &filename,
+                   std::vector<int> &chunk_indices, size_t offset, size_t length);
   int repair_file_preprocess(std::string &srcdir, std::string &filename,
                              std::vector<int> &erasures,
                              std::vector<int> &chunks_to_retrieve);
@@ -88,8 +132,9 @@ public:
   int nodeid(int index);
   int chunks_per_node(void);
   int chunks_on_node(int node, std::vector<int> &chunk_indices);
+  int dummy_chunks_on_node(int node, std::vector<int> &chunk_indices);
+  int generate_dummy_chunk(std::string &filename, int chunk_index, char* &data, size_t &size);
   void reset(void);
-  void write_dummy_chunks(std::string &path, size_t chunksize, std::vector<int> &chunk_indices);
 
 };
 
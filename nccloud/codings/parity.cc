@@ -0,0 +1,265 @@
+/**
+  * @file codings/parity.cc
+  * @brief Implements the ParityCode class.
+  * **/
+
+/* ===================================================================
+Copyright (c) 2026, the NCCloud contributors
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+  - Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+  - Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in
+    the documentation and/or other materials provided with the
+    distribution.
+
+  - Neither the name of the copyright holder nor the
+    names of its contributors may be used to endorse or promote
+    products derived from this software without specific prior written
+    permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT
+HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+=================================================================== */
+
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <unistd.h>
+
+#include "../common.h"
+#include "parity.h"
+
+extern "C"
+{
+#include <jerasure.h>
+}
+
+using namespace std;
+
+
+/*  ----------------  */
+/* | Public methods | */
+/*  ----------------  */
+ParityCode::ParityCode(int k, int n, int w): n(n), k(k), w(w)
+{
+}
+
+
+ParityCode::~ParityCode()
+{
+  reset();
+}
+
+
+int ParityCode::init(map<string,string> &coding_param)
+{
+  if (Coding::init(coding_param) == -1) {
+    return -1;
+  }
+  if (n != k+1) {
+    print_error(stringstream() << "[Coding:ParityCode] n-k must be 1." << endl);
+    return -1;
+  }
+  return 0;
+}
+
+
+int ParityCode::encode_file(string &dstdir, string &srcdir, string &filename)
+{
+  // map input file as aggregated data chunks, with room for padding
+  string src = srcdir + '/' + filename;
+  size_t filesize = file_size(src);
+  size_t padded_filesize = padded_size(filesize, k*8);
+  size_t chunksize = padded_filesize / k;
+  char *data = map_input(src, filesize, padded_filesize);
+
+  // pad file and split into data chunks for encoding
+  pad_data(data, filesize, k*8);
+  char **data_ptrs = new char*[k];
+  for (int i=0; i<k; ++i) {
+    data_ptrs[i] = data + i*chunksize;
+  }
+
+  // write chunk size to metadata file
+  string dst = dstdir + '/' + filename;
+  write_metadata(dst, chunksize, filesize);
+
+  // parity chunk is the XOR of all data chunks, computed straight into its mapped file
+  char **code_ptrs = new char*[n-k];
+  for (int i=k; i<n; ++i) {
+    string chunk_path = dst + ".chunk" + to_string(i);
+    code_ptrs[i-k] = map_output(chunk_path, chunksize);
+  }
+  jerasure_do_parity(k, data_ptrs, code_ptrs[0], chunksize);
+  for (int i=k; i<n; ++i) {
+    unmap_file(code_ptrs[i-k], chunksize);
+  }
+  delete[] data_ptrs;
+  delete[] code_ptrs;
+
+  // write data chunks to files
+  vector<int> chunk_indices(k);
+  for (int i=0; i<k; ++i) {
+    chunk_indices[i] = i;
+  }
+  write_chunks(dst, chunksize, chunk_indices, data);
+  unmap_file(data, padded_filesize);
+
+  return 0;
+}
+
+
+int ParityCode::decode_file(string &dst, string &srcdir, string &filename,
+                            vector<int> &chunk_indices)
+{
+  if (chunk_indices.size() < (unsigned int)k) {
+    print_error(stringstream() << "Insufficient chunks retrieved." << endl);
+    return -1;
+  }
+
+  // load chunk size from metadata
+  string src = srcdir + '/' + filename;
+  size_t chunksize = 0;
+  read_metadata(src, chunksize);
+
+  // find the data chunk (if any) missing from the k chunks used for decoding
+  vector<int> sources(chunk_indices.begin(), chunk_indices.begin()+k);
+  int missing = -1;
+  for (int i=0; i<k && missing==-1; ++i) {
+    if (find(sources.begin(), sources.end(), i) == sources.end()) {
+      missing = i;
+    }
+  }
+
+  int fd = open(dst.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (fd == -1) {
+    show_file_error("open", dst.c_str(), NULL);
+  }
+  if (missing == -1) {
+    // the padded file is just the data chunks in order
+    string chunk_partial_path = src + ".chunk";
+    for (int i=0; i<k; ++i) {
+      string chunk_path = chunk_partial_path + to_string(i);
+      append_chunk(fd, dst, chunk_path, chunksize);
+    }
+  } else {
+    // the missing data chunk is the XOR of all the others and the parity
+    char *chunks = new char[(k+1) * chunksize];
+    read_chunks(src, chunksize, sources, chunks);
+    char **src_ptrs = new char*[k];
+    char **data_ptrs = new char*[k];
+    for (int i=0; i<k; ++i) {
+      src_ptrs[i] = chunks + i*chunksize;
+      if (sources[i] < k) {
+        data_ptrs[sources[i]] = src_ptrs[i];
+      }
+    }
+    data_ptrs[missing] = chunks + k*chunksize;
+    jerasure_do_parity(k, src_ptrs, data_ptrs[missing], chunksize);
+    for (int i=0; i<k; ++i) {
+      append_data(fd, dst, data_ptrs[i], chunksize);
+    }
+    delete[] chunks;
+    delete[] src_ptrs;
+    delete[] data_ptrs;
+  }
+
+  trim_padding(fd, dst, k * chunksize, k*8);
+  close(fd);
+
+  return 0;
+}
+
+
+int ParityCode::repair_file_preprocess(string &srcdir, string &filename,
+                                       vector<int> &erasures,
+                                       vector<int> &chunks_to_retrieve)
+{
+  if (erasures.size() > 1) {
+    print_error(stringstream() << "Too many erasures." << endl);
+    return -1;
+  }
+  retrieved_chunk_indices.erase(retrieved_chunk_indices.begin(),
+                                retrieved_chunk_indices.end());
+  failed_nodes.erase(failed_nodes.begin(), failed_nodes.end());
+  for (auto e : erasures) {
+    failed_nodes.push_back(e);  // stored internally for repair_file()
+  }
+  for (int i=0; i<n; ++i) {
+    if (find(erasures.begin(), erasures.end(), i) == erasures.end()) {
+      chunks_to_retrieve.push_back(i);       // list to return to caller
+      retrieved_chunk_indices.push_back(i);  // internal list
+    }
+  }
+  return 0;
+}
+
+
+int ParityCode::repair_file(string &dstdir, string &srcdir, string &filename)
+{
+  // load chunk size from metadata
+  string src = srcdir + '/' + filename;
+  size_t chunksize = 0;
+  read_metadata(src, chunksize);
+
+  // load downloaded chunks, leaving room for the repaired one
+  int num_sources = retrieved_chunk_indices.size();
+  char *chunks = new char[(num_sources+1) * chunksize];
+  read_chunks(src, chunksize, retrieved_chunk_indices, chunks);
+
+  // any chunk is the XOR of all the others
+  char **src_ptrs = new char*[num_sources];
+  for (int i=0; i<num_sources; ++i) {
+    src_ptrs[i] = chunks + i*chunksize;
+  }
+  char *repaired_chunk = chunks + num_sources*chunksize;
+  jerasure_do_parity(num_sources, src_ptrs, repaired_chunk, chunksize);
+  delete[] src_ptrs;
+
+  // write repaired chunk to disk
+  string dst = dstdir + '/' + filename;
+  write_chunks(dst, chunksize, failed_nodes, repaired_chunk);
+  delete[] chunks;
+  return 0;
+}
+
+
+int ParityCode::getn(void) { return n; }
+int ParityCode::getk(void) { return k; }
+int ParityCode::nodeid(int index) { return index; }
+int ParityCode::chunks_per_node(void) { return 1; }
+
+
+int ParityCode::chunks_on_node(int node, vector<int> &chunk_indices)
+{
+  chunk_indices.push_back(node);
+  return (node>=0 && node<n)? 0 : -1;
+}
+
+
+void ParityCode::reset(void)
+{
+  failed_nodes.erase(failed_nodes.begin(), failed_nodes.end());
+  retrieved_chunk_indices.erase(retrieved_chunk_indices.begin(),
+                                retrieved_chunk_indices.end());
+}
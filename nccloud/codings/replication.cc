@@ -78,15 +78,27 @@ int Replication::encode_file(string &dstdir, string &srcdir, string &filename)
   size_t filesize = ftell(infile);
   fclose(infile);
   string dst = dstdir + '/' + filename;
-  write_metadata(dst, filesize);
+  write_metadata(dst, filesize, filesize);
+
+  // no copies are staged: the source file is uploaded as every chunk
+  // (see chunks_are_copies())
+  return 0;
+}
 
-  // replicate file from src to n copies in dstdir
-  dst += ".chunk";
-  for (int i=0; i<n; ++i) {
-    string chunk_dst = dst + to_string(i);
-    copy(chunk_dst, src);
-  }
 
+int Replication::chunks_are_copies(void)
+{
+  return 1;
+}
+
+
+int Replication::decode_nodes(vector<int> &healthy_nodes, vector<int> &nodes_to_retrieve)
+{
+  // read from all healthy replicas in parallel (see striped_read_ranges())
+  if (healthy_nodes.empty()) {
+    return -1;
+  }
+  nodes_to_retrieve = healthy_nodes;
   return 0;
 }
 
@@ -119,9 +131,32 @@ int Replication::decode_file(string &dst, string &srcdir, string &filename,
     return -1;
   }
 
-  // copy downloaded file to destination
-  copy(dst, src);
+  // the downloaded copy is the file itself
+  if (rename(src.c_str(), dst.c_str()) == -1) {
+    copy(dst, src);
+  }
+
+  return 0;
+}
+
 
+int Replication::striped_read_ranges(string &srcdir, string &filename, int num_nodes,
+                                     vector<size_t> &offsets, vector<size_t> &lengths)
+{
+  // load file size from metadata
+  string src = srcdir + '/' + filename;
+  size_t filesize = 0;
+  read_metadata(src, filesize);
+
+  // split into page-aligned ranges, using fewer nodes for small files
+  size_t num_ranges = (filesize + min_range_size - 1) / min_range_size;
+  num_ranges = max((size_t)1, min(num_ranges, (size_t)num_nodes));
+  size_t range_size = ((filesize + num_ranges - 1) / num_ranges + 4095) & ~(size_t)4095;
+  for (int i=0; i<num_nodes; ++i) {
+    size_t offset = min(filesize, i*range_size);
+    offsets.push_back(offset);
+    lengths.push_back((size_t)i < num_ranges? min(range_size, filesize-offset) : 0);
+  }
   return 0;
 }
 
@@ -54,14 +54,21 @@ class Replication: public Coding
   int n, retrieved_chunk_index;
   std::vector<int> failed_nodes;
 
+  /** Smallest byte range worth reading from a separate replica. */
+  static const size_t min_range_size = 1 << 20;
+
   void copy(std::string &dst, std::string &src);
 
 public:
   Replication(int k, int n, int w);
   ~Replication();
   int encode_file(std::string &dstdir, std::string &srcdir, std::string &filename);
+  int chunks_are_copies(void);
+  int decode_nodes(std::vector<int> &healthy_nodes, std::vector<int> &nodes_to_retrieve);
   int decode_file(std::string &dst, std::string &srcdir, std::string &filename,
                   std::vector<int> &chunk_indices);
+  int striped_read_ranges(std::string &srcdir, std::string &filename, int num_nodes,
+                          std::vector<size_t> &offsets, std::vector<size_t> &lengths);
   int repair_file_preprocess(std::string &srcdir, std::string &filename,
                              std::vector<int> &erasures,
                              std::vector<int> &chunks_to_retrieve);
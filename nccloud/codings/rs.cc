@@ -43,13 +43,17 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <fcntl.h>
 #include <iostream>
+#include <unistd.h>
 
+#include "../arena.h"
 #include "../common.h"
 #include "rs.h"
 
 extern "C"
 {
+#include <galois.h>
 #include <jerasure.h>
 #include <reed_sol.h>
 }
@@ -73,25 +77,64 @@ RSCode::~RSCode()
 
 int RSCode::encode_file(string &dstdir, string &srcdir, string &filename)
 {
-  // read input file as aggregated data chunks
+  // map input file as aggregated data chunks, with room for padding
   string src = srcdir + '/' + filename;
-  FILE *infile = fopen(src.c_str(), "rb");
-  if (infile == NULL) {
-    show_file_error("fopen", src.c_str(), NULL);
-  }
-  fseek(infile, 0, SEEK_END);
-  size_t filesize = ftell(infile);
-  size_t padded_filesize = padded_size(filesize);
+  size_t filesize = file_size(src);
+  size_t padded_filesize = padded_size(filesize, k*8);
   size_t chunksize = padded_filesize / k;
-  char *chunks = new char[n * chunksize];
-  rewind(infile);
-  if (fread(chunks, 1, filesize, infile) != filesize) {
-    show_file_error("fread", src.c_str(), infile);
+  char *data = map_input(src, filesize, padded_filesize);
+
+  // pad file and split into data chunks for encoding
+  pad_data(data, filesize, k*8);
+  char **data_ptrs = new char*[k];
+  for (int i=0; i<k; ++i) {
+    data_ptrs[i] = data + i*chunksize;
+  }
+
+  // write chunk size to metadata file
+  string dst = dstdir + '/' + filename;
+  uint64_t key_nonce = new_key_nonce();
+  write_metadata(dst, chunksize, filesize, key_nonce);
+
+  // encode data chunks to code chunks, straight into their mapped files
+  char **code_ptrs = new char*[m];
+  for (int i=k; i<n; ++i) {
+    string chunk_path = dst + ".chunk" + to_string(i);
+    code_ptrs[i-k] = map_output(chunk_path, chunksize);
+  }
+  encode_tiles(data_ptrs, code_ptrs, chunksize, key_nonce);
+  for (int i=k; i<n; ++i) {
+    unmap_file(code_ptrs[i-k], chunksize);
+  }
+  delete[] data_ptrs;
+  delete[] code_ptrs;
+
+  // write data chunks to files
+  vector<int> chunk_indices(k);
+  for (int i=0; i<k; ++i) {
+    chunk_indices[i] = i;
   }
-  fclose(infile);
+  write_chunks(dst, chunksize, chunk_indices, data);
+  unmap_file(data, padded_filesize);
+
+  return 0;
+}
+
+
+int RSCode::encode_segment(string &dstdir, string &src, size_t offset, size_t size,
+                           string &filename, char* &chunks, size_t &chunksize)
+{
+  // read input range as aggregated data chunks, followed by room for code chunks
+  size_t filesize = size;
+  size_t padded_filesize = padded_size(filesize, k*8);
+  chunksize = padded_filesize / k;
+  chunks = BufferArena::instance()->acquire(n * chunksize);
+  char *data = map_input(src, filesize, filesize, offset);
+  memcpy(chunks, data, filesize);
+  unmap_file(data, filesize);
 
   // pad file and split into data chunks for encoding
-  pad_data(chunks, filesize);
+  pad_data(chunks, filesize, k*8);
   char **data_ptrs = new char*[k];
   for (int i=0; i<k; ++i) {
     data_ptrs[i] = chunks + i*chunksize;
@@ -102,27 +145,14 @@ int RSCode::encode_file(string &dstdir, string &srcdir, string &filename)
   for (int i=k; i<n; ++i) {
     code_ptrs[i-k] = chunks + i*chunksize;
   }
-  if (encode_matrix == NULL) {
-    encode_matrix = new int[k*m];
-    int *matrix = reed_sol_vandermonde_coding_matrix(k, m, w);
-    memcpy(encode_matrix, matrix, k*m*sizeof(int));
-    free(matrix);
-  }
-  jerasure_matrix_encode(k, m, w, encode_matrix, data_ptrs, code_ptrs, chunksize);
+  uint64_t key_nonce = new_key_nonce();
+  encode_tiles(data_ptrs, code_ptrs, chunksize, key_nonce);
   delete[] data_ptrs;
   delete[] code_ptrs;
 
   // write chunk size to metadata file
   string dst = dstdir + '/' + filename;
-  write_metadata(dst, chunksize);
-
-  // write chunks to files
-  vector<int> chunk_indices(n);
-  for (int i=0; i<n; ++i) {
-    chunk_indices[i] = i;
-  }
-  write_chunks(dst, chunksize, chunk_indices, chunks);
-  delete[] chunks;
+  write_metadata(dst, chunksize, filesize, key_nonce);
 
   return 0;
 }
@@ -140,59 +170,221 @@ int RSCode::decode_file(string &dst, string &srcdir, string &filename,
   string src = srcdir + '/' + filename;
   size_t chunksize = 0;
   read_metadata(src, chunksize);
-  if (encode_matrix == NULL) {
-    encode_matrix = new int[k*m];
-    int *matrix = reed_sol_vandermonde_coding_matrix(k, m, w);
-    memcpy(encode_matrix, matrix, k*m*sizeof(int));
-    free(matrix);
+
+  // systematic code: if all data chunks are here (and not encrypted), the
+  // padded file is just the data chunks in order
+  if (*max_element(chunk_indices.begin(), chunk_indices.begin()+k) == k-1 &&
+      read_key_nonce(src) == 0) {
+    int fd = open(dst.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd == -1) {
+      show_file_error("open", dst.c_str(), NULL);
+    }
+    string chunk_partial_path = src + ".chunk";
+    for (int i=0; i<k; ++i) {
+      string chunk_path = chunk_partial_path + to_string(i);
+      append_chunk(fd, dst, chunk_path, chunksize);
+    }
+    trim_padding(fd, dst, k * chunksize, k*8);
+    close(fd);
+    return 0;
+  }
+
+  // otherwise decode from the mapped chunks
+  vector<int> sources(chunk_indices.begin(), chunk_indices.begin()+k);
+  vector<char *> chunks(k);
+  for (int i=0; i<k; ++i) {
+    string chunk_path = src + ".chunk" + to_string(sources[i]);
+    chunks[i] = map_input(chunk_path, chunksize, chunksize);
+  }
+  int result = decode_buffer(dst, srcdir, filename, sources, chunks);
+  for (int i=0; i<k; ++i) {
+    unmap_file(chunks[i], chunksize);
+  }
+  return result;
+}
+
+
+int RSCode::decode_buffer(string &dst, string &srcdir, string &filename,
+                          vector<int> &chunk_indices, vector<char *> &chunks)
+{
+  if (chunk_indices.size() < (unsigned int)k) {
+    print_error(stringstream() << "Insufficient chunks retrieved." << endl);
+    return -1;
+  }
+
+  // load chunk size from metadata
+  string src = srcdir + '/' + filename;
+  size_t chunksize = 0;
+  read_metadata(src, chunksize);
+
+  // find data chunks missing from the k chunks used for decoding
+  vector<int> sources(chunk_indices.begin(), chunk_indices.begin()+k);
+  vector<int> missing;
+  for (int i=0; i<k; ++i) {
+    if (find(sources.begin(), sources.end(), i) == sources.end()) {
+      missing.push_back(i);
+    }
   }
 
-  // load downloaded chunks
-  char *chunks = new char[chunk_indices.size() * chunksize];
-  read_chunks(src, chunksize, chunk_indices, chunks);
+  // compute only the missing data chunks
+  char **src_ptrs = new char*[k];
+  char **data_ptrs = new char*[k];
+  for (int i=0; i<k; ++i) {
+    src_ptrs[i] = chunks[i];
+    if (sources[i] < k) {
+      data_ptrs[sources[i]] = src_ptrs[i];
+    }
+  }
+  int *rows = NULL;
+  char *decoded_chunks = NULL;
+  if (!missing.empty()) {
+    init_encode_matrix();
+    if ((rows = decoding_rows(k, w, encode_matrix, sources, missing)) == NULL) {
+      delete[] src_ptrs;
+      delete[] data_ptrs;
+      return -1;
+    }
+    decoded_chunks = BufferArena::instance()->acquire(missing.size() * chunksize);
+    for (unsigned int i=0; i<missing.size(); ++i) {
+      data_ptrs[missing[i]] = decoded_chunks + i*chunksize;
+    }
+  }
 
-  // categorize into data or code chunks
-  char *data_chunks = new char[k * chunksize];
-  char **data_ptrs  = new char*[k];
-  char *code_chunks = new char[m * chunksize];
-  char **code_ptrs  = new char*[m];
+  // an encrypted file is decrypted tile by tile right after decoding each
+  // tile, while it is still in the cache
+  uint64_t key_nonce = read_key_nonce(src);
+  size_t tile = key_nonce? crypt_tile_size(k + missing.size()) : chunksize;
+  char **src_tiles = new char*[k];
+  char **dst_tiles = new char*[missing.size() + 1];
+  for (size_t offset=0; offset<chunksize; offset+=tile) {
+    size_t size = min(tile, chunksize - offset);
+    for (int i=0; i<k; ++i) {
+      src_tiles[i] = src_ptrs[i] + offset;
+    }
+    for (unsigned int i=0; i<missing.size(); ++i) {
+      dst_tiles[i] = data_ptrs[missing[i]] + offset;
+      jerasure_matrix_dotprod(k, w, rows + i*k, NULL, k+i, src_tiles, dst_tiles, size);
+    }
+    for (int i=0; i<k; ++i) {
+      crypt_range(key_nonce, i, offset, data_ptrs[i] + offset, size);
+    }
+  }
+  delete[] src_tiles;
+  delete[] dst_tiles;
+  delete[] rows;
+
+  // write data chunks in order
+  int fd = open(dst.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (fd == -1) {
+    show_file_error("open", dst.c_str(), NULL);
+  }
   for (int i=0; i<k; ++i) {
-    data_ptrs[i] = data_chunks + i*chunksize;
+    append_data(fd, dst, data_ptrs[i], chunksize);
   }
-  for (int i=0; i<m; ++i) {
-    code_ptrs[i] = code_chunks + i*chunksize;
+  trim_padding(fd, dst, k * chunksize, k*8);
+  close(fd);
+
+  delete[] src_ptrs;
+  delete[] data_ptrs;
+  if (decoded_chunks != NULL) {
+    BufferArena::instance()->release(decoded_chunks);
   }
-  char *ptr = chunks;
-  for (auto index : chunk_indices) {
-    memcpy( (index < k? data_ptrs[index] : code_ptrs[index-k]), ptr, chunksize);
-    ptr += chunksize;
+  return 0;
+}
+
+
+int RSCode::range_reads(string &srcdir, string &filename, vector<int> &chunk_indices,
+                        size_t offset, size_t length, vector<ChunkRange> &ranges)
+{
+  if (chunk_indices.size() < (unsigned int)k) {
+    print_error(stringstream() << "Insufficient chunks retrieved." << endl);
+    return -1;
   }
-  delete[] chunks;
 
-  // treat undownloaded chunks as erasures for convenience
-  int *erasures = new int[n-chunk_indices.size()+1];
-  for (int i=0, j=0; i<n; ++i) {
-    if (find(chunk_indices.begin(), chunk_indices.end(), i) == chunk_indices.end()) {
-      erasures[j++] = i;
+  // a data chunk range is read as is, or decoded from the same range of the
+  // k chunks used for decoding if the data chunk is not among them
+  string src = srcdir + '/' + filename;
+  if (read_filesize(src) == Metadata::unknown_filesize) {
+    return -1;  // legacy metadata gives no file size to clip the range to
+  }
+  vector<ChunkRange> pieces;
+  data_pieces(src, offset, length, pieces);
+  vector<int> sources(chunk_indices.begin(), chunk_indices.begin()+k);
+  for (auto &piece : pieces) {
+    if (find(sources.begin(), sources.end(), piece.chunk_index) != sources.end()) {
+      add_range(ranges, piece.chunk_index, piece.offset, piece.length);
+      continue;
+    }
+    for (auto source : sources) {
+      add_range(ranges, source, piece.offset, piece.length);
     }
   }
-  erasures[n-chunk_indices.size()] = -1;
+  return 0;
+}
+
 
-  // decode chunks into original data
-  if (jerasure_matrix_decode(k, m, w, encode_matrix, 1,
-                             erasures, data_ptrs, code_ptrs, chunksize) != 0) {
+int RSCode::decode_range(string &dst, string &srcdir, string &filename,
+                         vector<int> &chunk_indices, size_t offset, size_t length)
+{
+  if (chunk_indices.size() < (unsigned int)k) {
+    print_error(stringstream() << "Insufficient chunks retrieved." << endl);
     return -1;
   }
-  size_t decoded_filesize = unpad_data(data_chunks, k*chunksize);
-  delete[] erasures;
-  delete[] data_ptrs;
-  delete[] code_chunks;
-  delete[] code_ptrs;
 
-  // write decoded file to dst
-  write_file(dst, data_chunks, decoded_filesize);
-  delete[] data_chunks;
+  // find data chunks of the range missing from the k chunks used for decoding
+  string src = srcdir + '/' + filename;
+  vector<ChunkRange> pieces;
+  size_t chunksize = data_pieces(src, offset, length, pieces);
+  vector<int> sources(chunk_indices.begin(), chunk_indices.begin()+k);
+  vector<int> missing;
+  for (auto &piece : pieces) {
+    if (find(sources.begin(), sources.end(), piece.chunk_index) == sources.end()) {
+      missing.push_back(piece.chunk_index);
+    }
+  }
+  int *rows = NULL;
+  if (!missing.empty()) {
+    init_encode_matrix();
+    if ((rows = decoding_rows(k, w, encode_matrix, sources, missing)) == NULL) {
+      return -1;
+    }
+  }
 
+  // read or decode (and decrypt) each piece, then write the bytes of it
+  // inside the range
+  uint64_t key_nonce = read_key_nonce(src);
+  int fd = open(dst.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd == -1) {
+    show_file_error("open", dst.c_str(), NULL);
+  }
+  char **src_ptrs = new char*[k];
+  for (unsigned int i=0, j=0; i<pieces.size(); ++i) {
+    ChunkRange &piece = pieces[i];
+    char *data = BufferArena::instance()->acquire(piece.length);
+    if (j < missing.size() && missing[j] == piece.chunk_index) {
+      for (int l=0; l<k; ++l) {
+        src_ptrs[l] = BufferArena::instance()->acquire(piece.length);
+        read_chunk_range(src, sources[l], piece.offset, piece.length, src_ptrs[l]);
+      }
+      jerasure_matrix_dotprod(k, w, rows + j*k, NULL, k, src_ptrs, &data, piece.length);
+      for (int l=0; l<k; ++l) {
+        BufferArena::instance()->release(src_ptrs[l]);
+      }
+      ++j;
+    } else {
+      read_chunk_range(src, piece.chunk_index, piece.offset, piece.length, data);
+    }
+    crypt_range(key_nonce, piece.chunk_index, piece.offset, data, piece.length);
+    size_t piece_offset = piece.chunk_index*chunksize + piece.offset;
+    size_t skip = piece_offset < offset? offset - piece_offset : 0;
+    size_t piece_end = min(piece_offset + piece.length, offset + length);
+    append_data(fd, dst, data + skip, piece_end - piece_offset - skip);
+    BufferArena::instance()->release(data);
+  }
+  close(fd);
+
+  delete[] src_ptrs;
+  delete[] rows;
   return 0;
 }
 
@@ -229,92 +421,44 @@ int RSCode::repair_file(string &dstdir, string &srcdir, string &filename)
   size_t chunksize = 0;
   read_metadata(src, chunksize);
 
-  // load downloaded chunks
-  char *chunks = new char[retrieved_chunk_indices.size() * chunksize];
-  read_chunks(src, chunksize, retrieved_chunk_indices, chunks);
-
-  // create encoding matrix
-  if (encode_matrix == NULL) {
-    encode_matrix = new int[k*m];
-    int *matrix = reed_sol_vandermonde_coding_matrix(k, m, w);
-    memcpy(encode_matrix, matrix, k*m*sizeof(int));
-    free(matrix);
+  // one row per failed chunk, expressing it in terms of the retrieved chunks
+  init_encode_matrix();
+  int *rows = decoding_rows(k, w, encode_matrix, retrieved_chunk_indices, failed_nodes);
+  if (rows == NULL) {
+    return -1;
   }
 
-  // categorize into data or code chunks
-  char *data_chunks = new char[k * chunksize];
-  char **data_ptrs  = new char*[k];
-  char *code_chunks = new char[m * chunksize];
-  char **code_ptrs  = new char*[m];
+  // compute only the failed chunks, from the mapped downloaded chunks
+  // straight into their mapped files
+  char **src_ptrs = new char*[k];
   for (int i=0; i<k; ++i) {
-    data_ptrs[i] = data_chunks + i*chunksize;
-  }
-  for (int i=0; i<m; ++i) {
-    code_ptrs[i] = code_chunks + i*chunksize;
-  }
-  char *ptr = chunks;
-  for (auto index : retrieved_chunk_indices) {
-    memcpy( (index < k? data_ptrs[index] : code_ptrs[index-k]), ptr, chunksize);
-    ptr += chunksize;
-  }
-  delete[] chunks;
-
-  // determine whether encoding / decoding is needed
-  int need_encode=0, need_decode=0;
-  for (auto index : failed_nodes) {
-    if (index < k) {
-      need_decode = 1;
-    } else {
-      need_encode = 1;
-    }
+    string chunk_path = src + ".chunk" + to_string(retrieved_chunk_indices[i]);
+    src_ptrs[i] = map_input(chunk_path, chunksize, chunksize);
   }
-
-  // decode to get data chunks
-  if (need_decode) {
-    // treat undownloaded chunks as erasures for convenience
-    int *erasures = new int[n-retrieved_chunk_indices.size()+1];
-    for (int i=0, j=0; i<n; ++i) {
-      if (find(retrieved_chunk_indices.begin(), retrieved_chunk_indices.end(), i)
-          == retrieved_chunk_indices.end()) {
-        erasures[j++] = i;
-      }
-    }
-    erasures[n-retrieved_chunk_indices.size()] = -1;
-
-    // decode chunks into original data chunks
-    if (jerasure_matrix_decode(k, m, w, encode_matrix, 1,
-                               erasures, data_ptrs, code_ptrs, chunksize) != 0) {
-      return -1;
-    }
-    delete[] erasures;
+  string dst = dstdir + '/' + filename;
+  char **dst_ptrs = new char*[failed_nodes.size()];
+  for (unsigned int i=0; i<failed_nodes.size(); ++i) {
+    string chunk_path = dst + ".chunk" + to_string(failed_nodes[i]);
+    dst_ptrs[i] = map_output(chunk_path, chunksize);
+    jerasure_matrix_dotprod(k, w, rows + i*k, NULL, k+i, src_ptrs, dst_ptrs, chunksize);
   }
-
-  // encode to get code chunks
-  if (need_encode) {
-    jerasure_matrix_encode(k, m, w, encode_matrix, data_ptrs, code_ptrs, chunksize);
+  for (int i=0; i<k; ++i) {
+    unmap_file(src_ptrs[i], chunksize);
   }
-
-  // write repaired chunks to disk
-  chunks = new char[failed_nodes.size() * chunksize];
-  int ctr = 0;
-  for (auto index : failed_nodes) {
-    memcpy(chunks + (ctr++)*chunksize,
-           (index < k? data_ptrs[index] : code_ptrs[index-k]), chunksize);
+  for (unsigned int i=0; i<failed_nodes.size(); ++i) {
+    unmap_file(dst_ptrs[i], chunksize);
   }
-  string dst = dstdir + '/' + filename;
-  write_chunks(dst, chunksize, failed_nodes, chunks);
-
-  delete[] chunks;
-  delete[] data_chunks;
-  delete[] data_ptrs;
-  delete[] code_chunks;
-  delete[] code_ptrs;
+  delete[] rows;
+  delete[] src_ptrs;
+  delete[] dst_ptrs;
   return 0;
 }
 
 
 int RSCode::getn(void) { return n; }
 int RSCode::getk(void) { return k; }
+int RSCode::buffered_io(void) { return 1; }
+int RSCode::encryption(void) { return 1; }
 int RSCode::nodeid(int index) { return index; }
 int RSCode::chunks_per_node(void) { return 1; }
 
@@ -338,28 +482,61 @@ void RSCode::reset(void)
 /*  -----------------  */
 /* | Private methods | */
 /*  -----------------  */
-size_t RSCode::padded_size(size_t size)
+void RSCode::init_encode_matrix(void)
 {
-  return (size/(k*8) + 1) * k*8;
+  lock_guard<mutex> lock(matrix_mutex);
+  if (encode_matrix == NULL) {
+    encode_matrix = new int[k*m];
+    int *matrix = reed_sol_vandermonde_coding_matrix(k, m, w);
+    memcpy(encode_matrix, matrix, k*m*sizeof(int));
+    free(matrix);
+  }
 }
 
 
-void RSCode::pad_data(char *data, size_t data_size)
+void RSCode::encode_tiles(char **data_ptrs, char **code_ptrs, size_t chunksize,
+                          uint64_t key_nonce)
 {
-  // pad to a multiple of k*8
-  data[data_size] = 1;
-  memset(data+data_size+1, 0, padded_size(data_size)-data_size-1);
+  init_encode_matrix();
+  if (key_nonce == 0) {
+    jerasure_matrix_encode(k, m, w, encode_matrix, data_ptrs, code_ptrs, chunksize);
+    return;
+  }
+
+  // encrypt each tile of the data chunks right before encoding it, while it
+  // is still in the cache
+  size_t tile = crypt_tile_size(n);
+  char **data_tiles = new char*[k];
+  char **code_tiles = new char*[m];
+  for (size_t offset=0; offset<chunksize; offset+=tile) {
+    size_t size = min(tile, chunksize - offset);
+    for (int i=0; i<k; ++i) {
+      data_tiles[i] = data_ptrs[i] + offset;
+      crypt_range(key_nonce, i, offset, data_tiles[i], size);
+    }
+    for (int i=0; i<m; ++i) {
+      code_tiles[i] = code_ptrs[i] + offset;
+    }
+    jerasure_matrix_encode(k, m, w, encode_matrix, data_tiles, code_tiles, size);
+  }
+  delete[] data_tiles;
+  delete[] code_tiles;
 }
 
 
-size_t RSCode::unpad_data(char *data, size_t data_size)
+size_t RSCode::data_pieces(string &src, size_t offset, size_t &length,
+                           vector<ChunkRange> &pieces)
 {
-  // unpad starting from the end of padded data
-  char *ptr = &data[data_size-1];
-  if (*ptr) { return *ptr==1? data_size-1 : 0; }
-  for (size_t i=data_size; i; i--, ptr--) {
-    if (*ptr) { return i-1; }
+  // clip the range to the file, and widen it to multiples of 8 bytes (the
+  // region size jerasure works on) within the padded file
+  Metadata meta;
+  load_metadata(src, meta);
+  size_t filesize = meta.header.filesize;
+  length = offset < filesize? min(length, filesize - offset) : 0;
+  if (length > 0) {
+    split_range(meta.header.chunksize, offset & ~(size_t)7,
+                (offset + length + 7) & ~(size_t)7, pieces);
   }
-  return 0;
+  return meta.header.chunksize;
 }
 
@@ -42,6 +42,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef NCCLOUD_CODINGS_RS_H
 #define NCCLOUD_CODINGS_RS_H
 
+#include <mutex>
 #include <vector>
 #include <string>
 
@@ -53,12 +54,14 @@ class RSCode: public Coding
 {
   int n, k, m, w;
   int *encode_matrix;
+  std::mutex matrix_mutex;  // guards creating the encoding matrix
   std::vector<int> failed_nodes;
   std::vector<int> retrieved_chunk_indices;
 
-  size_t padded_size(size_t size);
-  void pad_data(char *data, size_t data_size);
-  size_t unpad_data(char *data, size_t data_size);
+  void init_encode_matrix(void);
+  void encode_tiles(char **data_ptrs, char **code_ptrs, size_t chunksize, uint64_t key_nonce);
+  size_t data_pieces(std::string &src, size_t offset, size_t &length,
+                     std::vector<ChunkRange> &pieces);
 
 public:
   RSCode(int k, int n, int w);
@@ -66,6 +69,17 @@ public:
   int encode_file(std::string &dstdir, std::string &srcdir, std::string &filename);
   int decode_file(std::string &dst, std::string &srcdir, std::string &filename,
                   std::vector<int> &chunk_indices);
+  int buffered_io(void);
+  int encryption(void);
+  int encode_segment(std::string &dstdir, std::string &src, size_t offset, size_t size,
+                     std::string &filename, char* &chunks, size_t &chunksize);
+  int decode_buffer(std::string &dst, std::string &srcdir, std::string &filename,
+                    std::vector<int> &chunk_indices, std::vector<char *> &chunks);
+  int range_reads(std::string &srcdir, std::string &filename,
+                  std::vector<int> &chunk_indices, size_t offset, size_t length,
+                  std::vector<ChunkRange> &ranges);
+  int decode_range(std::string &dst, std::string &srcdir, std::string &filename,
+                   std::vector<int> &chunk_indices, size_t offset, size_t length);
   int repair_file_preprocess(std::string &srcdir, std::string &filename,
                              std::vector<int> &erasures,
                              std::vector<int> &chunks_to_retrieve);
@@ -0,0 +1,96 @@
+/**
+  * @file compression.h
+  * @brief Declares the Compression class.
+  * **/
+
+/* ===================================================================
+Copyright (c) 2026, the NCCloud contributors
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+  - Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+  - Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in
+    the documentation and/or other materials provided with the
+    distribution.
+
+  - Neither the name of the copyright holder nor the
+    names of its contributors may be used to endorse or promote
+    products derived from this software without specific prior written
+    permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT
+HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+=================================================================== */
+
+
+#ifndef NCCLOUD_COMPRESSION_H
+#define NCCLOUD_COMPRESSION_H
+
+#include <cstddef>
+#include <map>
+#include <string>
+
+
+/** Abstract base class for compression modules.  Files are compressed segment
+ *  by segment before being encoded, and the type of each compressed segment is
+ *  recorded in the stripe flags of the file's metadata
+ *  (see MetadataStripe::compression_mask). */
+class Compression
+{
+public:
+  virtual ~Compression() {}
+
+
+  /** Return an instance of a compression scheme, based on user's choice.
+   *  @param[in] type choice of compression scheme (1 = zlib)
+   *  @return an instance of an appropriate subclass of Compression,
+   *          or NULL if the type is unknown */
+  static Compression *use_compression(int type);
+
+
+  /** Initialize the Compression instance based on optional fields in coding_param.
+   *  @param[in] coding_param dictionary of parameters under [Coding]
+   *  @return 0 on success, -1 on failure (e.g., invalid parameters) */
+  virtual int init(std::map<std::string, std::string> &coding_param) = 0;
+
+
+  /** Return the type of the compression scheme, as given to use_compression(). */
+  virtual int type(void) = 0;
+
+
+  /** Compress a buffer, giving up as soon as the output outgrows capacity.
+   *  May be called from several threads at once.
+   *  @param[in]      src data to compress
+   *  @param[in]     size size of the data
+   *  @param[out]     dst buffer of capacity bytes for the compressed data
+   *  @param[in] capacity most bytes the compressed data may take
+   *  @return size of the compressed data, or 0 if it does not fit in capacity */
+  virtual size_t compress(const char *src, size_t size, char *dst, size_t capacity) = 0;
+
+
+  /** Decompress a buffer compressed by compress().
+   *  May be called from several threads at once.
+   *  @param[in]   src compressed data
+   *  @param[in]  size size of the compressed data
+   *  @param[out]  dst buffer for the decompressed data
+   *  @param[in] dsize size of the decompressed data
+   *  @return 0 on success, -1 if the data is corrupt or not of size dsize */
+  virtual int decompress(const char *src, size_t size, char *dst, size_t dsize) = 0;
+};
+
+#endif  /* NCCLOUD_COMPRESSION_H */
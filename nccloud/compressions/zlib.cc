@@ -0,0 +1,124 @@
+/**
+  * @file compressions/zlib.cc
+  * @brief Implements the ZlibCompression class.
+  * **/
+
+/* ===================================================================
+Copyright (c) 2026, the NCCloud contributors
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+  - Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+  - Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in
+    the documentation and/or other materials provided with the
+    distribution.
+
+  - Neither the name of the copyright holder nor the
+    names of its contributors may be used to endorse or promote
+    products derived from this software without specific prior written
+    permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT
+HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+=================================================================== */
+
+
+#include <climits>
+#include <cstdlib>
+#include <iostream>
+
+#include <zlib.h>
+
+#include "../common.h"
+#include "zlib.h"
+
+using namespace std;
+
+
+ZlibCompression::ZlibCompression(): level(Z_BEST_SPEED)
+{
+}
+
+
+int ZlibCompression::init(map<string, string> &coding_param)
+{
+  if (coding_param.count("compression_level") == 1) {
+    level = atoi(coding_param["compression_level"].c_str());
+    if (level < Z_BEST_SPEED || level > Z_BEST_COMPRESSION) {
+      print_error(stringstream() << "[Compression:zlib] compression_level must be between "
+                                 << Z_BEST_SPEED << " and " << Z_BEST_COMPRESSION << "." << endl);
+      return -1;
+    }
+  }
+  return 0;
+}
+
+
+int ZlibCompression::type(void)
+{
+  return 1;
+}
+
+
+size_t ZlibCompression::compress(const char *src, size_t size, char *dst, size_t capacity)
+{
+  z_stream stream = z_stream();
+  if (deflateInit2(&stream, level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+    return 0;
+  }
+
+  // zlib counts bytes in 32 bits, so larger buffers are fed in pieces
+  size_t in = 0, out = 0;
+  int ret = Z_OK;
+  while (ret == Z_OK && out < capacity) {
+    stream.next_in = (Bytef *)(src + in);
+    stream.avail_in = min(size - in, (size_t)UINT_MAX);
+    stream.next_out = (Bytef *)(dst + out);
+    stream.avail_out = min(capacity - out, (size_t)UINT_MAX);
+    size_t avail_in = stream.avail_in, avail_out = stream.avail_out;
+    ret = deflate(&stream, size - in == avail_in? Z_FINISH : Z_NO_FLUSH);
+    in += avail_in - stream.avail_in;
+    out += avail_out - stream.avail_out;
+  }
+  deflateEnd(&stream);
+  return ret == Z_STREAM_END? out : 0;
+}
+
+
+int ZlibCompression::decompress(const char *src, size_t size, char *dst, size_t dsize)
+{
+  z_stream stream = z_stream();
+  if (inflateInit2(&stream, -MAX_WBITS) != Z_OK) {
+    return -1;
+  }
+
+  size_t in = 0, out = 0;
+  int ret = Z_OK;
+  while (ret == Z_OK) {
+    stream.next_in = (Bytef *)(src + in);
+    stream.avail_in = min(size - in, (size_t)UINT_MAX);
+    stream.next_out = (Bytef *)(dst + out);
+    stream.avail_out = min(dsize - out, (size_t)UINT_MAX);
+    size_t avail_in = stream.avail_in, avail_out = stream.avail_out;
+    ret = inflate(&stream, Z_NO_FLUSH);
+    in += avail_in - stream.avail_in;
+    out += avail_out - stream.avail_out;
+  }
+  inflateEnd(&stream);
+  return ret == Z_STREAM_END && in == size && out == dsize? 0 : -1;
+}
@@ -39,6 +39,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 =================================================================== */
 
 
+#include <algorithm>
 #include <atomic>
 #include <condition_variable>
 #include <cstring>
@@ -47,6 +48,12 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <mutex>
 #include <queue>
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "arena.h"
 #include "fileop.h"
 
 using namespace std;
@@ -63,6 +70,19 @@ static condition_variable storage_queue_ready;
 static condition_variable coding_queue_ready;
 static mutex master_mutex;
 
+/** Segments encoded but not yet uploaded, which bounds the memory held by encoders. */
+static unsigned int segments_in_flight = 0;
+static unsigned int max_segments_in_flight = 1;
+static condition_variable segment_slot_ready;
+static mutex segment_mutex;
+
+/** Bytes at the start of a segment compressed first, to give up early on
+ *  segments that do not compress well. */
+static const size_t compression_sample_size = 64 << 10;
+
+/** 32 bytes in a GCC vector, OR-ed together when scanning for zeros. */
+typedef uint64_t zero_scan_word __attribute__((vector_size(32)));
+
 
 /** Add a pointer to an object describing a job to the job queue q. */
 static void add_job(Job *job, queue<Job *> &q, mutex &m, condition_variable &cv)
@@ -95,11 +115,179 @@ static int wait_job(Job* &job, queue<Job *> &q, mutex &m, condition_variable &cv
     job = q.front();
     q.pop();
   }
-  m.unlock();
+  lock.unlock();
   return !end;
 }
 
 
+/** Wait until fewer than max_segments_in_flight segments are in flight, then take a slot. */
+static void acquire_segment_slot(void)
+{
+  unique_lock<mutex> lock(segment_mutex);
+  while (segments_in_flight >= max_segments_in_flight) {
+    segment_slot_ready.wait(lock);
+  }
+  segments_in_flight++;
+}
+
+
+/** Give back a slot taken by acquire_segment_slot(). */
+static void release_segment_slot(void)
+{
+  segment_mutex.lock();
+  segments_in_flight--;
+  segment_mutex.unlock();
+  segment_slot_ready.notify_all();
+}
+
+
+/** Copy size bytes of a file, from src_offset on, into an open file at a given
+ *  offset, in-kernel where possible. */
+static void copy_into(string &src, int fd, string &dst, size_t offset, size_t size,
+                      size_t src_offset=0)
+{
+  int infd = open(src.c_str(), O_RDONLY);
+  if (infd == -1) {
+    show_file_error("open", src.c_str(), NULL);
+  }
+  loff_t off_in = src_offset, off_out = offset;
+  size_t copied = 0;
+  while (copied < size) {
+    ssize_t ret = copy_file_range(infd, &off_in, fd, &off_out, size-copied, 0);
+    if (ret == -1 && copied == 0 &&
+        (errno == ENOSYS || errno == EXDEV || errno == EINVAL || errno == EOPNOTSUPP)) {
+      break;  // fall back to pread() and pwrite() below
+    }
+    if (ret <= 0) {
+      show_file_error("copy_file_range", src.c_str(), NULL);
+    }
+    copied += ret;
+  }
+  char buf[65536];
+  while (copied < size) {
+    ssize_t ret = pread(infd, buf, min(size - copied, sizeof(buf)), off_in);
+    if (ret <= 0) {
+      show_file_error("pread", src.c_str(), NULL);
+    }
+    for (ssize_t written = 0; written < ret; ) {
+      ssize_t w = pwrite(fd, buf + written, ret - written, off_out + written);
+      if (w <= 0) {
+        show_file_error("pwrite", dst.c_str(), NULL);
+      }
+      written += w;
+    }
+    off_in += ret;
+    off_out += ret;
+    copied += ret;
+  }
+  close(infd);
+}
+
+
+/** Decompress a segment that was compressed before encoding, and copy size
+ *  bytes of it, from src_offset on, into an open file at a given offset.
+ *  @param[in]    src pathname of the decoded (compressed) segment
+ *  @param[in]   type type of compression of the segment
+ *  @param[in] dsize size of the segment once decompressed */
+static void decompress_into(string &src, int type, size_t dsize, int fd, string &dst,
+                            size_t offset, size_t size, size_t src_offset=0)
+{
+  Compression *compression = Compression::use_compression(type);
+  if (compression == NULL) {
+    print_error(stringstream() << "Unknown compression type " << type
+                               << " of " << src << endl);
+    exit(-1);
+  }
+  int infd = open(src.c_str(), O_RDONLY);
+  struct stat st;
+  if (infd == -1 || fstat(infd, &st) == -1) {
+    show_file_error("open", src.c_str(), NULL);
+  }
+  char *packed = BufferArena::instance()->acquire(st.st_size);
+  if (pread(infd, packed, st.st_size, 0) != st.st_size) {
+    show_file_error("pread", src.c_str(), NULL);
+  }
+  close(infd);
+
+  char *data = BufferArena::instance()->acquire(dsize);
+  if (compression->decompress(packed, st.st_size, data, dsize) == -1) {
+    print_error(stringstream() << "Failed to decompress: " << src << endl);
+    exit(-1);
+  }
+  if (pwrite(fd, data + src_offset, size, offset) != (ssize_t)size) {
+    show_file_error("pwrite", dst.c_str(), NULL);
+  }
+  BufferArena::instance()->release(data);
+  BufferArena::instance()->release(packed);
+  delete compression;
+}
+
+
+/** Tell whether a buffer is all zeros, scanning it a page at a time so that
+ *  data that is not stops the scan early. */
+static int is_zero(const char *data, size_t size)
+{
+  const size_t block = 4096;
+  size_t done = 0;
+  for ( ; done + block <= size; done += block) {
+    zero_scan_word acc = {0, 0, 0, 0};
+    for (size_t i=0; i<block; i+=sizeof(zero_scan_word)) {
+      zero_scan_word word;
+      memcpy(&word, data + done + i, sizeof(word));
+      acc |= word;
+    }
+    if ((acc[0] | acc[1] | acc[2] | acc[3]) != 0) {
+      return 0;
+    }
+  }
+  for ( ; done < size; ++done) {
+    if (data[done] != 0) {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+
+/** Tell whether a segment of a file is all zeros, without reading it if it
+ *  lies in a hole of a sparse file. */
+static int segment_is_zero(string &src, MetadataStripe &segment)
+{
+  int fd = open(src.c_str(), O_RDONLY);
+  if (fd == -1) {
+    show_file_error("open", src.c_str(), NULL);
+  }
+  off_t data_offset = lseek(fd, segment.offset, SEEK_DATA);
+  if ((data_offset == -1 && errno == ENXIO) ||
+      (data_offset != -1 && (size_t)data_offset >= segment.offset + segment.size)) {
+    close(fd);
+    return 1;
+  }
+  void *data = mmap(NULL, segment.size, PROT_READ, MAP_PRIVATE, fd, segment.offset);
+  if (data == MAP_FAILED) {
+    show_file_error("mmap", src.c_str(), NULL);
+  }
+  madvise(data, segment.size, MADV_SEQUENTIAL);
+  int ret = is_zero((char *)data, segment.size);
+  munmap(data, segment.size);
+  close(fd);
+  return ret;
+}
+
+
+/** Add all chunks of all nodes (and their dummy chunks) to an upload job. */
+static void add_all_chunks(Job *job, Coding *coding)
+{
+  for (int i=0, j=0; i<coding->getn(); ++i) {
+    job->node_indices.push_back(i);
+    for (int jj=0; jj<coding->chunks_per_node(); ++jj, ++j) {
+      job->chunk_indices.push_back(j);
+    }
+    coding->dummy_chunks_on_node(i, job->dummy_chunk_indices);
+  }
+}
+
+
 /** Run thread indefinitely, wait for jobs to process
  *  and quit when there will be no more jobs */
 static void run_thread(queue<Job *> &q, mutex &m, condition_variable &cv)
@@ -127,7 +315,9 @@ static void run_thread(queue<Job *> &q, mutex &m, condition_variable &cv)
 Job::Job(int action, Coding *coding, vector<Storage *> *storages,
          string &tmpdir, string &filename):
              action(action), coding(coding), storages(storages),
-             tmpdir(tmpdir), filename(filename), next_job(NULL)
+             tmpdir(tmpdir), filename(filename), chunk_buffer(NULL),
+             chunksize(0), in_memory(0), segment_slot(0),
+             range_offset(0), range_length(0), next_job(NULL)
 {
 }
 
@@ -162,6 +352,12 @@ void Job::run_job(void)
     case DECODE:
       decode_file();
       break;
+    case DECODESEGS:
+      decode_segments();
+      break;
+    case DECODERANGE:
+      decode_range();
+      break;
     case REPAIR:
       repair_file();
       break;
@@ -185,8 +381,28 @@ void Job::upload_metadata_and_chunks(void)
         cur_chunk_indices.push_back(chunk_index);
       }
     }
-    if ((*storages)[nodeid]->
-        store_metadata_and_chunks(tmpdir, filename, cur_chunk_indices) == -1) {
+    int ret = 0;
+    if (!src_path.empty()) {
+      // chunks are copies of the source file, which is uploaded directly
+      ret = (*storages)[nodeid]->store_metadata(tmpdir, filename);
+      for (auto chunk_index : cur_chunk_indices) {
+        if (ret == 0) {
+          ret = (*storages)[nodeid]->store_chunk_from(src_path, filename, chunk_index);
+        }
+      }
+    } else if (chunk_buffer != NULL) {
+      // chunks are streamed straight from memory
+      ret = (*storages)[nodeid]->store_metadata(tmpdir, filename);
+      for (auto chunk_index : cur_chunk_indices) {
+        if (ret == 0) {
+          ret = (*storages)[nodeid]->put_buffer(filename, chunk_index,
+                                                chunk_buffer + chunk_index*chunksize, chunksize);
+        }
+      }
+    } else {
+      ret = (*storages)[nodeid]->store_metadata_and_chunks(tmpdir, filename, cur_chunk_indices);
+    }
+    if (ret == -1) {
       stringstream s;
       s << "Failed to upload " << tmpdir << "/" << filename;
       for (auto cur_chunk_index : cur_chunk_indices) {
@@ -196,6 +412,28 @@ void Job::upload_metadata_and_chunks(void)
       print_error(s);
       exit(-1);
     }
+
+    // dummy chunks are generated in memory and streamed to the same node
+    for (auto chunk_index : dummy_chunk_indices) {
+      if (coding->nodeid(chunk_index) != nodeid) {
+        continue;
+      }
+      char *data = NULL;
+      size_t size = 0;
+      if (coding->generate_dummy_chunk(filename, chunk_index, data, size) == -1 ||
+          (*storages)[nodeid]->put_buffer(filename, chunk_index, data, size) == -1) {
+        print_error(stringstream() << "Failed to upload dummy chunk " << filename
+                                   << " [" << chunk_index << "] to node " << nodeid << endl);
+        exit(-1);
+      }
+      BufferArena::instance()->release(data);
+    }
+  }
+  if (chunk_buffer != NULL) {
+    BufferArena::instance()->release(chunk_buffer);
+  }
+  if (segment_slot) {
+    release_segment_slot();
   }
 }
 
@@ -215,6 +453,20 @@ void Job::upload_metadata(void)
 
 void Job::download_chunks(void)
 {
+  // if every node holds a copy of the same chunk, read a byte range from each
+  vector<size_t> offsets, lengths;
+  if (coding->striped_read_ranges(tmpdir, filename, node_indices.size(),
+                                  offsets, lengths) == 0) {
+    download_striped_chunk(offsets, lengths);
+    return;
+  }
+
+  // hand chunks to the decode job in memory if the coding can take them
+  if (in_memory) {
+    download_chunk_buffers();
+    return;
+  }
+
   // download chunks on a per-node basis
   for (auto nodeid : node_indices) {
     vector<int> cur_chunk_indices;
@@ -237,6 +489,144 @@ void Job::download_chunks(void)
 }
 
 
+void Job::download_striped_chunk(vector<size_t> &offsets, vector<size_t> &lengths)
+{
+  // assemble all ranges in place as the chunk of the first node
+  string dst = tmpdir + '/' + filename + ".chunk" + to_string(chunk_indices[0]);
+  size_t chunksize = 0;
+  for (unsigned int i=0; i<lengths.size(); ++i) {
+    chunksize = max(chunksize, offsets[i] + lengths[i]);
+  }
+  int fd = open(dst.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd == -1 || ftruncate(fd, chunksize) == -1) {
+    show_file_error("open", dst.c_str(), NULL);
+  }
+  close(fd);
+
+  // one thread per range; a failed range is retried on the other nodes
+  vector<thread> readers;
+  for (unsigned int i=0; i<lengths.size(); ++i) {
+    if (lengths[i] == 0) {
+      continue;
+    }
+    readers.push_back(thread([this, i, &dst, &offsets, &lengths]() {
+      for (unsigned int j=0; j<node_indices.size(); ++j) {
+        int nodeid = node_indices[(i+j) % node_indices.size()];
+        vector<int> node_chunk_indices;
+        coding->chunks_on_node(nodeid, node_chunk_indices);
+        if ((*storages)[nodeid]->get_chunk_range(dst, filename, node_chunk_indices[0],
+                                                 offsets[i], lengths[i]) == 0) {
+          return;
+        }
+      }
+      print_error(stringstream() << "Failed to download " << filename << " bytes "
+                                 << offsets[i] << "-" << offsets[i]+lengths[i]-1
+                                 << " from any node" << endl);
+      exit(-1);
+    }));
+  }
+  for (auto &t : readers) {
+    t.join();
+  }
+}
+
+
+void Job::download_chunk_ranges(string &name, vector<ChunkRange> &ranges)
+{
+  // start from empty chunk files, each range landing at its own offset
+  for (auto &range : ranges) {
+    string dst = tmpdir + '/' + name + ".chunk" + to_string(range.chunk_index);
+    int fd = open(dst.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd == -1) {
+      show_file_error("open", dst.c_str(), NULL);
+    }
+    close(fd);
+  }
+
+  // one thread per range
+  vector<thread> readers;
+  for (auto &range : ranges) {
+    if (range.length == 0) {
+      continue;
+    }
+    readers.push_back(thread([this, &name, &range]() {
+      string dst = tmpdir + '/' + name + ".chunk" + to_string(range.chunk_index);
+      int nodeid = coding->nodeid(range.chunk_index);
+      if ((*storages)[nodeid]->get_chunk_range(dst, name, range.chunk_index,
+                                               range.offset, range.length) == -1) {
+        print_error(stringstream() << "Failed to download " << name << " ["
+                                   << range.chunk_index << "] bytes " << range.offset << "-"
+                                   << range.offset+range.length-1 << " from node "
+                                   << nodeid << endl);
+        exit(-1);
+      }
+    }));
+  }
+  for (auto &t : readers) {
+    t.join();
+  }
+}
+
+
+void Job::download_chunk_buffers(void)
+{
+  // decoders copy a full chunk out of every buffer, so a chunk whose size is
+  // not the one in the metadata (e.g., truncated in the repository) is refused;
+  // the download then starts over on nodes other than the ones that failed
+  vector<char *> &buffers = next_job->chunk_buffers;
+  size_t chunksize = coding->chunk_size(tmpdir, filename);
+  vector<int> failed_nodes;
+  for (unsigned int i=0; i<chunk_indices.size(); ) {
+    int chunk_index = chunk_indices[i];
+    int nodeid = coding->nodeid(chunk_index);
+    char *data = NULL;
+    size_t size = 0;
+    int ret = (*storages)[nodeid]->get_buffer(filename, chunk_index, data, size);
+    if (ret == 0 && size == chunksize) {
+      buffers.push_back(data);
+      ++i;
+      continue;
+    }
+    if (ret == 0) {
+      print_error(stringstream() << "WARNING: chunk size mismatch in " << filename << " ["
+                                 << chunk_index << "] from node " << nodeid << ": " << size
+                                 << " bytes, expected " << chunksize << endl);
+      BufferArena::instance()->release(data);
+    } else {
+      print_error(stringstream() << "WARNING: failed to download " << filename << " ["
+                                 << chunk_index << "] from node " << nodeid << endl);
+    }
+    for (auto buffer : buffers) {
+      BufferArena::instance()->release(buffer);
+    }
+    buffers.clear();
+
+    // choose the chunks again among the nodes that have not failed
+    failed_nodes.push_back(nodeid);
+    vector<int> other_nodes;
+    for (int j=0; j<coding->getn(); ++j) {
+      if (find(failed_nodes.begin(), failed_nodes.end(), j) == failed_nodes.end()) {
+        other_nodes.push_back(j);
+      }
+    }
+    if (coding->decode_nodes(other_nodes, node_indices) == -1) {
+      print_error(stringstream() << "Failed to download " << filename
+                                 << " from enough nodes" << endl);
+      exit(-1);
+    }
+    chunk_indices.clear();
+    for (auto node : node_indices) {
+      vector<int> node_chunk_indices;
+      coding->chunks_on_node(node, node_chunk_indices);
+      chunk_indices.insert(chunk_indices.end(),
+                           node_chunk_indices.begin(), node_chunk_indices.end());
+    }
+    next_job->chunk_indices = chunk_indices;
+    i = 0;
+  }
+}
+
+
 void Job::download_metadata(void)
 {
   // download metadata from the first node
@@ -245,16 +635,223 @@ void Job::download_metadata(void)
                                << " from node " << node_indices[0] << endl);
     exit(-1);
   }
+
+  // a file split into segments is downloaded and decoded segment by segment
+  vector<MetadataStripe> segments;
+  if (next_job != NULL && next_job->action == DLCHUNKS &&
+      coding->read_segments(tmpdir, filename, segments) > 0) {
+    Job *job = new Job(DECODESEGS, coding, storages, tmpdir, filename);
+    job->node_indices = next_job->node_indices;
+    job->chunk_indices = next_job->chunk_indices;
+    delete next_job->next_job;
+    delete next_job;
+    next_job = job;
+  }
 }
 
 
 void Job::decode_file(void)
 {
   string dst = tmpdir + '/' + filename;
-  if (coding->decode_file(dst, tmpdir, filename, chunk_indices) == -1) {
+  int ret = 0;
+  if (!chunk_buffers.empty()) {
+    ret = coding->decode_buffer(dst, tmpdir, filename, chunk_indices, chunk_buffers);
+    for (auto data : chunk_buffers) {
+      BufferArena::instance()->release(data);
+    }
+  } else {
+    ret = coding->decode_file(dst, tmpdir, filename, chunk_indices);
+  }
+  if (ret == -1) {
     print_error(stringstream() << "Failed to decode: " << filename << endl);
     exit(-1);
   }
+
+  // a file compressed as a whole before encoding is decompressed in place
+  MetadataStripe stripe;
+  if (coding->read_stripe(tmpdir, filename, stripe) == 0 &&
+      (stripe.flags & MetadataStripe::compression_mask) != 0) {
+    string packed = dst + ".packed";
+    if (rename(dst.c_str(), packed.c_str()) == -1) {
+      show_file_error("rename", dst.c_str(), NULL);
+    }
+    int fd = open(dst.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd == -1) {
+      show_file_error("open", dst.c_str(), NULL);
+    }
+    decompress_into(packed, stripe.flags & MetadataStripe::compression_mask, stripe.size,
+                    fd, dst, 0, stripe.size);
+    close(fd);
+    unlink(packed.c_str());
+  }
+}
+
+
+void Job::decode_segments(void)
+{
+  vector<MetadataStripe> segments;
+  coding->read_segments(tmpdir, filename, segments);
+  string dst = tmpdir + '/' + filename;
+  int fd = open(dst.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd == -1 || ftruncate(fd, segments.back().offset + segments.back().size) == -1) {
+    show_file_error("open", dst.c_str(), NULL);
+  }
+
+  // decoders take segments in order, each decoding one segment at a time in
+  // memory before copying it into place
+  atomic<unsigned int> next_segment(0);
+  vector<thread> decoders;
+  unsigned int num_threads = min((unsigned int)segments.size(),
+                                 max(1u, thread::hardware_concurrency()));
+  for (unsigned int t=0; t<num_threads; ++t) {
+    decoders.push_back(thread([this, fd, &dst, &segments, &next_segment]() {
+      for (unsigned int i; (i = next_segment++) < segments.size(); ) {
+        // a hole is left as it is in the truncated file, reading as zeros
+        if (segments[i].flags & MetadataStripe::hole) {
+          continue;
+        }
+        string segname = Coding::segment_name(filename, i);
+        Job download(DLMETA, coding, storages, tmpdir, segname);
+        Job decode(DECODE, coding, storages, tmpdir, segname);
+        download.node_indices = node_indices;
+        download.chunk_indices = chunk_indices;
+        decode.chunk_indices = chunk_indices;
+        download.next_job = &decode;
+        download.download_metadata();
+        download.download_chunk_buffers();
+        decode.decode_file();
+
+        string segdst = tmpdir + '/' + segname;
+        int type = segments[i].flags & MetadataStripe::compression_mask;
+        if (type != 0) {
+          decompress_into(segdst, type, segments[i].size, fd, dst,
+                          segments[i].offset, segments[i].size);
+        } else {
+          copy_into(segdst, fd, dst, segments[i].offset, segments[i].size);
+        }
+        unlink(segdst.c_str());
+      }
+    }));
+  }
+  for (auto &t : decoders) {
+    t.join();
+  }
+  close(fd);
+}
+
+
+void Job::decode_range(void)
+{
+  // assemble the range in a scratch file, moved into place once complete
+  string dst = tmpdir + '/' + filename;
+  string part = dst + ".part";
+  int fd = open(part.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd == -1) {
+    show_file_error("open", part.c_str(), NULL);
+  }
+
+  // a file split into segments is read from the segments the range overlaps,
+  // downloading the metadata of each of them first
+  vector<MetadataStripe> segments;
+  if (coding->read_segments(tmpdir, filename, segments) > 0) {
+    size_t part_size = 0;
+    for (unsigned int i=0; i<segments.size(); ++i) {
+      size_t begin = max(range_offset, (size_t)segments[i].offset);
+      size_t end = min(range_offset + range_length,
+                       (size_t)(segments[i].offset + segments[i].size));
+      if (begin >= end) {
+        continue;
+      }
+      part_size = end - range_offset;
+      if (segments[i].flags & MetadataStripe::hole) {
+        continue;
+      }
+      string segname = Coding::segment_name(filename, i);
+      Job download(DLMETA, coding, storages, tmpdir, segname);
+      download.node_indices = node_indices;
+      download.download_metadata();
+      int type = segments[i].flags & MetadataStripe::compression_mask;
+      if (type == 0) {
+        decode_part(segname, begin - segments[i].offset, end - begin,
+                    fd, part, begin - range_offset);
+        continue;
+      }
+
+      // a compressed segment can only be decompressed as a whole
+      decode_whole(segname);
+      string segdst = tmpdir + '/' + segname;
+      decompress_into(segdst, type, segments[i].size, fd, part,
+                      begin - range_offset, end - begin, begin - segments[i].offset);
+      unlink(segdst.c_str());
+    }
+
+    // holes are skipped, reading as zeros once the range is extended past them
+    if (ftruncate(fd, part_size) == -1) {
+      show_file_error("ftruncate", part.c_str(), NULL);
+    }
+  } else {
+    decode_part(filename, range_offset, range_length, fd, part, 0);
+  }
+  close(fd);
+
+  if (rename(part.c_str(), dst.c_str()) == -1) {
+    show_file_error("rename", part.c_str(), NULL);
+  }
+}
+
+
+void Job::decode_part(string &name, size_t offset, size_t length,
+                      int fd, string &dst, size_t dst_offset)
+{
+  // download and decode only the chunk ranges the byte range depends on,
+  // unless the file was compressed as a whole
+  string src = tmpdir + '/' + name;
+  vector<ChunkRange> ranges;
+  MetadataStripe stripe;
+  if (coding->read_stripe(tmpdir, name, stripe) == -1 &&
+      coding->range_reads(tmpdir, name, chunk_indices, offset, length, ranges) == 0) {
+    download_chunk_ranges(name, ranges);
+    string range_path = src + ".range";
+    if (coding->decode_range(range_path, tmpdir, name, chunk_indices, offset, length) == -1) {
+      print_error(stringstream() << "Failed to decode: " << name << endl);
+      exit(-1);
+    }
+    struct stat st;
+    if (stat(range_path.c_str(), &st) == -1) {
+      show_file_error("stat", range_path.c_str(), NULL);
+    }
+    copy_into(range_path, fd, dst, dst_offset, st.st_size);
+    unlink(range_path.c_str());
+    for (auto &range : ranges) {
+      unlink((src + ".chunk" + to_string(range.chunk_index)).c_str());
+    }
+    return;
+  }
+
+  // otherwise decode the whole file and keep the range
+  decode_whole(name);
+  struct stat st;
+  if (stat(src.c_str(), &st) == -1) {
+    show_file_error("stat", src.c_str(), NULL);
+  }
+  size_t size = st.st_size;
+  length = offset < size? min(length, size - offset) : 0;
+  copy_into(src, fd, dst, dst_offset, length, offset);
+}
+
+
+void Job::decode_whole(string &name)
+{
+  // download all chunks needed, then decode them to tmpdir/name
+  Job download(DLCHUNKS, coding, storages, tmpdir, name);
+  Job decode(DECODE, coding, storages, tmpdir, name);
+  download.node_indices = node_indices;
+  download.chunk_indices = chunk_indices;
+  download.in_memory = coding->buffered_io();
+  decode.chunk_indices = chunk_indices;
+  download.next_job = &decode;
+  download.download_chunks();
+  decode.decode_file();
 }
 
 
@@ -285,6 +882,21 @@ FileOp *FileOp::instance(void)
 }
 
 
+const size_t FileOp::default_compressed_segment_size;
+
+
+void FileOp::set_segment_size(size_t size)
+{
+  segment_size = size;
+}
+
+
+void FileOp::set_compression(Compression *compression)
+{
+  this->compression = compression;
+}
+
+
 void FileOp::wait(void)
 {
   // Wait until no one is working, which means there should be no more jobs
@@ -292,7 +904,7 @@ void FileOp::wait(void)
   while (num_working_threads != 0 || !storage_queue.empty() || !coding_queue.empty()) {
     no_working_threads.wait(lock);
   }
-  master_mutex.unlock();
+  lock.unlock();
 
   // NULL pointers indicate to waiting threads there will be no more jobs
   add_job(NULL, storage_queue, master_mutex, storage_queue_ready);
@@ -318,20 +930,55 @@ void FileOp::encode_file(string &path, Coding *coding,
     srcdir.assign(".");
   }
   string filename(path, sep+1);
-  if (coding->encode_file(tmpdir, srcdir, filename) == -1) {
+  string src = srcdir + '/' + filename;
+  MetadataStripe stripe = {0, 0, 0, 0, 0};
+  if ((segment_size > 0 || compression != NULL) && coding->buffered_io()) {
+    struct stat st;
+    if (stat(src.c_str(), &st) == -1) {
+      show_file_error("stat", src.c_str(), NULL);
+    }
+    size_t size = segment_size > 0? segment_size : default_compressed_segment_size;
+    if ((size_t)st.st_size > size) {
+      encode_segments(src, filename, st.st_size, coding, storages, tmpdir);
+      return;
+    }
+    stripe.size = st.st_size;
+  }
+  Job *job = new Job(Job::ULMETACHUNKS, coding, &storages, tmpdir, filename);
+  int ret = 0;
+
+  // a file no larger than a segment that compresses well is encoded from a
+  // compressed copy, as a segment would be, and its metadata says so
+  string packed = tmpdir + '/' + filename + ".packed";
+  size_t packed_size = 0;
+  if (compression != NULL && stripe.size > 0) {
+    packed_size = compress_segment(src, stripe, packed);
+  }
+  if (packed_size > 0) {
+    ret = coding->encode_segment(tmpdir, packed, 0, packed_size,
+                                 filename, job->chunk_buffer, job->chunksize);
+    unlink(packed.c_str());
+    if (ret != -1) {
+      stripe.chunksize = job->chunksize;
+      stripe.flags = compression->type();
+      coding->write_stripe(tmpdir, filename, stripe);
+    }
+  } else if (coding->buffered_io()) {
+    ret = coding->encode_buffer(tmpdir, srcdir, filename, job->chunk_buffer, job->chunksize);
+  } else {
+    ret = coding->encode_file(tmpdir, srcdir, filename);
+  }
+  if (ret == -1) {
     print_error(stringstream() << "Failed to encode: "
                                << srcdir << "/" << filename << endl);
     exit(-1);
   }
 
   // enqueue job: store_metadata_and_chunks()
-  Job *job = new Job(Job::ULMETACHUNKS, coding, &storages, tmpdir, filename);
-  for (int i=0, j=0; i<coding->getn(); ++i) {
-    job->node_indices.push_back(i);
-    for (int jj=0; jj<coding->chunks_per_node(); ++jj, ++j) {
-      job->chunk_indices.push_back(j);
-    }
+  if (coding->chunks_are_copies()) {
+    job->src_path = src;
   }
+  add_all_chunks(job, coding);
   add_job(job, storage_queue, master_mutex, storage_queue_ready);
 }
 
@@ -341,6 +988,152 @@ void FileOp::decode_file(string &filename, Coding *coding,
 {
   print(stringstream() << "Decoding: " << filename << endl);
 
+  // download chunks from the chosen healthy nodes
+  vector<int> nodes_to_retrieve, chunk_indices;
+  choose_chunks(coding, storages, nodes_to_retrieve, chunk_indices);
+
+  // create job 1: download_metadata()
+  // (first, as striped reads need the chunk size before downloading chunks)
+  Job *job1 = new Job(Job::DLMETA, coding, &storages, tmpdir, filename);
+  job1->node_indices.push_back(nodes_to_retrieve[0]);
+
+  // create job 2: download_chunks()
+  Job *job2 = new Job(Job::DLCHUNKS, coding, &storages, tmpdir, filename);
+  job2->chunk_indices = chunk_indices;
+  job2->node_indices = nodes_to_retrieve;
+  job2->in_memory = coding->buffered_io();
+
+  // create job 3: decode_file()
+  Job *job3 = new Job(Job::DECODE, coding, &storages, tmpdir, filename);
+  job3->chunk_indices = chunk_indices;
+
+  // chain the jobs and enqueue job 1 [download_metadata()]
+  job1->next_job = job2;
+  job2->next_job = job3;
+  add_job(job1, storage_queue, master_mutex, storage_queue_ready);
+}
+
+
+void FileOp::decode_range(string &filename, size_t offset, size_t length, Coding *coding,
+                          vector<Storage *> &storages, string &tmpdir)
+{
+  print(stringstream() << "Reading: " << filename << " bytes " << offset << "-"
+                       << offset+length-1 << endl);
+
+  // download from the same healthy nodes as a decode would
+  vector<int> nodes_to_retrieve, chunk_indices;
+  choose_chunks(coding, storages, nodes_to_retrieve, chunk_indices);
+
+  // create job 1: download_metadata()
+  Job *job1 = new Job(Job::DLMETA, coding, &storages, tmpdir, filename);
+  job1->node_indices.push_back(nodes_to_retrieve[0]);
+
+  // create job 2: decode_range(), which downloads what it needs itself
+  Job *job2 = new Job(Job::DECODERANGE, coding, &storages, tmpdir, filename);
+  job2->node_indices = nodes_to_retrieve;
+  job2->chunk_indices = chunk_indices;
+  job2->range_offset = offset;
+  job2->range_length = length;
+
+  // chain the jobs and enqueue job 1 [download_metadata()]
+  job1->next_job = job2;
+  add_job(job1, storage_queue, master_mutex, storage_queue_ready);
+}
+
+
+void FileOp::repair_file(string &filename, Coding *coding,
+                         vector<Storage *> &storages,
+                         vector<int> &chunks_to_retrieve,
+                         int faulty_node, string &tmpdir)
+{
+  print(stringstream() << "Repairing: " << filename << endl);
+
+  // a file split into segments is repaired segment by segment, downloading the
+  // metadata of each segment first, and its own metadata goes to the new node
+  vector<MetadataStripe> segments;
+  int num_segments = coding->read_segments(tmpdir, filename, segments);
+  if (num_segments > 0) {
+    for (int i=0; i<num_segments; ++i) {
+      if (segments[i].flags & MetadataStripe::hole) {
+        continue;
+      }
+      string segname = Coding::segment_name(filename, i);
+      Job *job = repair_jobs(segname, coding, storages, chunks_to_retrieve,
+                             faulty_node, tmpdir);
+      Job *meta_job = new Job(Job::DLMETA, coding, &storages, tmpdir, segname);
+      meta_job->node_indices.push_back(job->node_indices[0]);
+      meta_job->next_job = job;
+      add_job(meta_job, storage_queue, master_mutex, storage_queue_ready);
+    }
+    Job *job = new Job(Job::ULMETA, coding, &storages, tmpdir, filename);
+    job->node_indices.push_back(faulty_node);
+    add_job(job, storage_queue, master_mutex, storage_queue_ready);
+    return;
+  }
+
+  Job *job = repair_jobs(filename, coding, storages, chunks_to_retrieve, faulty_node, tmpdir);
+  add_job(job, storage_queue, master_mutex, storage_queue_ready);
+}
+
+
+void FileOp::delete_file(string &filename, Coding *coding,
+                         vector<Storage *> &storages, string &tmpdir)
+{
+  print(stringstream() << "Deleting: " << filename << endl);
+
+  // a file split into segments has its segments deleted along with it, and no
+  // chunks of its own
+  int n = coding->getn();
+  vector<string> filenames;
+  for (int i=0; i<n; ++i) {
+    if (storages[i]->check_health() == 0 && storages[i]->get_metadata(tmpdir, filename) == 0) {
+      vector<MetadataStripe> segments;
+      int num_segments = coding->read_segments(tmpdir, filename, segments);
+      for (int j=0; j<num_segments; ++j) {
+        if (!(segments[j].flags & MetadataStripe::hole)) {
+          filenames.push_back(Coding::segment_name(filename, j));
+        }
+      }
+      break;
+    }
+  }
+  int segmented = !filenames.empty();
+  filenames.push_back(filename);
+
+  for (auto &name : filenames) {
+    for (int i=0; i<n; ++i) {
+      vector<int> chunk_indices;
+      if (!segmented || name != filename) {
+        coding->chunks_on_node(i, chunk_indices);
+        coding->dummy_chunks_on_node(i, chunk_indices);
+      }
+      if (storages[i]->delete_metadata_and_chunks(name, chunk_indices) == -1) {
+        print_error(stringstream() << "Failed to delete " << name
+                                   << " from node " << i << endl);
+        exit(-1);
+      }
+    }
+  }
+}
+
+
+/*  -----------------  */
+/* | Private methods | */
+/*  -----------------  */
+FileOp::FileOp(): segment_size(0), compression(NULL)
+{
+  // spawn one master storage thread and one master coding thread
+  // TODO: consider spawning sub-threads within each of the master thread in the future
+  workers.push_back(thread(run_thread, ref(storage_queue),
+                           ref(master_mutex), ref(storage_queue_ready)));
+  workers.push_back(thread(run_thread, ref(coding_queue),
+                           ref(master_mutex), ref(coding_queue_ready)));
+}
+
+
+void FileOp::choose_chunks(Coding *coding, vector<Storage *> &storages,
+                           vector<int> &nodes_to_retrieve, vector<int> &chunk_indices)
+{
   // look for healthy nodes
   int n = coding->getn();
   vector<int> healthy_nodes;
@@ -352,52 +1145,140 @@ void FileOp::decode_file(string &filename, Coding *coding,
     }
   }
 
-  unsigned int k = (unsigned int)coding->getk();
-  if (healthy_nodes.size() < k) {
+  if (coding->decode_nodes(healthy_nodes, nodes_to_retrieve) == -1) {
     print_error(stringstream() << "Insufficient healthy nodes." << endl);
     exit(-1);
   }
 
-  // download chunks from the first k healthy node, and save their chunk indices
-  vector<int> chunk_indices;
-  for (unsigned int i=0; i<k; ++i) {
+  // save the chunk indices of the chosen nodes
+  for (auto node : nodes_to_retrieve) {
     vector<int> cur_chunk_indices;
-    coding->chunks_on_node(healthy_nodes[i], cur_chunk_indices);
+    coding->chunks_on_node(node, cur_chunk_indices);
     chunk_indices.insert(chunk_indices.end(),
                          cur_chunk_indices.begin(), cur_chunk_indices.end());
   }
+}
 
-  // create job 1: download_chunks()
-  Job *job1 = new Job(Job::DLCHUNKS, coding, &storages, tmpdir, filename);
-  job1->chunk_indices = chunk_indices;
-  for (unsigned int i=0; i<k; ++i) {
-    job1->node_indices.push_back(healthy_nodes[i]);
-  }
 
-  // create job 2: download_metadata()
-  Job *job2 = new Job(Job::DLMETA, coding, &storages, tmpdir, filename);
-  job2->node_indices.push_back(healthy_nodes[0]);
+void FileOp::encode_segments(string &src, string &filename, size_t filesize,
+                             Coding *coding, vector<Storage *> &storages, string &tmpdir)
+{
+  size_t size = segment_size > 0? segment_size : default_compressed_segment_size;
+  vector<MetadataStripe> segments((filesize + size - 1) / size);
+  for (unsigned int i=0; i<segments.size(); ++i) {
+    segments[i].offset = i * size;
+    segments[i].size = min(size, filesize - segments[i].offset);
+  }
 
-  // create job 3: decode_file()
-  Job *job3 = new Job(Job::DECODE, coding, &storages, tmpdir, filename);
-  job3->chunk_indices = chunk_indices;
+  // encoders take segments in order and hand their chunks to the storage
+  // thread, waiting while too many segments are not yet uploaded
+  atomic<unsigned int> next_segment(0);
+  vector<thread> encoders;
+  unsigned int num_threads = min((unsigned int)segments.size(),
+                                 max(1u, thread::hardware_concurrency()));
+  max_segments_in_flight = 2 * num_threads;
+  for (unsigned int t=0; t<num_threads; ++t) {
+    encoders.push_back(thread([&]() {
+      for (unsigned int i; (i = next_segment++) < segments.size(); ) {
+        // an all-zero segment is recorded as a hole and neither encoded nor
+        // stored, except the first, whose metadata repair takes its parameters from
+        if (i > 0 && segment_is_zero(src, segments[i])) {
+          segments[i].flags = MetadataStripe::hole;
+          continue;
+        }
+        acquire_segment_slot();
+        string segname = Coding::segment_name(filename, i);
+        Job *job = new Job(Job::ULMETACHUNKS, coding, &storages, tmpdir, segname);
+
+        // a segment that compresses well is encoded from a compressed copy
+        string packed = tmpdir + '/' + segname + ".packed";
+        size_t packed_size = 0;
+        if (compression != NULL) {
+          packed_size = compress_segment(src, segments[i], packed);
+        }
+        int ret;
+        if (packed_size > 0) {
+          segments[i].flags = compression->type();
+          ret = coding->encode_segment(tmpdir, packed, 0, packed_size,
+                                       segname, job->chunk_buffer, job->chunksize);
+          unlink(packed.c_str());
+        } else {
+          ret = coding->encode_segment(tmpdir, src, segments[i].offset, segments[i].size,
+                                       segname, job->chunk_buffer, job->chunksize);
+        }
+        if (ret == -1) {
+          print_error(stringstream() << "Failed to encode: " << src << " bytes "
+                                     << segments[i].offset << "-"
+                                     << segments[i].offset+segments[i].size-1 << endl);
+          exit(-1);
+        }
+        segments[i].chunksize = job->chunksize;
+        job->segment_slot = 1;
+        add_all_chunks(job, coding);
+        add_job(job, storage_queue, master_mutex, storage_queue_ready);
+      }
+    }));
+  }
+  for (auto &t : encoders) {
+    t.join();
+  }
 
-  // chain the jobs and enqueue job 1 [download_chunks()]
-  job1->next_job = job2;
-  job2->next_job = job3;
-  add_job(job1, storage_queue, master_mutex, storage_queue_ready);
+  // the metadata of the file itself lists its segments
+  coding->write_segments(tmpdir, filename, filesize, segments);
+  Job *job = new Job(Job::ULMETA, coding, &storages, tmpdir, filename);
+  for (int i=0; i<coding->getn(); ++i) {
+    job->node_indices.push_back(i);
+  }
+  add_job(job, storage_queue, master_mutex, storage_queue_ready);
 }
 
 
-void FileOp::repair_file(string &filename, Coding *coding,
-                         vector<Storage *> &storages,
-                         vector<int> &chunks_to_retrieve,
-                         int faulty_node, string &tmpdir)
+size_t FileOp::compress_segment(string &src, MetadataStripe &segment, string &dst)
 {
-  print(stringstream() << "Repairing: " << filename << endl);
+  int fd = open(src.c_str(), O_RDONLY);
+  if (fd == -1) {
+    show_file_error("open", src.c_str(), NULL);
+  }
+  char *data = BufferArena::instance()->acquire(segment.size);
+  for (size_t done = 0; done < segment.size; ) {
+    ssize_t ret = pread(fd, data + done, segment.size - done, segment.offset + done);
+    if (ret <= 0) {
+      show_file_error("pread", src.c_str(), NULL);
+    }
+    done += ret;
+  }
+  close(fd);
+
+  // keep the compressed segment only if it saves at least an eighth, judging
+  // from a sample first so that incompressible data is not compressed in full
+  char *packed = BufferArena::instance()->acquire(segment.size);
+  size_t sample = min((size_t)segment.size, compression_sample_size);
+  size_t packed_size = 0;
+  if (compression->compress(data, sample, packed, sample - sample/8) > 0) {
+    packed_size = compression->compress(data, segment.size, packed,
+                                        segment.size - segment.size/8);
+  }
+  if (packed_size > 0) {
+    fd = open(dst.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd == -1) {
+      show_file_error("open", dst.c_str(), NULL);
+    }
+    if (pwrite(fd, packed, packed_size, 0) != (ssize_t)packed_size) {
+      show_file_error("pwrite", dst.c_str(), NULL);
+    }
+    close(fd);
+  }
+  BufferArena::instance()->release(packed);
+  BufferArena::instance()->release(data);
+  return packed_size;
+}
 
+
+Job *FileOp::repair_jobs(string &filename, Coding *coding, vector<Storage *> &storages,
+                         vector<int> &chunks_to_retrieve, int faulty_node, string &tmpdir)
+{
   // create job 1: download_chunks()
-  // (metadata already downloaded during preprocess)
+  // (metadata already downloaded during preprocess, or by a job run before)
   Job *job1 = new Job(Job::DLCHUNKS, coding, &storages, tmpdir, filename);
   job1->chunk_indices = chunks_to_retrieve;
   bool *node_indices = new bool[coding->getn()]();
@@ -418,6 +1299,7 @@ void FileOp::repair_file(string &filename, Coding *coding,
   Job *job3 = new Job(Job::ULMETACHUNKS, coding, &storages, tmpdir, filename);
   job3->node_indices.push_back(faulty_node);
   coding->chunks_on_node(faulty_node, job3->chunk_indices);
+  coding->dummy_chunks_on_node(faulty_node, job3->dummy_chunk_indices);
 
   // create job 4: upload_metadata() for surviving nodes
   Job *job4 = new Job(Job::ULMETA, coding, &storages, tmpdir, filename);
@@ -432,42 +1314,11 @@ void FileOp::repair_file(string &filename, Coding *coding,
     }
   }
 
-  // chain the jobs and enqueue job 1 [download_chunks()]
+  // chain the jobs, starting with job 1 [download_chunks()]
   job1->next_job = job2;
   job2->next_job = job3;
   job3->next_job = job4;
-  add_job(job1, storage_queue, master_mutex, storage_queue_ready);
+  return job1;
 }
 
 
-void FileOp::delete_file(string &filename, Coding *coding,
-                         vector<Storage *> &storages)
-{
-  print(stringstream() << "Deleting: " << filename << endl);
-
-  int n = coding->getn();
-  for (int i=0; i<n; ++i) {
-    vector<int> chunk_indices;
-    coding->chunks_on_node(i, chunk_indices);
-    if (storages[i]->delete_metadata_and_chunks(filename, chunk_indices) == -1) {
-      print_error(stringstream() << "Failed to delete " << filename
-                                 << " from node " << i << endl);
-      exit(-1);
-    }
-  }
-}
-
-
-/*  -----------------  */
-/* | Private methods | */
-/*  -----------------  */
-FileOp::FileOp()
-{
-  // spawn one master storage thread and one master coding thread
-  // TODO: consider spawning sub-threads within each of the master thread in the future
-  workers.push_back(thread(run_thread, ref(storage_queue),
-                           ref(master_mutex), ref(storage_queue_ready)));
-  workers.push_back(thread(run_thread, ref(coding_queue),
-                           ref(master_mutex), ref(coding_queue_ready)));
-}
-
@@ -48,6 +48,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "coding.h"
 #include "common.h"
+#include "compression.h"
 #include "storage.h"
 
 
@@ -59,16 +60,24 @@ class Job
   void upload_metadata_and_chunks(void);
   void upload_metadata(void);
   void download_chunks(void);
+  void download_chunk_buffers(void);
   void download_metadata(void);
+  void download_striped_chunk(std::vector<size_t> &offsets, std::vector<size_t> &lengths);
+  void download_chunk_ranges(std::string &name, std::vector<ChunkRange> &ranges);
 
   /* Coding job routines. */
   void decode_file(void);
+  void decode_segments(void);
+  void decode_range(void);
+  void decode_part(std::string &name, size_t offset, size_t length,
+                   int fd, std::string &dst, size_t dst_offset);
+  void decode_whole(std::string &name);
   void repair_file(void);
 
 public:
   /** All types of jobs.  Storage jobs < DIVIDER; coding jobs > DIVIDER. */
   enum ACTIONS { ULMETACHUNKS, ULMETA, DLCHUNKS, DLMETA,
-                 DIVIDER, DECODE, REPAIR };
+                 DIVIDER, DECODE, DECODESEGS, DECODERANGE, REPAIR };
 
   int action;  /**< job to carry out (see enum ACTIONS) */
   Coding *coding;  /**< coding scheme used */
@@ -77,6 +86,15 @@ public:
   std::string filename;  /**< name of file to act on */
   std::vector<int> chunk_indices;  /**< indices of chunks involved in current job */
   std::vector<int> node_indices;   /**< indices of nodes involved in current job */
+  std::vector<int> dummy_chunk_indices;  /**< dummy chunks to generate and upload in current job */
+  std::string src_path;  /**< file uploaded as every chunk, if chunks are copies of it */
+  char *chunk_buffer;  /**< all chunks held in memory in index order (NULL for chunk files) */
+  size_t chunksize;    /**< size of each chunk in chunk_buffer */
+  int in_memory;       /**< whether chunks are downloaded to memory instead of tmpdir */
+  std::vector<char *> chunk_buffers;  /**< chunks downloaded to memory, following order in chunk_indices */
+  int segment_slot;    /**< whether the job holds one of the slots of segments in flight */
+  size_t range_offset;  /**< offset of the byte range of the file to decode */
+  size_t range_length;  /**< length of the byte range of the file to decode */
   Job *next_job;  /**< pointer to an object describing the next job (NULL for none) */
 
 
@@ -99,7 +117,20 @@ class FileOp
   /** Worker threads for processing storage/coding jobs. */
   std::vector<std::thread> workers;
 
+  /** Size of the segments that large files are split into (0 for no splitting). */
+  size_t segment_size;
+
+  /** Compression applied to each segment before encoding (NULL for none). */
+  Compression *compression;
+
   FileOp();
+  void choose_chunks(Coding *coding, std::vector<Storage *> &storages,
+                     std::vector<int> &nodes_to_retrieve, std::vector<int> &chunk_indices);
+  void encode_segments(std::string &src, std::string &filename, size_t filesize,
+                       Coding *coding, std::vector<Storage *> &storages, std::string &tmpdir);
+  size_t compress_segment(std::string &src, MetadataStripe &segment, std::string &dst);
+  Job *repair_jobs(std::string &filename, Coding *coding, std::vector<Storage *> &storages,
+                   std::vector<int> &chunks_to_retrieve, int faulty_node, std::string &tmpdir);
 
 public:
   /** Returns a singleton instance of FileOp. */
@@ -110,6 +141,26 @@ public:
   void wait(void);
 
 
+  /** Split files larger than size into segments of size bytes, encoded and
+   *  decoded in parallel and stored as files of their own.  Only coding schemes
+   *  that support encode_buffer() split files.
+   *  @param[in] size segment size, a multiple of the page size (0 for no splitting) */
+  void set_segment_size(size_t size);
+
+
+  /** Compress files before encoding, segment by segment for files larger than
+   *  a segment (of default_compressed_segment_size bytes if no segment size is
+   *  set) and as a whole for others.  Segments and files that do not compress
+   *  well are encoded as they are.
+   *  Only coding schemes that support encode_buffer() compress files.
+   *  @param[in] compression Compression instance to use (NULL for none) */
+  void set_compression(Compression *compression);
+
+
+  /** Segment size used for compressed files if no segment size is set. */
+  static const size_t default_compressed_segment_size = 16 << 20;
+
+
   /** Encode and upload a file.
    *  @param[in]     path local path of file to upload
    *  @param[in]   coding Coding instance describing the coding scheme used
@@ -128,6 +179,19 @@ public:
                    std::vector<Storage *> &storages, std::string &tmpdir);
 
 
+  /** Download and decode a byte range of a file, reading only the byte ranges
+   *  of the chunks it depends on where the coding scheme supports it.  The
+   *  range is written to the temporary directory under the name of the file.
+   *  @param[in] filename name of file to read
+   *  @param[in]   offset offset of the first byte to read
+   *  @param[in]   length number of bytes to read (clipped to the end of the file)
+   *  @param[in]   coding Coding instance describing the coding scheme used
+   *  @param[in] storages Storage instances describing the repositories
+   *  @param[in]   tmpdir path to temporary directory */
+  void decode_range(std::string &filename, size_t offset, size_t length, Coding *coding,
+                    std::vector<Storage *> &storages, std::string &tmpdir);
+
+
   /** Repair a file.
    *  @param[in]           filename name of file to repair
    *  @param[in]             coding Coding instance describing the coding scheme used
@@ -144,9 +208,10 @@ public:
   /** Delete a file.
    *  @param[in] filename name of file to delete
    *  @param[in]   coding Coding instance describing the coding scheme used
-   *  @param[in] storages Storage instances describing the repositories */
+   *  @param[in] storages Storage instances describing the repositories
+   *  @param[in]   tmpdir path to temporary directory */
   void delete_file(std::string &filename, Coding *coding,
-                   std::vector<Storage *> &storages);
+                   std::vector<Storage *> &storages, std::string &tmpdir);
 };
 
 #endif  /* NCCLOUD_FILEOP_H */
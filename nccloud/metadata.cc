@@ -0,0 +1,143 @@
+/**
+  * @file metadata.cc
+  * @brief Implements the Metadata class.
+  * **/
+
+/* ===================================================================
+Copyright (c) 2026, the NCCloud contributors
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+  - Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+  - Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in
+    the documentation and/or other materials provided with the
+    distribution.
+
+  - Neither the name of the copyright holder nor the
+    names of its contributors may be used to endorse or promote
+    products derived from this software without specific prior written
+    permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT
+HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+=================================================================== */
+
+
+#include <cstddef>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "common.h"
+#include "metadata.h"
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "the metadata format is little-endian"
+#endif
+
+static_assert(sizeof(MetadataHeader) == 64 && sizeof(MetadataStripe) == 32,
+              "metadata structs must match the on-disk layout");
+
+using namespace std;
+
+
+const char Metadata::magic[4] = {'N', 'C', 'C', 'M'};
+const uint16_t Metadata::version = 2;
+const uint64_t Metadata::unknown_filesize = ~(uint64_t)0;
+
+/** Version 1 headers end before key_nonce. */
+static const size_t v1_header_size = offsetof(MetadataHeader, key_nonce);
+
+
+Metadata::Metadata()
+{
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, magic, sizeof(magic));
+  header.version = version;
+}
+
+
+int Metadata::parse(const char *data, size_t size)
+{
+  // version 1 metadata is read as unencrypted, and saved as the current version
+  if (size < v1_header_size) {
+    return -1;
+  }
+  memset(&header, 0, sizeof(header));
+  memcpy(&header, data, v1_header_size);
+  if (memcmp(header.magic, magic, sizeof(magic)) != 0 ||
+      (header.version != 1 && header.version != version)) {
+    return -1;
+  }
+  size_t header_size = header.version == 1? v1_header_size : sizeof(header);
+  if (size < header_size) {
+    return -1;
+  }
+  memcpy(&header, data, header_size);
+  header.version = version;
+
+  // the tables follow the header back to back
+  size_t stripes_size = (size_t)header.num_stripes * sizeof(MetadataStripe);
+  size_t checksums_size = (size_t)header.num_checksums * sizeof(uint32_t);
+  if (size != header_size + stripes_size + checksums_size + header.payload_size) {
+    return -1;
+  }
+  const char *ptr = data + header_size;
+  stripes.resize(header.num_stripes);
+  if (stripes_size) {
+    memcpy(&stripes[0], ptr, stripes_size);
+  }
+  ptr += stripes_size;
+  checksums.resize(header.num_checksums);
+  if (checksums_size) {
+    memcpy(&checksums[0], ptr, checksums_size);
+  }
+  ptr += checksums_size;
+  payload.assign(ptr, header.payload_size);
+  return 0;
+}
+
+
+int Metadata::load(string &path, string &data)
+{
+  int fd = open(path.c_str(), O_RDONLY);
+  struct stat st;
+  if (fd == -1 || fstat(fd, &st) == -1) {
+    show_file_error("open", path.c_str(), NULL);
+  }
+  data.assign(st.st_size, 0);
+  if (pread(fd, &data[0], st.st_size, 0) != st.st_size) {
+    show_file_error("pread", path.c_str(), NULL);
+  }
+  close(fd);
+  return parse(data.data(), data.size());
+}
+
+
+void Metadata::store(string &path)
+{
+  header.num_stripes = stripes.size();
+  header.num_checksums = checksums.size();
+  header.payload_size = payload.size();
+  string data((char *)&header, sizeof(header));
+  data.append((char *)stripes.data(), stripes.size() * sizeof(MetadataStripe));
+  data.append((char *)checksums.data(), checksums.size() * sizeof(uint32_t));
+  data.append(payload);
+  write_file(path, (char *)data.data(), data.size());
+}
@@ -0,0 +1,138 @@
+/**
+  * @file metadata.h
+  * @brief Declares the Metadata class and the binary metadata format.
+  * **/
+
+/* ===================================================================
+Copyright (c) 2026, the NCCloud contributors
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+  - Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+  - Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in
+    the documentation and/or other materials provided with the
+    distribution.
+
+  - Neither the name of the copyright holder nor the
+    names of its contributors may be used to endorse or promote
+    products derived from this software without specific prior written
+    permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT
+HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+=================================================================== */
+
+
+#ifndef NCCLOUD_METADATA_H
+#define NCCLOUD_METADATA_H
+
+#include <cstddef>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+
+/** Fixed-size header at the start of every metadata file.  A metadata file is
+ *  the header, followed by header.num_stripes MetadataStripe entries,
+ *  header.num_checksums 32-bit checksums and header.payload_size bytes of
+ *  coding-specific payload (e.g., the encoding matrix), in that order.
+ *  Fields are little-endian and naturally aligned, so a mapped metadata file
+ *  can be read through these structs in place. */
+struct MetadataHeader
+{
+  char magic[4];           /**< Metadata::magic */
+  uint16_t version;        /**< format version (Metadata::version) */
+  uint16_t coding_type;    /**< coding type, as in the [Coding] type field */
+  uint32_t k, n, t, w;     /**< coding parameters */
+  uint64_t chunksize;      /**< size of a chunk */
+  uint64_t filesize;       /**< size of the original file (Metadata::unknown_filesize
+                                if converted from the legacy format) */
+  uint32_t hints;          /**< coding-specific repair hints */
+  uint32_t num_stripes;    /**< number of entries in the stripe table */
+  uint32_t num_checksums;  /**< number of chunk checksums (0 for none) */
+  uint32_t payload_size;   /**< size of the coding-specific payload */
+  uint64_t key_nonce;      /**< nonce the file key is derived from (0 if not encrypted);
+                                absent from version 1 */
+};
+
+
+/** Stripe table entry, for files encoded as more than one stripe. */
+struct MetadataStripe
+{
+  /** Bits of the flags of a segment (see Coding::write_segments()) holding the
+   *  type of compression applied to it before encoding (0 for none). */
+  static const uint32_t compression_mask = 0xff;
+
+  /** Flag of a segment that is all zeros, so that it has neither chunks nor
+   *  metadata of its own. */
+  static const uint32_t hole = 0x100;
+
+  /** Flag of the only stripe of a file that is not split into segments, which
+   *  its own chunks hold (see Coding::write_stripe()). */
+  static const uint32_t in_place = 0x200;
+
+  uint64_t offset;     /**< offset of the stripe in the original file */
+  uint64_t size;       /**< bytes of the original file in the stripe */
+  uint64_t chunksize;  /**< size of a chunk of the stripe */
+  uint32_t flags;      /**< coding-specific stripe flags */
+  uint32_t reserved;   /**< zero */
+};
+
+
+/** In-memory copy of a metadata file. */
+class Metadata
+{
+public:
+  static const char magic[4];      /**< "NCCM" */
+  static const uint16_t version;   /**< current format version */
+
+  /** File size of metadata converted from the legacy ASCII format, which does
+   *  not record it (see Coding::parse_legacy_metadata()). */
+  static const uint64_t unknown_filesize;
+
+  MetadataHeader header;
+  std::vector<MetadataStripe> stripes;
+  std::vector<uint32_t> checksums;  /**< per-chunk checksums, in chunk index order */
+  std::string payload;
+
+
+  /** Create metadata with an empty header (magic and version set). */
+  Metadata();
+
+
+  /** Parse metadata held in memory, e.g., a mapped metadata file.
+   *  @param[in] data start of the metadata
+   *  @param[in] size size of the metadata
+   *  @return 0 on success, -1 if data is not valid metadata */
+  int parse(const char *data, size_t size);
+
+
+  /** Read a metadata file with a single pread() and parse it.
+   *  @param[in]  path pathname of the metadata file
+   *  @param[out] data contents of the file, for metadata in the legacy format
+   *  @return 0 on success, -1 if the file is not valid metadata */
+  int load(std::string &path, std::string &data);
+
+
+  /** Serialize the metadata (updating the table sizes in the header) and
+   *  write it to a file.
+   *  @param[in] path pathname of the metadata file */
+  void store(std::string &path);
+};
+
+#endif  /* NCCLOUD_METADATA_H */
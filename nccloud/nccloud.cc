@@ -48,8 +48,10 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <string>
 #include <vector>
 
+#include "arena.h"
 #include "coding.h"
 #include "common.h"
+#include "compression.h"
 #include "config.h"
 #include "fileop.h"
 #include "storage.h"
@@ -59,8 +61,8 @@ using namespace std;
 
 void print_usage(char *prog)
 {
-  cout << "Usage: " << prog << " [config] [encode|decode|repair|delete]"
-                               " (repair node no.) files..." << endl;
+  cout << "Usage: " << prog << " [config] [encode|decode|repair|delete|read]"
+                               " (repair node no. | read offset length) files..." << endl;
   exit(1);
 }
 
@@ -72,8 +74,9 @@ int main(int argc, char **argv)
   int mode = !strncmp(argv[2], "encode", 7)? 0 :        /* 0 = encode */
             (!strncmp(argv[2], "decode", 7)? 1 :        /* 1 = decode */
             (!strncmp(argv[2], "repair", 7)? 2 :        /* 2 = repair */
-            (!strncmp(argv[2], "delete", 7)? 3 : 4)));  /* 3 = delete */
-  if (mode == 4 || (mode == 2 && argc < 5)) {
+            (!strncmp(argv[2], "delete", 7)? 3 :        /* 3 = delete */
+            (!strncmp(argv[2], "read", 5)? 4 : 5))));   /* 4 = read */
+  if (mode == 5 || (mode == 2 && argc < 5) || (mode == 4 && argc < 6)) {
     print_usage(argv[0]);
   }
 
@@ -97,6 +100,35 @@ int main(int argc, char **argv)
   int w = atoi(config.coding_param["w"].c_str());
   string tmpdir = config.coding_param["tmpdir"];
   Coding *coding = Coding::use_coding(coding_type, k, n, t, w);
+  if (coding->init(config.coding_param) == -1) {
+    exit(1);
+  }
+  if (config.coding_param.count("arena_idle_cap") == 1) {
+    BufferArena::instance()->set_idle_cap(strtoull(
+        config.coding_param["arena_idle_cap"].c_str(), NULL, 10) << 20);
+  }
+  if (config.coding_param.count("segment_size") == 1) {
+    FileOp::instance()->set_segment_size(strtoull(config.coding_param["segment_size"].c_str(),
+                                                  NULL, 10) << 20);
+  }
+  if (config.coding_param.count("compression") == 1 &&
+      atoi(config.coding_param["compression"].c_str()) != 0) {
+    int compression_type = atoi(config.coding_param["compression"].c_str());
+    Compression *compression = Compression::use_compression(compression_type);
+    if (compression == NULL) {
+      cerr << "[Coding] unknown compression type " << compression_type << "." << endl;
+      exit(1);
+    }
+    if (!coding->buffered_io()) {
+      cerr << "[Coding] compression is not supported by coding type "
+           << coding_type << "." << endl;
+      exit(1);
+    }
+    if (compression->init(config.coding_param) == -1) {
+      exit(1);
+    }
+    FileOp::instance()->set_compression(compression);
+  }
   cout << "Coding type: " << coding_type << endl;
 
   // init storages based on config
@@ -159,9 +191,20 @@ int main(int argc, char **argv)
     }
 
     // try generating parameters for repair
+    // (a file split into segments uses those of its first segment)
+    string preprocess_filename = filename;
+    vector<MetadataStripe> segments;
+    if (coding->read_segments(tmpdir, filename, segments) > 0) {
+      preprocess_filename = Coding::segment_name(filename, 0);
+      if (storages[healthy_nodes[0]]->get_metadata(tmpdir, preprocess_filename) == -1) {
+        cerr << "Failed to download metadata of " << preprocess_filename
+             << " from node " << healthy_nodes[0] << endl;
+        exit(-1);
+      }
+    }
     vector<int> erasures {faulty_node};
     vector<int> chunks_to_retrieve;
-    if (coding->repair_file_preprocess(tmpdir, filename, erasures,
+    if (coding->repair_file_preprocess(tmpdir, preprocess_filename, erasures,
                                        chunks_to_retrieve) == -1) {
       cerr << "Failed to repair." << endl;
       exit(-1);
@@ -194,11 +237,24 @@ int main(int argc, char **argv)
     // delete mode
     for (int i=3; i<argc; ++i) {
       string filename(argv[i]);
-      FileOp::instance()->delete_file(filename, coding, storages);
+      FileOp::instance()->delete_file(filename, coding, storages, tmpdir);
+    }
+  } else if (mode == 4) {
+    // read mode
+    size_t offset = strtoull(argv[3], NULL, 10);
+    size_t length = strtoull(argv[4], NULL, 10);
+    for (int i=5; i<argc; ++i) {
+      string filename(argv[i]);
+      FileOp::instance()->decode_range(filename, offset, length, coding, storages, tmpdir);
     }
   }
 
   FileOp::instance()->wait();
+  if (config.coding_param.count("arena_stats") == 1 &&
+      config.coding_param["arena_stats"] == "1") {
+    BufferArena::instance()->print_stats();
+  }
+  delete coding;
 
   return 0;
 }
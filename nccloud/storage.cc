@@ -39,6 +39,10 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 =================================================================== */
 
 
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "arena.h"
 #include "storage.h"
 #include "storages/local.h"
 #include "storages/swift.h"
@@ -56,3 +60,24 @@ Storage *Storage::use_storage(int type)
   }
 }
 
+
+int Storage::read_buffer(int fd, char* &data, size_t &size)
+{
+  struct stat st;
+  if (fstat(fd, &st) == -1) {
+    return -1;
+  }
+  size = st.st_size;
+  data = BufferArena::instance()->acquire(size);
+  size_t done = 0;
+  while (done < size) {
+    ssize_t ret = pread(fd, data + done, size - done, done);
+    if (ret <= 0) {
+      BufferArena::instance()->release(data);
+      data = NULL;
+      return -1;
+    }
+    done += ret;
+  }
+  return 0;
+}
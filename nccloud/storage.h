@@ -50,6 +50,14 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 /** Abstract base class for storage modules. */
 class Storage
 {
+protected:
+  /** Read a whole open file into a buffer from BufferArena.
+   *  @param[in]    fd descriptor of the file, read from offset 0
+   *  @param[out] data buffer holding the contents of the file
+   *  @param[out] size size of the file
+   *  @return 0 on success, -1 on failure */
+  int read_buffer(int fd, char* &data, size_t &size);
+
 public:
   /** Return an instance of a storage scheme, based on user's choice.
    *  @param[in] type choice of coding scheme (0 = FMSR code)
@@ -72,6 +80,23 @@ public:
                           int chunk_index) = 0;
 
 
+  /** Upload a local file as a chunk, without staging it under a chunk name first.
+   *  @param[in]         src path of local file holding the chunk's contents
+   *  @param[in]    filename name of file being encoded
+   *  @param[in] chunk_index chunk index of chunk to be stored
+   *  @return 0 on success, -1 on failure */
+  virtual int store_chunk_from(std::string &src, std::string &filename, int chunk_index) = 0;
+
+
+  /** Upload a chunk straight from memory, without a local chunk file.
+   *  @param[in]    filename name of file being encoded
+   *  @param[in] chunk_index chunk index of chunk to be stored
+   *  @param[in]        data contents of the chunk
+   *  @param[in]        size size of the chunk
+   *  @return 0 on success, -1 on failure */
+  virtual int put_buffer(std::string &filename, int chunk_index, char *data, size_t size) = 0;
+
+
   /** Batched version of store_chunk(). */
   virtual int store_chunks(std::string &srcdir, std::string &filename,
                            std::vector<int> &chunk_indices) = 0;
@@ -98,6 +123,26 @@ public:
                         int chunk_index) = 0;
 
 
+  /** Download a byte range of a chunk into the same range of a local file.
+   *  @param[in]         dst local file to write the range into (not truncated)
+   *  @param[in]    filename name of file being decoded
+   *  @param[in] chunk_index chunk index of chunk to be read
+   *  @param[in]      offset offset of the first byte to read
+   *  @param[in]      length number of bytes to read
+   *  @return 0 on success, -1 on failure */
+  virtual int get_chunk_range(std::string &dst, std::string &filename, int chunk_index,
+                              size_t offset, size_t length) = 0;
+
+
+  /** Download a chunk straight into memory, without a local chunk file.
+   *  @param[in]    filename name of file being decoded
+   *  @param[in] chunk_index chunk index of chunk to be retrieved
+   *  @param[out]       data chunk buffer from BufferArena (give it back with release())
+   *  @param[out]       size size of the chunk
+   *  @return 0 on success, -1 on failure */
+  virtual int get_buffer(std::string &filename, int chunk_index, char* &data, size_t &size) = 0;
+
+
   /** Batched version of get_chunk(). */
   virtual int get_chunks(std::string &dstdir, std::string &filename,
                          std::vector<int> &chunk_indices) = 0;
@@ -39,6 +39,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 =================================================================== */
 
 
+#include <algorithm>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
@@ -47,8 +48,10 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <string>
 
 #include <dirent.h>
+#include <fcntl.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <unistd.h>
 
 #include "../common.h"
 #include "local.h"
@@ -88,6 +91,22 @@ int LocalStorage::store_chunk(string &srcdir, string &filename, int chunk_index)
 }
 
 
+int LocalStorage::store_chunk_from(string &src, string &filename, int chunk_index)
+{
+  string chunk_path = repository_path + filename + ".chunk" + to_string(chunk_index);
+  copy(chunk_path, src);
+  return 0;
+}
+
+
+int LocalStorage::put_buffer(string &filename, int chunk_index, char *data, size_t size)
+{
+  string chunk_path = repository_path + filename + ".chunk" + to_string(chunk_index);
+  write_file(chunk_path, data, size);
+  return 0;
+}
+
+
 int LocalStorage::store_chunks(string &srcdir, string &filename,
                                vector<int> &chunk_indices)
 {
@@ -128,6 +147,59 @@ int LocalStorage::get_chunk(string &dstdir, string &filename, int chunk_index)
 }
 
 
+int LocalStorage::get_chunk_range(string &dst, string &filename, int chunk_index,
+                                  size_t offset, size_t length)
+{
+  string chunk_path = repository_path + filename + ".chunk" + to_string(chunk_index);
+  int infd = open(chunk_path.c_str(), O_RDONLY);
+  if (infd == -1) {
+    print_error(stringstream() << "[Storage:LocalStorage] cannot open " << chunk_path << endl);
+    return -1;
+  }
+  int outfd = open(dst.c_str(), O_WRONLY | O_CREAT, 0644);
+  if (outfd == -1) {
+    show_file_error("open", dst.c_str(), NULL);
+  }
+
+  // copy in-kernel where possible, falling back to pread() and pwrite()
+  loff_t in_off = offset, out_off = offset;
+  size_t remaining = length;
+  while (remaining > 0) {
+    ssize_t ret = copy_file_range(infd, &in_off, outfd, &out_off, remaining, 0);
+    if (ret <= 0) {
+      break;
+    }
+    remaining -= ret;
+  }
+  char buf[65536];
+  while (remaining > 0) {
+    ssize_t ret = pread(infd, buf, min(remaining, sizeof(buf)), in_off);
+    if (ret <= 0 || pwrite(outfd, buf, ret, out_off) != ret) {
+      break;
+    }
+    in_off += ret;
+    out_off += ret;
+    remaining -= ret;
+  }
+  close(infd);
+  close(outfd);
+  return remaining? -1 : 0;
+}
+
+
+int LocalStorage::get_buffer(string &filename, int chunk_index, char* &data, size_t &size)
+{
+  string chunk_path = repository_path + filename + ".chunk" + to_string(chunk_index);
+  int fd = open(chunk_path.c_str(), O_RDONLY);
+  if (fd == -1) {
+    return -1;
+  }
+  int ret = read_buffer(fd, data, size);
+  close(fd);
+  return ret;
+}
+
+
 int LocalStorage::get_chunks(string &dstdir, string &filename,
                              vector<int> &chunk_indices)
 {
@@ -236,7 +308,26 @@ int LocalStorage::check_health(void)
 /*  -----------------  */
 void LocalStorage::copy(string &dst, string &src)
 {
-  // copy file from src to dst
+  // copy file from src to dst in-kernel (which may share extents), if possible
+  int infd = open(src.c_str(), O_RDONLY);
+  int outfd = open(dst.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (infd != -1 && outfd != -1) {
+    ssize_t ret;
+    while ((ret = copy_file_range(infd, NULL, outfd, NULL, 1 << 30, 0)) > 0);
+    if (ret == 0) {
+      close(infd);
+      close(outfd);
+      return;
+    }
+  }
+  if (infd != -1) {
+    close(infd);
+  }
+  if (outfd != -1) {
+    close(outfd);
+  }
+
+  // fall back to a buffered copy
   FILE *infile = fopen(src.c_str(), "rb");
   if (infile == NULL) {
     show_file_error("fopen", src.c_str(), NULL);
@@ -60,6 +60,8 @@ public:
   int init(std::map<std::string,std::string> &storage_param);
 
   int store_chunk(std::string &srcdir, std::string &filename, int chunk_index);
+  int store_chunk_from(std::string &src, std::string &filename, int chunk_index);
+  int put_buffer(std::string &filename, int chunk_index, char *data, size_t size);
   int store_chunks(std::string &srcdir, std::string &filename,
                    std::vector<int> &chunk_indices);
   int store_metadata(std::string &srcdir, std::string &filename);
@@ -67,6 +69,9 @@ public:
                                 std::vector<int> &chunk_indices);
 
   int get_chunk(std::string &dstdir, std::string &filename, int chunk_index);
+  int get_buffer(std::string &filename, int chunk_index, char* &data, size_t &size);
+  int get_chunk_range(std::string &dst, std::string &filename, int chunk_index,
+                      size_t offset, size_t length);
   int get_chunks(std::string &dstdir, std::string &filename,
                  std::vector<int> &chunk_indices);
   int get_metadata(std::string &dstdir, std::string &filename);
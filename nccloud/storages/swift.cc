@@ -39,6 +39,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 =================================================================== */
 
 
+#include <algorithm>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
@@ -47,6 +48,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <map>
 #include <string>
 
+#include <fcntl.h>
+#include <sys/mman.h>
 #include <sys/types.h>
 #include <sys/wait.h>
 #include <unistd.h>
@@ -101,6 +104,40 @@ int SwiftStorage::store_chunk(string &srcdir, string &filename, int chunk_index)
 }
 
 
+int SwiftStorage::store_chunk_from(string &src, string &filename, int chunk_index)
+{
+  string action = "upload";
+  string object_name = filename + ".chunk" + to_string(chunk_index);
+  vector<string> args {src, "--object-name", object_name};
+  return run_cmd(action, args, cmd);
+}
+
+
+int SwiftStorage::put_buffer(string &filename, int chunk_index, char *data, size_t size)
+{
+  // hand the buffer to the swift CLI as an in-memory file the shell inherits
+  int fd = memfd_create("nccloud_chunk", 0);
+  if (fd == -1) {
+    return -1;
+  }
+  size_t written = 0;
+  while (written < size) {
+    ssize_t ret = write(fd, data + written, size - written);
+    if (ret <= 0) {
+      close(fd);
+      return -1;
+    }
+    written += ret;
+  }
+  string action = "upload";
+  string object_name = filename + ".chunk" + to_string(chunk_index);
+  vector<string> args {"/dev/fd/" + to_string(fd), "--object-name", object_name};
+  int ret = run_cmd(action, args, cmd);
+  close(fd);
+  return ret;
+}
+
+
 int SwiftStorage::store_chunks(string &srcdir, string &filename,
                                vector<int> &chunk_indices)
 {
@@ -150,6 +187,77 @@ int SwiftStorage::get_chunk(string &dstdir, string &filename, int chunk_index)
 }
 
 
+int SwiftStorage::get_chunk_range(string &dst, string &filename, int chunk_index,
+                                  size_t offset, size_t length)
+{
+  // ranged GET into a scratch file next to dst, then copy it into place
+  string action = "download";
+  string src = filename + ".chunk" + to_string(chunk_index);
+  string range_path = dst + ".range" + to_string(offset);
+  string range = "Range: bytes=" + to_string(offset) + "-" + to_string(offset+length-1);
+  vector<string> args {src, "-o", range_path, "-H", range};
+  if (length == 0) {
+    return 0;
+  }
+  if (run_cmd(action, args, cmd) == -1) {
+    return -1;
+  }
+
+  int infd = open(range_path.c_str(), O_RDONLY);
+  if (infd == -1) {
+    return -1;
+  }
+  int outfd = open(dst.c_str(), O_WRONLY | O_CREAT, 0644);
+  if (outfd == -1) {
+    show_file_error("open", dst.c_str(), NULL);
+  }
+
+  // copy in-kernel where possible, falling back to pread() and pwrite()
+  loff_t in_off = 0, out_off = offset;
+  size_t remaining = length;
+  while (remaining > 0) {
+    ssize_t ret = copy_file_range(infd, &in_off, outfd, &out_off, remaining, 0);
+    if (ret <= 0) {
+      break;
+    }
+    remaining -= ret;
+  }
+  char buf[65536];
+  while (remaining > 0) {
+    ssize_t ret = pread(infd, buf, min(remaining, sizeof(buf)), in_off);
+    if (ret <= 0 || pwrite(outfd, buf, ret, out_off) != ret) {
+      break;
+    }
+    in_off += ret;
+    out_off += ret;
+    remaining -= ret;
+  }
+  close(infd);
+  close(outfd);
+  unlink(range_path.c_str());
+  return remaining? -1 : 0;
+}
+
+
+int SwiftStorage::get_buffer(string &filename, int chunk_index, char* &data, size_t &size)
+{
+  // let the swift CLI write into an in-memory file the shell inherits
+  int fd = memfd_create("nccloud_chunk", 0);
+  if (fd == -1) {
+    return -1;
+  }
+  string action = "download";
+  string src = filename + ".chunk" + to_string(chunk_index);
+  vector<string> args {src, "-o", "/dev/fd/" + to_string(fd)};
+  int ret = run_cmd(action, args, cmd);
+  if (ret == 0) {
+    ret = read_buffer(fd, data, size);
+  }
+  close(fd);
+  return ret;
+}
+
+
 int SwiftStorage::get_chunks(string &dstdir, string &filename,
                              vector<int> &chunk_indices)
 {
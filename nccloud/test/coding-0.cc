@@ -0,0 +1,193 @@
+/**
+  * @file test/coding-0.cc
+  * @brief Tests encoding, decoding and repair with the CRS, LRC, Liberation
+  *        and Parity coding schemes.
+  * **/
+
+/* ===================================================================
+Copyright (c) 2026, the NCCloud contributors
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+  - Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+  - Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in
+    the documentation and/or other materials provided with the
+    distribution.
+
+  - Neither the name of the copyright holder nor the
+    names of its contributors may be used to endorse or promote
+    products derived from this software without specific prior written
+    permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT
+HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+=================================================================== */
+
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <sys/stat.h>
+
+#include "common.h"
+#include "../coding.h"
+
+using namespace std;
+
+
+struct TestCode
+{
+  const char *name;
+  int type, k, n, w;
+  const char *l;    // LRC local groups
+  int tolerated;    // erasures that can always be decoded
+};
+
+
+/** Make dir an empty directory holding the metadata and the given chunks of
+ *  an encoded file. */
+static void stage(string &dir, string &encdir, string &filename, vector<int> &chunk_indices)
+{
+  remove_test_dir(dir);
+  mkdir(dir.c_str(), 0755);
+  string src = encdir + '/' + filename + ".meta";
+  string dst = dir + '/' + filename + ".meta";
+  copy_file(src, dst);
+  for (auto index : chunk_indices) {
+    src = encdir + '/' + filename + ".chunk" + to_string(index);
+    dst = dir + '/' + filename + ".chunk" + to_string(index);
+    copy_file(src, dst);
+  }
+}
+
+
+int main()
+{
+  printf("[%s] Testing encoding, decoding and repair ...\n", __FILE__);
+
+  srand(0);  // fixes "random" number for testing
+
+  TestCode codes[] = {
+    {"CRS",        4, 4,  7, 8, NULL, 3},
+    {"LRC",        5, 6, 10, 8, "2",  3},
+    {"Liberation", 6, 4,  6, 7, NULL, 2},
+    {"Blaum-Roth", 7, 4,  6, 6, NULL, 2},
+    {"Liber8tion", 8, 4,  6, 8, NULL, 2},
+    {"Parity",     9, 3,  4, 8, NULL, 1},
+  };
+  size_t sizes[] = {0, 1, 4095, 100003, 1048577};
+
+  string dir = make_test_dir();
+  string encdir = dir + "/encoded";
+  string stagedir = dir + "/staged";
+  string filename("file");
+  string src = encdir + '/' + filename;
+  string dst = dir + "/decoded";
+
+  for (auto &code : codes) {
+    map<string, string> coding_param;
+    if (code.l != NULL) {
+      coding_param["l"] = code.l;
+    }
+    Coding *coding = Coding::use_coding(code.type, code.k, code.n, code.n, code.w);
+    if (coding->init(coding_param) == -1) {
+      printf("Failed! (cannot initialize %s)\n", code.name);
+      exit(-1);
+    }
+
+    for (size_t filesize : sizes) {
+      printf("\t %s k=%d n=%d size=%zu: ", code.name, code.k, code.n, filesize);
+      remove_test_dir(encdir);
+      mkdir(encdir.c_str(), 0755);
+      string data = random_data(filesize);
+      write_file(src, data.data(), data.size(), 0, O_TRUNC);
+      if (coding->encode_file(encdir, encdir, filename) == -1) {
+        printf("Failed! (encode failure)\n");
+        exit(-1);
+      }
+
+      // decode without every set of up to n-k nodes; a set within what the
+      // code tolerates must decode, and any set it picks nodes for must too
+      int decoded = 0;
+      for_each_subset(code.n, code.n - code.k, [&](vector<int> &failed) {
+        vector<int> healthy_nodes, nodes, chunk_indices;
+        for (int i=0; i<code.n; ++i) {
+          if (find(failed.begin(), failed.end(), i) == failed.end()) {
+            healthy_nodes.push_back(i);
+          }
+        }
+        if (coding->decode_nodes(healthy_nodes, nodes) == -1) {
+          if ((int)failed.size() <= code.tolerated) {
+            printf("Failed! (no nodes to decode from with %zu failed)\n", failed.size());
+            exit(-1);
+          }
+          return;
+        }
+        for (auto node : nodes) {
+          coding->chunks_on_node(node, chunk_indices);
+        }
+        stage(stagedir, encdir, filename, chunk_indices);
+        if (coding->decode_file(dst, stagedir, filename, chunk_indices) == -1 ||
+            read_file(dst) != data) {
+          printf("Failed! (wrong file decoded with nodes");
+          for (auto node : failed) {
+            printf(" %d", node);
+          }
+          printf(" failed)\n");
+          exit(-1);
+        }
+        ++decoded;
+      });
+
+      // repair every node from the chunks it asks for
+      for (int node=0; node<code.n; ++node) {
+        vector<int> erasures {node}, chunks_to_retrieve, lost;
+        stage(stagedir, encdir, filename, lost);
+        if (coding->repair_file_preprocess(stagedir, filename, erasures, chunks_to_retrieve) == -1) {
+          printf("Failed! (cannot repair node %d)\n", node);
+          exit(-1);
+        }
+        stage(stagedir, encdir, filename, chunks_to_retrieve);
+        if (coding->repair_file(stagedir, stagedir, filename) == -1) {
+          printf("Failed! (repair failure of node %d)\n", node);
+          exit(-1);
+        }
+        coding->chunks_on_node(node, lost);
+        for (auto index : lost) {
+          string chunk = filename + ".chunk" + to_string(index);
+          string original = encdir + '/' + chunk, repaired = stagedir + '/' + chunk;
+          if (read_file(original) != read_file(repaired)) {
+            printf("Failed! (wrong chunk %d repaired)\n", index);
+            exit(-1);
+          }
+        }
+      }
+      printf("OK! (%d decodes)\n", decoded);
+    }
+    delete coding;
+  }
+
+  remove_test_dir(stagedir);
+  remove_test_dir(encdir);
+  remove_test_dir(dir);
+  return 0;
+}
@@ -0,0 +1,208 @@
+/**
+  * @file test/coding-1.cc
+  * @brief Tests ranged decoding and encryption at rest with the FMSR, RS and
+  *        OFMSR coding schemes.
+  * **/
+
+/* ===================================================================
+Copyright (c) 2026, the NCCloud contributors
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+  - Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+  - Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in
+    the documentation and/or other materials provided with the
+    distribution.
+
+  - Neither the name of the copyright holder nor the
+    names of its contributors may be used to endorse or promote
+    products derived from this software without specific prior written
+    permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT
+HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+=================================================================== */
+
+
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <sys/stat.h>
+
+#include "common.h"
+#include "../coding.h"
+
+using namespace std;
+
+
+struct TestCode
+{
+  const char *name;
+  int type, k, n;
+};
+
+
+/** Make dir an empty directory holding the metadata of an encoded file and,
+ *  for each chunk range, a sparse chunk file holding just that range. */
+static void stage_ranges(string &dir, string &encdir, string &filename,
+                         vector<ChunkRange> &ranges)
+{
+  remove_test_dir(dir);
+  mkdir(dir.c_str(), 0755);
+  string src = encdir + '/' + filename + ".meta";
+  string dst = dir + '/' + filename + ".meta";
+  copy_file(src, dst);
+  for (auto &range : ranges) {
+    src = encdir + '/' + filename + ".chunk" + to_string(range.chunk_index);
+    dst = dir + '/' + filename + ".chunk" + to_string(range.chunk_index);
+    string chunk = read_file(src);
+    if (range.offset + range.length > chunk.size()) {
+      printf("Failed! (range past the end of chunk %d)\n", range.chunk_index);
+      exit(-1);
+    }
+    write_file(dst, chunk.data() + range.offset, range.length, range.offset, 0);
+  }
+}
+
+
+int main()
+{
+  printf("[%s] Testing ranged decoding and encryption ...\n", __FILE__);
+
+  srand(0);  // fixes "random" number for testing
+
+  TestCode codes[] = {
+    {"FMSR",  0, 2, 4},
+    {"RS",    1, 4, 6},
+    {"OFMSR", 3, 2, 4},
+  };
+  size_t sizes[] = {1, 4095, 100003, 1048577};
+
+  string dir = make_test_dir();
+  string encdir = dir + "/encoded";
+  string stagedir = dir + "/staged";
+  string filename("file");
+  string src = encdir + '/' + filename;
+  string dst = dir + "/decoded";
+  string keyfile = dir + "/key";
+  string key = random_data(32);
+  write_file(keyfile, key.data(), key.size(), 0, O_TRUNC);
+
+  for (auto &code : codes) {
+    for (int encrypted=0; encrypted<2; ++encrypted) {
+      map<string, string> coding_param;
+      if (encrypted) {
+        coding_param["encrypt_keyfile"] = keyfile;
+      }
+      Coding *coding = Coding::use_coding(code.type, code.k, code.n, code.n, 8);
+      if (coding->init(coding_param) == -1) {
+        printf("Failed! (cannot initialize %s)\n", code.name);
+        exit(-1);
+      }
+
+      for (size_t filesize : sizes) {
+        printf("\t %s k=%d n=%d size=%zu%s: ", code.name, code.k, code.n, filesize,
+               encrypted? " encrypted" : "");
+        remove_test_dir(encdir);
+        mkdir(encdir.c_str(), 0755);
+        string data = random_data(filesize);
+        write_file(src, data.data(), data.size(), 0, O_TRUNC);
+        if (coding->encode_file(encdir, encdir, filename) == -1) {
+          printf("Failed! (encode failure)\n");
+          exit(-1);
+        }
+
+        // once encrypted, no chunk may hold the file in the clear
+        int num_chunks = code.n * coding->chunks_per_node();
+        if (encrypted && filesize >= 16) {
+          for (int i=0; i<num_chunks; ++i) {
+            string chunk_path = src + ".chunk" + to_string(i);
+            if (read_file(chunk_path).find(data.substr(0, 16)) != string::npos) {
+              printf("Failed! (chunk %d not encrypted)\n", i);
+              exit(-1);
+            }
+          }
+        }
+
+        // read ranges at the edges of the file and across chunks (clipped to
+        // the file), from the nodes left after each single node failure
+        size_t offsets[] = {0, 1, filesize/3, filesize/2, filesize-1};
+        size_t lengths[] = {1, 4097, filesize};
+        for (int failed=-1; failed<code.n; ++failed) {
+          vector<int> healthy_nodes, nodes, chunk_indices;
+          for (int i=0; i<code.n; ++i) {
+            if (i != failed) {
+              healthy_nodes.push_back(i);
+            }
+          }
+          if (coding->decode_nodes(healthy_nodes, nodes) == -1) {
+            printf("Failed! (no nodes to decode from with node %d failed)\n", failed);
+            exit(-1);
+          }
+          for (auto node : nodes) {
+            coding->chunks_on_node(node, chunk_indices);
+          }
+
+          for (size_t offset : offsets) {
+            for (size_t length : lengths) {
+              vector<ChunkRange> ranges;
+              stage_ranges(stagedir, encdir, filename, ranges);
+              if (coding->range_reads(stagedir, filename, chunk_indices, offset, length,
+                                      ranges) == -1) {
+                printf("Failed! (ranged decoding not supported)\n");
+                exit(-1);
+              }
+              stage_ranges(stagedir, encdir, filename, ranges);
+              if (coding->decode_range(dst, stagedir, filename, chunk_indices,
+                                       offset, length) == -1 ||
+                  read_file(dst) != data.substr(offset, length)) {
+                printf("Failed! (wrong range %zu+%zu decoded with node %d failed)\n",
+                       offset, length, failed);
+                exit(-1);
+              }
+            }
+          }
+
+          // and so does the whole file
+          vector<ChunkRange> ranges;
+          for (auto index : chunk_indices) {
+            string chunk_path = src + ".chunk" + to_string(index);
+            ranges.push_back((ChunkRange){index, 0, read_file(chunk_path).size()});
+          }
+          stage_ranges(stagedir, encdir, filename, ranges);
+          if (coding->decode_file(dst, stagedir, filename, chunk_indices) == -1 ||
+              read_file(dst) != data) {
+            printf("Failed! (wrong file decoded with node %d failed)\n", failed);
+            exit(-1);
+          }
+        }
+        printf("OK!\n");
+      }
+      delete coding;
+    }
+  }
+
+  unlink(keyfile.c_str());
+  remove_test_dir(stagedir);
+  remove_test_dir(encdir);
+  remove_test_dir(dir);
+  return 0;
+}
@@ -0,0 +1,152 @@
+/**
+  * @file test/common.h
+  * @brief Implements various convenience functions for test programs.
+  * **/
+
+/* ===================================================================
+Copyright (c) 2026, the NCCloud contributors
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+  - Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+  - Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in
+    the documentation and/or other materials provided with the
+    distribution.
+
+  - Neither the name of the copyright holder nor the
+    names of its contributors may be used to endorse or promote
+    products derived from this software without specific prior written
+    permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT
+HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+=================================================================== */
+
+
+#ifndef NCCLOUD_TEST_COMMON_H
+#define NCCLOUD_TEST_COMMON_H
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+/** Create a scratch directory under /tmp, exiting on failure. */
+std::string make_test_dir(void)
+{
+  char dir[] = "/tmp/nccloud-test-XXXXXX";
+  if (mkdtemp(dir) == NULL) {
+    printf("Failed! (cannot create %s)\n", dir);
+    exit(-1);
+  }
+  return std::string(dir);
+}
+
+
+/** Remove a scratch directory and the files in it. */
+void remove_test_dir(std::string &dir)
+{
+  DIR *d = opendir(dir.c_str());
+  if (d != NULL) {
+    struct dirent *entry;
+    while ((entry = readdir(d)) != NULL) {
+      std::string name(entry->d_name);
+      if (name != "." && name != "..") {
+        unlink((dir + '/' + name).c_str());
+      }
+    }
+    closedir(d);
+  }
+  rmdir(dir.c_str());
+}
+
+
+/** Write size bytes of a buffer to a file at a given offset. */
+void write_file(std::string &path, const char *data, size_t size, size_t offset, int flags)
+{
+  int fd = open(path.c_str(), O_WRONLY | O_CREAT | flags, 0644);
+  if (fd == -1 || pwrite(fd, data, size, offset) != (ssize_t)size) {
+    printf("Failed! (cannot write %s)\n", path.c_str());
+    exit(-1);
+  }
+  close(fd);
+}
+
+
+/** Read a whole file, exiting if it cannot be read. */
+std::string read_file(std::string &path)
+{
+  struct stat st;
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd == -1 || fstat(fd, &st) == -1) {
+    printf("Failed! (cannot read %s)\n", path.c_str());
+    exit(-1);
+  }
+  std::string data(st.st_size, 0);
+  if (st.st_size > 0 && pread(fd, &data[0], st.st_size, 0) != st.st_size) {
+    printf("Failed! (cannot read %s)\n", path.c_str());
+    exit(-1);
+  }
+  close(fd);
+  return data;
+}
+
+
+/** Copy a file to another name. */
+void copy_file(std::string &src, std::string &dst)
+{
+  std::string data = read_file(src);
+  write_file(dst, data.data(), data.size(), 0, O_TRUNC);
+}
+
+
+/** Return size "random" bytes. */
+std::string random_data(size_t size)
+{
+  std::string data(size, 0);
+  for (size_t i=0; i<size; ++i) {
+    data[i] = (char)rand();
+  }
+  return data;
+}
+
+
+/** Call f with every subset of {0, ..., n-1} with at most max_size elements. */
+template <typename F>
+void for_each_subset(int n, int max_size, F f)
+{
+  for (unsigned int mask=0; mask < (1u << n); ++mask) {
+    std::vector<int> subset;
+    for (int i=0; i<n; ++i) {
+      if (mask & (1u << i)) {
+        subset.push_back(i);
+      }
+    }
+    if ((int)subset.size() <= max_size) {
+      f(subset);
+    }
+  }
+}
+
+#endif  /* NCCLOUD_TEST_COMMON_H */
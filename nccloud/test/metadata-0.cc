@@ -0,0 +1,242 @@
+/**
+  * @file test/metadata-0.cc
+  * @brief Tests reading and writing metadata.
+  * **/
+
+/* ===================================================================
+Copyright (c) 2026, the NCCloud contributors
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+  - Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+  - Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in
+    the documentation and/or other materials provided with the
+    distribution.
+
+  - Neither the name of the copyright holder nor the
+    names of its contributors may be used to endorse or promote
+    products derived from this software without specific prior written
+    permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT
+HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+=================================================================== */
+
+
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "common.h"
+#include "../coding.h"
+#include "../metadata.h"
+
+using namespace std;
+
+
+/** Compare two metadata, except the version, which is always the current one. */
+static bool same_metadata(Metadata &a, Metadata &b)
+{
+  return memcmp(a.header.magic, b.header.magic, sizeof(a.header.magic)) == 0 &&
+         a.header.coding_type == b.header.coding_type &&
+         a.header.k == b.header.k && a.header.n == b.header.n &&
+         a.header.t == b.header.t && a.header.w == b.header.w &&
+         a.header.chunksize == b.header.chunksize &&
+         a.header.filesize == b.header.filesize &&
+         a.header.hints == b.header.hints &&
+         a.header.key_nonce == b.header.key_nonce &&
+         a.stripes.size() == b.stripes.size() &&
+         (a.stripes.empty() ||
+          memcmp(&a.stripes[0], &b.stripes[0], a.stripes.size() * sizeof(MetadataStripe)) == 0) &&
+         a.checksums == b.checksums && a.payload == b.payload;
+}
+
+
+/** Encode a file, replace its metadata with the given legacy metadata, and
+ *  check that it still decodes and that the metadata is rewritten in the
+ *  binary format, with the size of the original file unknown. */
+static void check_legacy(string &dir, Coding *coding, string legacy(Metadata &meta))
+{
+  string filename("legacy");
+  string src = dir + '/' + filename;
+  string meta_path = src + ".meta";
+  string dst = dir + "/decoded";
+  string data = random_data(100003);
+  write_file(src, data.data(), data.size(), 0, O_TRUNC);
+  if (coding->encode_file(dir, dir, filename) == -1) {
+    printf("Failed! (encode failure)\n");
+    exit(-1);
+  }
+
+  Metadata meta;
+  string raw;
+  if (meta.load(meta_path, raw) == -1) {
+    printf("Failed! (cannot load metadata)\n");
+    exit(-1);
+  }
+  string old = legacy(meta);
+  write_file(meta_path, old.data(), old.size(), 0, O_TRUNC);
+
+  vector<int> healthy_nodes, nodes, chunk_indices;
+  for (int i=0; i<coding->getn(); ++i) {
+    healthy_nodes.push_back(i);
+  }
+  coding->decode_nodes(healthy_nodes, nodes);
+  for (auto node : nodes) {
+    coding->chunks_on_node(node, chunk_indices);
+  }
+  if (coding->decode_file(dst, dir, filename, chunk_indices) == -1 || read_file(dst) != data) {
+    printf("Failed! (legacy metadata does not decode)\n");
+    exit(-1);
+  }
+  Metadata converted;
+  if (converted.load(meta_path, raw) == -1 ||
+      converted.header.chunksize != meta.header.chunksize ||
+      converted.header.filesize != Metadata::unknown_filesize) {
+    printf("Failed! (legacy metadata not rewritten)\n");
+    exit(-1);
+  }
+}
+
+
+static string rs_legacy(Metadata &meta)
+{
+  return to_string(meta.header.chunksize);
+}
+
+
+static string fmsr_legacy(Metadata &meta)
+{
+  // encoding matrix, chunk size, then no repair hints
+  return meta.payload + to_string(meta.header.chunksize) + "0000";
+}
+
+
+int main()
+{
+  printf("[%s] Testing metadata ...\n", __FILE__);
+
+  srand(0);  // fixes "random" number for testing
+
+  string dir = make_test_dir();
+  string path = dir + "/file.meta";
+  string raw;
+
+  // round trip of every field
+  printf("\t round trip: ");
+  Metadata meta;
+  meta.header.coding_type = 1;
+  meta.header.k = 3;
+  meta.header.n = 5;
+  meta.header.t = 6;
+  meta.header.w = 8;
+  meta.header.chunksize = 12345;
+  meta.header.filesize = 98765;
+  meta.header.hints = 0x0102;
+  meta.header.key_nonce = 0x0123456789abcdefULL;
+  meta.stripes.push_back({0, 60000, 20000, 1, 0});
+  meta.stripes.push_back({60000, 38765, 12345, MetadataStripe::hole, 0});
+  meta.checksums = {1, 2, 3};
+  meta.payload.assign("pay\0load", 8);
+  meta.store(path);
+  Metadata loaded;
+  if (loaded.load(path, raw) == -1 || !same_metadata(meta, loaded) ||
+      loaded.header.version != Metadata::version) {
+    printf("Failed! (metadata changed)\n");
+    exit(-1);
+  }
+  printf("OK!\n");
+
+  // anything but the exact file is rejected
+  printf("\t truncated or extended: ");
+  for (size_t size=0; size<raw.size(); ++size) {
+    if (loaded.parse(raw.data(), size) != -1) {
+      printf("Failed! (accepted %zu of %zu bytes)\n", size, raw.size());
+      exit(-1);
+    }
+  }
+  string extended = raw + 'x';
+  if (loaded.parse(extended.data(), extended.size()) != -1) {
+    printf("Failed! (accepted a trailing byte)\n");
+    exit(-1);
+  }
+  printf("OK!\n");
+
+  printf("\t bad magic or version: ");
+  for (size_t i=0; i<sizeof(meta.header.magic); ++i) {
+    string bad = raw;
+    bad[i] ^= 0x20;
+    if (loaded.parse(bad.data(), bad.size()) != -1) {
+      printf("Failed! (accepted bad magic)\n");
+      exit(-1);
+    }
+  }
+  uint16_t versions[] = {0, 3, 0xffff};
+  for (uint16_t version : versions) {
+    string bad = raw;
+    memcpy(&bad[offsetof(MetadataHeader, version)], &version, sizeof(version));
+    if (loaded.parse(bad.data(), bad.size()) != -1) {
+      printf("Failed! (accepted version %u)\n", version);
+      exit(-1);
+    }
+  }
+  printf("OK!\n");
+
+  // version 1 headers end before the key nonce
+  printf("\t version 1: ");
+  size_t v1_header_size = offsetof(MetadataHeader, key_nonce);
+  string v1 = raw.substr(0, v1_header_size) + raw.substr(sizeof(MetadataHeader));
+  uint16_t version = 1;
+  memcpy(&v1[offsetof(MetadataHeader, version)], &version, sizeof(version));
+  meta.header.key_nonce = 0;
+  if (loaded.parse(v1.data(), v1.size()) == -1 || !same_metadata(meta, loaded) ||
+      loaded.header.version != Metadata::version) {
+    printf("Failed! (version 1 not read)\n");
+    exit(-1);
+  }
+  for (size_t size=0; size<v1.size(); ++size) {
+    if (loaded.parse(v1.data(), size) != -1) {
+      printf("Failed! (accepted %zu of %zu bytes of version 1)\n", size, v1.size());
+      exit(-1);
+    }
+  }
+  printf("OK!\n");
+
+  // metadata written before the binary format
+  map<string, string> coding_param;
+  printf("\t legacy RS: ");
+  Coding *coding = Coding::use_coding(1, 3, 5, 0, 8);
+  coding->init(coding_param);
+  check_legacy(dir, coding, rs_legacy);
+  delete coding;
+  printf("OK!\n");
+
+  printf("\t legacy FMSR: ");
+  coding = Coding::use_coding(0, 2, 4, 0, 8);
+  coding->init(coding_param);
+  check_legacy(dir, coding, fmsr_legacy);
+  delete coding;
+  printf("OK!\n");
+
+  remove_test_dir(dir);
+  return 0;
+}
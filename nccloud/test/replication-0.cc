@@ -0,0 +1,149 @@
+/**
+  * @file test/replication-0.cc
+  * @brief Tests the striped reads of the Replication class.
+  * **/
+
+/* ===================================================================
+Copyright (c) 2026, the NCCloud contributors
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+  - Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+  - Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in
+    the documentation and/or other materials provided with the
+    distribution.
+
+  - Neither the name of the copyright holder nor the
+    names of its contributors may be used to endorse or promote
+    products derived from this software without specific prior written
+    permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT
+HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+=================================================================== */
+
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "common.h"
+#include "../coding.h"
+
+using namespace std;
+
+#define NUM_NODES 4
+
+
+int main()
+{
+  printf("[%s] Testing striped reads of replicated files ...\n", __FILE__);
+
+  srand(0);  // fixes "random" number for testing
+
+  char dir[] = "/tmp/nccloud-test-XXXXXX";
+  if (mkdtemp(dir) == NULL) {
+    printf("Failed! (cannot create %s)\n", dir);
+    exit(-1);
+  }
+  string srcdir(dir), filename("file");
+  string src = srcdir + '/' + filename;
+  string chunk = src + ".chunk0";
+  string dst = srcdir + "/decoded";
+
+  // sizes around the page size and the range size, most not page-aligned
+  size_t sizes[] = {1, 4095, 4097, 1048575, 1048577, 3145728, 3145730, 5000001};
+  map<string, string> coding_param;
+  Coding *coding = Coding::use_coding(2, 2, NUM_NODES, 0, 8);
+  coding->init(coding_param);
+
+  for (size_t filesize : sizes) {
+    printf("\t size=%zu: ", filesize);
+    char *data = new char[filesize];
+    for (size_t i=0; i<filesize; ++i) {
+      data[i] = (char)rand();
+    }
+    write_file(src, data, filesize, 0, O_TRUNC);
+    if (coding->encode_file(srcdir, srcdir, filename) == -1) {
+      printf("Failed! (encode failure)\n");
+      exit(-1);
+    }
+
+    for (int num_nodes=1; num_nodes<=NUM_NODES; ++num_nodes) {
+      // the ranges must cover the file exactly, one after the other
+      vector<size_t> offsets, lengths;
+      if (coding->striped_read_ranges(srcdir, filename, num_nodes, offsets, lengths) == -1 ||
+          offsets.size() != (size_t)num_nodes || lengths.size() != (size_t)num_nodes) {
+        printf("Failed! (no ranges for %d nodes)\n", num_nodes);
+        exit(-1);
+      }
+      size_t end = 0;
+      for (int i=0; i<num_nodes; ++i) {
+        if (lengths[i] > 0 && offsets[i] != end) {
+          printf("Failed! (gap or overlap at %zu with %d nodes)\n", end, num_nodes);
+          exit(-1);
+        }
+        end += lengths[i];
+      }
+      if (end != filesize) {
+        printf("Failed! (ranges end at %zu with %d nodes)\n", end, num_nodes);
+        exit(-1);
+      }
+
+      // assemble the chunk from the ranges, as the striped download does, and decode it
+      unlink(chunk.c_str());
+      write_file(chunk, "", 0, 0, O_TRUNC);
+      for (int i=0; i<num_nodes; ++i) {
+        if (lengths[i] > 0) {
+          write_file(chunk, data + offsets[i], lengths[i], offsets[i], 0);
+        }
+      }
+      vector<int> chunk_indices {0};
+      if (coding->decode_file(dst, srcdir, filename, chunk_indices) == -1) {
+        printf("Failed! (decode failure with %d nodes)\n", num_nodes);
+        exit(-1);
+      }
+      char *decoded = new char[filesize];
+      int fd = open(dst.c_str(), O_RDONLY);
+      if (fd == -1 || pread(fd, decoded, filesize, 0) != (ssize_t)filesize ||
+          memcmp(data, decoded, filesize)) {
+        printf("Failed! (wrong file content with %d nodes)\n", num_nodes);
+        exit(-1);
+      }
+      close(fd);
+      delete[] decoded;
+    }
+    delete[] data;
+    printf("OK!\n");
+  }
+
+  string meta = src + ".meta";
+  unlink(src.c_str());
+  unlink(meta.c_str());
+  unlink(chunk.c_str());
+  unlink(dst.c_str());
+  rmdir(dir);
+  delete coding;
+  return 0;
+}